@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * Hooks called around the hardware accesses of the mixer controls, for the checking tools.
+ *
+ * They are weak: a tool defines them in its executable, exported to the plugins, to measure what
+ * the accesses do by themselves. They are left undefined in production, where calling them is
+ * reduced to a test.
+ */
+extern "C" {
+void alsaAccessStarted() __attribute__((weak));
+void alsaAccessEnded() __attribute__((weak));
+}
+
+/** Calls the hooks, if any, for the lifetime of the object */
+class AlsaAccessHook
+{
+public:
+    AlsaAccessHook()
+    {
+        if (alsaAccessStarted != NULL) {
+
+            alsaAccessStarted();
+        }
+    }
+
+    ~AlsaAccessHook()
+    {
+        if (alsaAccessEnded != NULL) {
+
+            alsaAccessEnded();
+        }
+    }
+
+private:
+    AlsaAccessHook(const AlsaAccessHook &);
+    AlsaAccessHook &operator=(const AlsaAccessHook &);
+};
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "AlsaAccessTimer.hpp"
+#include <algorithm>
+#include <sstream>
+#include <string.h>
+#include <time.h>
+
+const size_t AlsaAccessTimer::_maxPhases;
+
+AlsaAccessTimer::AlsaAccessTimer(const char *const *phaseNames, size_t phaseCount,
+                                 uint32_t thresholdUs)
+    : _phaseNames(phaseNames), _phaseCount(std::min(phaseCount, _maxPhases)),
+      _thresholdNs(static_cast<uint64_t>(thresholdUs) * 1000), _start(0), _lap(0),
+      _ioctlCount(0), _isIoctlCounted(false)
+{
+    memset(_durations, 0, sizeof(_durations));
+}
+
+uint64_t AlsaAccessTimer::now()
+{
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return static_cast<uint64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+void AlsaAccessTimer::start()
+{
+    if (!isEnabled()) {
+
+        return;
+    }
+    memset(_durations, 0, sizeof(_durations));
+    _ioctlCount = 0;
+    _isIoctlCounted = false;
+    _start = _lap = now();
+}
+
+void AlsaAccessTimer::lap(size_t phase)
+{
+    if (!isEnabled()) {
+
+        return;
+    }
+    uint64_t time = now();
+
+    if (phase < _phaseCount) {
+
+        _durations[phase] += time - _lap;
+    }
+    _lap = time;
+}
+
+void AlsaAccessTimer::addIoctls(uint32_t count)
+{
+    _ioctlCount += count;
+    _isIoctlCounted = true;
+}
+
+bool AlsaAccessTimer::isSlow() const
+{
+    return isEnabled() && (_lap - _start > _thresholdNs);
+}
+
+std::string AlsaAccessTimer::getBreakdown() const
+{
+    std::ostringstream breakdown;
+
+    breakdown << (_lap - _start) / 1000 << "us (";
+
+    for (size_t phase = 0; phase < _phaseCount; phase++) {
+
+        breakdown << (phase ? ", " : "") << _phaseNames[phase] << " "
+                  << _durations[phase] / 1000 << "us";
+    }
+    breakdown << ")";
+
+    if (_isIoctlCounted) {
+
+        breakdown << ", " << _ioctlCount << " ioctls";
+    }
+    return breakdown.str();
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+/**
+ * Per-phase timing of a hardware access, to report the accesses slower than a threshold.
+ *
+ * Phases are timed with the monotonic clock, each lap closing the current phase. Timing does not
+ * allocate: only the breakdown of a slow access does. A timer without threshold does nothing.
+ */
+class AlsaAccessTimer
+{
+public:
+    /**
+     * AlsaAccessTimer Class constructor
+     *
+     * @param[in] phaseNames names of the phases, static strings
+     * @param[in] phaseCount number of phases, at most _maxPhases
+     * @param[in] thresholdUs duration over which an access is slow, in us, 0 to disable timing
+     */
+    AlsaAccessTimer(const char *const *phaseNames, size_t phaseCount, uint32_t thresholdUs);
+
+    /** @return true if accesses are timed */
+    bool isEnabled() const { return _thresholdNs != 0; }
+
+    /** Start timing an access, the first phase starting now */
+    void start();
+
+    /**
+     * End a phase, the next one starting now
+     * Phases may be skipped or repeated, their durations adding up.
+     *
+     * @param[in] phase index of the phase
+     */
+    void lap(size_t phase);
+
+    /**
+     * Account for the ioctls issued by the access
+     *
+     * @param[in] count number of ioctls
+     */
+    void addIoctls(uint32_t count);
+
+    /** @return true if the access took longer than the threshold */
+    bool isSlow() const;
+
+    /** @return the total duration and the duration of each phase, and the ioctl count if known */
+    std::string getBreakdown() const;
+
+    /** Maximum number of phases */
+    static const size_t _maxPhases = 8;
+
+private:
+    /** @return the monotonic time, in ns */
+    static uint64_t now();
+
+    const char *const *_phaseNames;
+    size_t _phaseCount;
+    uint64_t _thresholdNs;
+    /** Start of the access, and of the current phase */
+    uint64_t _start;
+    uint64_t _lap;
+    uint64_t _durations[_maxPhases];
+    uint32_t _ioctlCount;
+    /** False until ioctls are accounted for */
+    bool _isIoctlCounted;
+};
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "AlsaCardFingerprint.hpp"
+#include <sound/asound.h>
+#include <string.h>
+#include <errno.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+uint64_t AlsaCardFingerprint::hash(uint64_t hash, const void *data, size_t size)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+
+    for (size_t index = 0; index < size; index++) {
+
+        hash = (hash ^ bytes[index]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+bool AlsaCardFingerprint::compute(int32_t cardIndex, uint64_t &fingerprint, std::string &error)
+{
+    char devicePath[32];
+    snprintf(devicePath, sizeof(devicePath), "/dev/snd/controlC%d", cardIndex);
+
+    int fd = open(devicePath, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+
+        error = "Failed to open " + std::string(devicePath) + ": " + strerror(errno);
+        return false;
+    }
+    struct snd_ctl_card_info cardInfo;
+    struct snd_ctl_elem_list elementList;
+
+    memset(&cardInfo, 0, sizeof(cardInfo));
+    memset(&elementList, 0, sizeof(elementList));
+
+    // No room for identifiers: the list only reports the control count
+    if ((ioctl(fd, SNDRV_CTL_IOCTL_CARD_INFO, &cardInfo) < 0) ||
+        (ioctl(fd, SNDRV_CTL_IOCTL_ELEM_LIST, &elementList) < 0)) {
+
+        error = "Failed to get the layout of card " + std::to_string(cardIndex) + ": " +
+                strerror(errno);
+        close(fd);
+        return false;
+    }
+    close(fd);
+
+    uint64_t value = _hashBasis;
+
+    value = hash(value, cardInfo.id, sizeof(cardInfo.id));
+    value = hash(value, cardInfo.driver, sizeof(cardInfo.driver));
+    value = hash(value, cardInfo.name, sizeof(cardInfo.name));
+    value = hash(value, cardInfo.mixername, sizeof(cardInfo.mixername));
+    value = hash(value, cardInfo.components, sizeof(cardInfo.components));
+    value = hash(value, &elementList.count, sizeof(elementList.count));
+
+    fingerprint = value;
+
+    return true;
+}
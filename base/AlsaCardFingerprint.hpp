@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+/**
+ * Cheap fingerprint of the mixer layout of a card.
+ *
+ * It covers the card identification (id, driver, names, components) and its control count, and
+ * costs two ioctls on the control device: it tells whether state saved from the card still
+ * applies to it, without reading any control.
+ */
+class AlsaCardFingerprint
+{
+public:
+    /**
+     * Compute the fingerprint of a card
+     *
+     * @param[in] cardIndex the index of the card
+     * @param[out] fingerprint the fingerprint
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    static bool compute(int32_t cardIndex, uint64_t &fingerprint, std::string &error);
+
+    /** Initial value of a FNV-1a hash */
+    static const uint64_t _hashBasis = 0xcbf29ce484222325ULL;
+
+    /**
+     * Add data to a FNV-1a hash
+     *
+     * @param[in] hash the current hash
+     * @param[in] data the data to add
+     * @param[in] size size of the data
+     *
+     * @return the updated hash
+     */
+    static uint64_t hash(uint64_t hash, const void *data, size_t size);
+};
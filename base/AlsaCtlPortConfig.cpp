@@ -30,6 +30,7 @@
 #include "AlsaCtlPortConfig.hpp"
 #include "MappingContext.h"
 #include "AlsaMappingKeys.hpp"
+#include "AlsaTrafficLog.hpp"
 #include <string.h>
 #include <string>
 #include <assert.h>
@@ -40,6 +41,10 @@ using std::string;
 
 #define base AlsaSubsystemObject
 
+const char *const AlsaCtlPortConfig::_accessPhaseNames[NbAccessPhases] = {
+    "close", "open", "configure", "start"
+};
+
 AlsaCtlPortConfig::AlsaCtlPortConfig(const string &mappingValue,
                                      CInstanceConfigurableElement *instanceConfigurableElement,
                                      const CMappingContext &context,
@@ -50,7 +55,11 @@ AlsaCtlPortConfig::AlsaCtlPortConfig(const string &mappingValue,
            context,
            logger),
       _device(context.getItemAsInteger(AlsaCtlDevice)),
-      _portConfig(defaultPortConfig)
+      _isKeepAliveEnabled(context.iSet(AlsaKeepAlive)),
+      _portConfig(defaultPortConfig),
+      _accessTimer(_accessPhaseNames, NbAccessPhases,
+                   context.iSet(AlsaSlowAccessThreshold) ?
+                   context.getItemAsInteger(AlsaSlowAccessThreshold) : 0)
 {
 
 }
@@ -67,6 +76,33 @@ bool AlsaCtlPortConfig::sendToHW(string &error)
     PortConfig portConfig;
     blackboardRead(&portConfig, sizeof(portConfig));
 
+    AlsaTrafficRecorder *recorder = getTrafficRecorder();
+
+    if ((recorder == NULL) && !_accessTimer.isEnabled()) {
+
+        return applyPortConfig(portConfig, error);
+    }
+    uint64_t start = (recorder != NULL) ? AlsaTrafficRecorder::now() : 0;
+
+    _accessTimer.start();
+    bool success = applyPortConfig(portConfig, error);
+
+    // Streams are configured through alsa-lib or tinyalsa: their ioctls are not counted
+    if (_accessTimer.isSlow()) {
+
+        warning() << "Slow port configuration of device " << getCardName() << "," << _device
+                  << ": " << _accessTimer.getBreakdown();
+    }
+    if (recorder != NULL) {
+
+        recorder->recordPortConfig(getCardName(), _device, &portConfig, sizeof(portConfig),
+                                   start, success);
+    }
+    return success;
+}
+
+bool AlsaCtlPortConfig::applyPortConfig(const PortConfig &portConfig, string &error)
+{
     // If device update is needed, close all the stream
     if (isDeviceUpdateNeeded(portConfig)) {
 
@@ -123,6 +159,7 @@ bool AlsaCtlPortConfig::openStream(StreamDirection streamDirection, string &erro
 
             return false;
         }
+        _accessTimer.lap(PhaseConfigure);
 
         // Stream has to be opened
         _portConfig.isStreamEnabled[streamDirection] = true;
@@ -138,6 +175,7 @@ void AlsaCtlPortConfig::closeStream(StreamDirection streamDirection)
 
         // Stream has to be closed
         doCloseStream(streamDirection);
+        _accessTimer.lap(PhaseClose);
 
         _portConfig.isStreamEnabled[streamDirection] = false;
     }
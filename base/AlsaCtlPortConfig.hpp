@@ -30,6 +30,7 @@
 #pragma once
 
 #include "AlsaSubsystemObject.hpp"
+#include "AlsaAccessTimer.hpp"
 #include <stdint.h>
 #include <string>
 
@@ -78,6 +79,17 @@ protected:
     /** Stream direction enum element count */
     static const uint8_t _streamDirectionCount = Capture + 1;
 
+    /** Phases of a port configuration, timed when the SlowAccess mapping key is set */
+    enum AccessPhase
+    {
+        PhaseClose,     /**< Closing the streams */
+        PhaseOpen,      /**< Opening the pcm devices */
+        PhaseConfigure, /**< Setting the hardware and software parameters */
+        PhaseStart,     /**< Starting kept alive streams */
+
+        NbAccessPhases
+    };
+
     /**
      * Open a stream
      * This function is implemented in daughter classes to actually open a stream
@@ -104,6 +116,24 @@ protected:
      */
     uint32_t getDeviceNumber() const { return _device; }
 
+    /**
+     * Check whether the streams are kept running
+     * Kept alive streams are started in mmap interleaved access, the driver filling playback
+     * buffers with silence, and never stop on xrun: the device clocks keep running without
+     * any wakeup of the plugin.
+     *
+     * @return true if the streams are to be started on opening
+     */
+    bool isKeepAliveEnabled() const { return _isKeepAliveEnabled; }
+
+    /**
+     * Get the timer of the port configurations, disabled if no SlowAccess threshold is set
+     * Stream openings end their phases on it.
+     *
+     * @return the access timer
+     */
+    AlsaAccessTimer &getAccessTimer() { return _accessTimer; }
+
     /**
      * Get port config.
      *
@@ -125,6 +155,16 @@ protected:
                            const std::string &error);
 
 private:
+    /**
+     * Apply a port configuration, opening and closing the streams as needed
+     *
+     * @param[in] portConfig the new port config structure
+     * @param[out] error string containing the alsa error in case of failure
+     *
+     * @return true or false in case of failure
+     */
+    bool applyPortConfig(const PortConfig &portConfig, std::string &error);
+
     /**
      * Close and re-open a stream to configure it if needed.
      *
@@ -173,8 +213,15 @@ private:
      */
     bool isDeviceUpdateNeeded(const PortConfig &portConfig) const;
 
+    /** Names of the access phases, in AccessPhase order */
+    static const char *const _accessPhaseNames[NbAccessPhases];
+
     /** Device number */
     uint32_t _device;
+    /** Streams are started on opening */
+    bool _isKeepAliveEnabled;
     /** Port config structure*/
     PortConfig _portConfig;
+    /** Per-phase timing of the port configurations */
+    AlsaAccessTimer _accessTimer;
 };
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "AlsaDescriptorPool.hpp"
+#include <convert.hpp>
+
+#include <limits.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <string>
+#include <tuple>
+
+const char AlsaDescriptorPool::_soundCardPath[] = "/proc/asound/";
+
+bool AlsaDescriptorPool::parseControlNumber(const std::string &controlName, uint32_t &number)
+{
+    const char *first = controlName.c_str();
+    bool isHexadecimal = (first[0] == '0') && ((first[1] == 'x') || (first[1] == 'X'));
+    char *last;
+
+    if (!isdigit(first[0])) {
+
+        return false;
+    }
+    errno = 0;
+    unsigned long value = strtoul(first, &last, isHexadecimal ? 16 : 10);
+
+    if ((errno != 0) || (*last != '\0') || (value > UINT32_MAX)) {
+
+        return false;
+    }
+    number = value;
+
+    return true;
+}
+
+const AlsaCardDescriptor &AlsaDescriptorPool::getCard(const std::string &cardName)
+{
+    std::lock_guard<std::mutex> guard(_cardLock);
+    std::map<std::string, AlsaCardDescriptor>::iterator it = _cards.find(cardName);
+
+    if (it == _cards.end()) {
+
+        it = _cards.emplace(std::piecewise_construct, std::forward_as_tuple(cardName),
+                            std::forward_as_tuple(cardName, getCardNumberByName(cardName))).first;
+    }
+    return it->second;
+}
+
+bool AlsaDescriptorPool::rebindCards(int32_t changedIndex, bool &isResyncNeeded)
+{
+    std::lock_guard<std::mutex> guard(_cardLock);
+    std::map<std::string, AlsaCardDescriptor>::iterator it;
+    bool isChangedIndexBound = false;
+
+    isResyncNeeded = false;
+
+    for (it = _cards.begin(); it != _cards.end(); ++it) {
+
+        AlsaCardDescriptor &card = it->second;
+        int32_t index = getCardNumberByName(card.name);
+        bool isBoundToChangedIndex = (index >= 0) && (index == changedIndex);
+
+        // A card leaving and coming back at the same index is rebound as well
+        if ((index == card.index) && !isBoundToChangedIndex) {
+
+            continue;
+        }
+        card.index = index;
+        card.generation++;
+
+        if ((index >= 0) && card.isResyncEnabled) {
+
+            isResyncNeeded = true;
+        }
+        isChangedIndexBound = isChangedIndexBound || isBoundToChangedIndex;
+    }
+    return isChangedIndexBound;
+}
+
+const AlsaDescriptorPool::ControlNameSet &AlsaDescriptorPool::getControls(
+    const AlsaCardDescriptor &card) const
+{
+    static const ControlNameSet noControls;
+    std::map<const AlsaCardDescriptor *, ControlNameSet>::const_iterator it =
+        _controlsByCard.find(&card);
+
+    return it != _controlsByCard.end() ? it->second : noControls;
+}
+
+int32_t AlsaDescriptorPool::getCardNumberByName(const std::string &cardName)
+{
+    std::string idFilePath;
+    char numberFilepath[PATH_MAX] = "";
+    ssize_t writtenSize;
+
+    // Compute card path (Example: /proc/asound/cloverviewaudio)
+    idFilePath = std::string(_soundCardPath) + cardName;
+
+    // Read corresponding link (Example: card5)
+    writtenSize = readlink(idFilePath.c_str(), numberFilepath, sizeof(numberFilepath));
+
+    if (writtenSize < 0) {
+
+        // Sound card does not exist
+        return -errno;
+    }
+
+    if (static_cast<size_t>(writtenSize) >= sizeof(numberFilepath)) {
+
+        // buffer too small
+        return -ENAMETOOLONG;
+    }
+
+    // Extract card number from link (Example: 5 from card5)
+    int32_t cardNumber = 0;
+    if (convertTo(numberFilepath + strlen("card"), cardNumber)) {
+        return cardNumber;
+    }
+
+    return -1; // A negative value indicates a failure
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <map>
+#include <set>
+#include <unordered_set>
+#include <atomic>
+#include <mutex>
+
+/** Alsa card, shared by all the objects mapped on it */
+struct AlsaCardDescriptor
+{
+    AlsaCardDescriptor(const std::string &cardName, int32_t cardIndex)
+        : name(cardName), index(cardIndex), generation(0), isResyncEnabled(false)
+    {
+    }
+
+    /** Card name, as given by the "Card" mapping key */
+    const std::string name;
+    /** Card index, negative errno if the card was not found. Updated on hotplug */
+    std::atomic<int32_t> index;
+    /** Bumped on each rebinding, handles and metadata of older generations are outdated */
+    std::atomic<uint32_t> generation;
+    /** Whether the subsystem is resynchronized when the card arrives */
+    std::atomic<bool> isResyncEnabled;
+};
+
+/**
+ * Interned card and control name descriptors of a subsystem.
+ *
+ * Objects mapped on the same card or control keep a reference on a single descriptor instead of
+ * their own copy. Descriptors are never released before the subsystem, references stay valid.
+ */
+class AlsaDescriptorPool
+{
+public:
+    /** Interned names of the controls mapped on a card */
+    typedef std::set<const std::string *> ControlNameSet;
+
+    AlsaDescriptorPool() : _cardLock(), _cards(), _controlNames(), _controlsByCard() {}
+
+    /**
+     * Get the descriptor of a card, resolving its index on first use
+     *
+     * @param[in] cardName an alsa card name
+     *
+     * @return the card descriptor
+     */
+    const AlsaCardDescriptor &getCard(const std::string &cardName);
+
+    /**
+     * Request the subsystem to be resynchronized when a card arrives
+     *
+     * @param[in] card the card descriptor
+     */
+    void enableResync(const AlsaCardDescriptor &card)
+    {
+        // Descriptors are owned by the pool, which is the only one to update them
+        const_cast<AlsaCardDescriptor &>(card).isResyncEnabled = true;
+    }
+
+    /**
+     * Resolve again the index of all the cards, after a card arrival or removal
+     * Cards whose index changed, or bound to the changed index, move to a new generation.
+     *
+     * @param[in] changedIndex index of the card that arrived or left, negative if unknown
+     * @param[out] isResyncNeeded true if a card enabling the resynchronization arrived
+     *
+     * @return true if a card is bound to the changed index
+     */
+    bool rebindCards(int32_t changedIndex, bool &isResyncNeeded);
+
+    /**
+     * Get the interned copy of a control name
+     *
+     * @param[in] controlName a control name or numid
+     *
+     * @return the shared control name
+     */
+    const std::string &getControlName(const std::string &controlName)
+    {
+        return *_controlNames.insert(controlName).first;
+    }
+
+    /**
+     * Parse a control mapped by number, decimal or hexadecimal with a 0x prefix
+     * Parsing neither allocates nor locks, so that it can be done on each access.
+     *
+     * @param[in] controlName the control name, starting with a digit
+     * @param[out] number the numid or control index
+     *
+     * @return true if the whole name is a valid number
+     */
+    static bool parseControlNumber(const std::string &controlName, uint32_t &number);
+
+    /**
+     * Find the interned copy of a control name
+     *
+     * @param[in] controlName a control name or numid
+     *
+     * @return the shared control name, NULL if it has not been interned
+     */
+    const std::string *findControlName(const std::string &controlName) const
+    {
+        std::unordered_set<std::string>::const_iterator it = _controlNames.find(controlName);
+
+        return it != _controlNames.end() ? &*it : NULL;
+    }
+
+    /**
+     * Record that a control of a card is mapped
+     *
+     * @param[in] card the card descriptor
+     * @param[in] controlName the interned control name
+     */
+    void addControl(const AlsaCardDescriptor &card, const std::string &controlName)
+    {
+        _controlsByCard[&card].insert(&controlName);
+    }
+
+    /**
+     * Get the controls mapped on a card
+     *
+     * @param[in] card the card descriptor
+     *
+     * @return the interned names of the mapped controls
+     */
+    const ControlNameSet &getControls(const AlsaCardDescriptor &card) const;
+
+    /** @return the number of interned cards */
+    size_t getCardCount() const
+    {
+        std::lock_guard<std::mutex> guard(_cardLock);
+
+        return _cards.size();
+    }
+
+    /** @return the number of interned control names */
+    size_t getControlNameCount() const { return _controlNames.size(); }
+
+private:
+    /**
+     * This function return the card number associated with the card ID (name) passed as argument
+     *
+     * @param[in] cardName an alsa card name
+     *
+     * @return the number of the corresponding alsa card
+     */
+    static int32_t getCardNumberByName(const std::string &cardName);
+
+    /** Path of the sound card in the file system */
+    static const char _soundCardPath[];
+
+    /** Cards are rebound by the hotplug monitor thread while objects are being created */
+    mutable std::mutex _cardLock;
+    /** Cards by name, the map nodes keep the descriptor addresses stable */
+    std::map<std::string, AlsaCardDescriptor> _cards;
+    /** Control names, element addresses are stable across rehashes */
+    std::unordered_set<std::string> _controlNames;
+    /** Mapped controls, by card */
+    std::map<const AlsaCardDescriptor *, ControlNameSet> _controlsByCard;
+};
@@ -0,0 +1,488 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "AlsaEventMonitor.hpp"
+#include <sound/asound.h>
+#include <string.h>
+#include <errno.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+AlsaEventMonitor::AlsaEventMonitor()
+    : _lock(), _cards(), _changeListeners(), _worker(), _epollFd(-1), _eventFd(-1),
+      _isStartAttempted(false), _isStopRequested(false)
+{
+}
+
+AlsaEventMonitor::~AlsaEventMonitor()
+{
+    stop();
+}
+
+bool AlsaEventMonitor::watch(const AlsaCardDescriptor &card, const std::string &controlName,
+                             const std::atomic<bool> *&changeFlag, std::string &error)
+{
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        WatchedControl &watchedControl = _cards[&card].controls[controlName];
+
+        watchedControl.change.controlName = &controlName;
+        changeFlag = &watchedControl.isChanged;
+    }
+    if (!_isStartAttempted) {
+
+        _isStartAttempted = true;
+
+        if (!startWorker(error)) {
+
+            return false;
+        }
+    }
+    // Subscribe to the card, if new
+    wakeUp();
+
+    return true;
+}
+
+bool AlsaEventMonitor::takeChange(const AlsaCardDescriptor &card,
+                                  const std::string &controlName, Change &change)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    CardWatchMap::iterator cardIt = _cards.find(&card);
+
+    if (cardIt == _cards.end()) {
+
+        return false;
+    }
+    std::map<std::string, WatchedControl>::iterator it = cardIt->second.controls.find(controlName);
+
+    if ((it == cardIt->second.controls.end()) || !it->second.isChanged) {
+
+        return false;
+    }
+    Change &pendingChange = it->second.change;
+
+    change = pendingChange;
+
+    pendingChange.isInfoChanged = false;
+    pendingChange.isValueChanged = false;
+    it->second.isChanged = false;
+
+    return true;
+}
+
+void AlsaEventMonitor::addChangeListener(const ChangeCallback &changeListener)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    _changeListeners.push_back(changeListener);
+}
+
+void AlsaEventMonitor::stop()
+{
+    if (_worker.joinable()) {
+
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+
+            _isStopRequested = true;
+        }
+        wakeUp();
+        _worker.join();
+    }
+    for (CardWatchMap::iterator it = _cards.begin(); it != _cards.end(); ++it) {
+
+        closeCard(it->second);
+    }
+    if (_epollFd >= 0) {
+
+        close(_epollFd);
+        _epollFd = -1;
+    }
+    if (_eventFd >= 0) {
+
+        close(_eventFd);
+        _eventFd = -1;
+    }
+    _isStopRequested = false;
+}
+
+bool AlsaEventMonitor::startWorker(std::string &error)
+{
+    _epollFd = epoll_create1(EPOLL_CLOEXEC);
+    _eventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    // The wake up event is the only one without a card
+    event.data.ptr = NULL;
+
+    if ((_epollFd < 0) || (_eventFd < 0) ||
+        (epoll_ctl(_epollFd, EPOLL_CTL_ADD, _eventFd, &event) < 0)) {
+
+        error = std::string("Unable to watch the control events: ") + strerror(errno);
+        stop();
+        return false;
+    }
+    _worker = std::thread(&AlsaEventMonitor::run, this);
+
+    return true;
+}
+
+void AlsaEventMonitor::run()
+{
+    struct epoll_event readyEvents[_maxReadyEvents];
+    ElementEventMap elementEvents;
+
+    while (true) {
+
+        int readyCount = epoll_wait(_epollFd, readyEvents, _maxReadyEvents, -1);
+
+        if (readyCount < 0) {
+
+            if (errno == EINTR) {
+
+                continue;
+            }
+            break;
+        }
+        bool isWokenUp = false;
+
+        for (int index = 0; index < readyCount; index++) {
+
+            std::pair<const AlsaCardDescriptor *const, CardWatch> *watchedCard =
+                static_cast<std::pair<const AlsaCardDescriptor *const, CardWatch> *>(
+                    readyEvents[index].data.ptr);
+
+            if (watchedCard == NULL) {
+
+                uint64_t counter;
+                isWokenUp = read(_eventFd, &counter, sizeof(counter)) == sizeof(counter);
+                continue;
+            }
+            if (readyEvents[index].events & (EPOLLERR | EPOLLHUP)) {
+
+                // The card left, it is subscribed again when rebound
+                closeCard(watchedCard->second);
+                continue;
+            }
+            readEvents(*watchedCard->first, watchedCard->second, elementEvents);
+        }
+
+        // Each changed element is read once, whatever the number of its events
+        for (ElementEventMap::const_iterator it = elementEvents.begin();
+             it != elementEvents.end(); ++it) {
+
+            processEvent(it->first.second, it->second);
+        }
+        elementEvents.clear();
+
+        if (isWokenUp) {
+
+            {
+                std::lock_guard<std::mutex> guard(_lock);
+
+                if (_isStopRequested) {
+
+                    break;
+                }
+            }
+            bindCards();
+        }
+    }
+}
+
+void AlsaEventMonitor::bindCards()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    for (CardWatchMap::iterator it = _cards.begin(); it != _cards.end(); ++it) {
+
+        const AlsaCardDescriptor &card = *it->first;
+        CardWatch &cardWatch = it->second;
+
+        // Generation first: the index is then at least as recent
+        uint32_t generation = card.generation;
+        int32_t cardIndex = card.index;
+
+        if ((cardWatch.fd >= 0) && (cardWatch.generation == generation)) {
+
+            continue;
+        }
+        closeCard(cardWatch);
+        cardWatch.generation = generation;
+
+        if (cardIndex < 0) {
+
+            continue;
+        }
+        char devicePath[32];
+        snprintf(devicePath, sizeof(devicePath), "/dev/snd/controlC%d", cardIndex);
+
+        int subscribe = 1;
+        struct epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.ptr = &*it;
+
+        cardWatch.fd = open(devicePath, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+
+        // Failures are retried on the next wake up
+        if ((cardWatch.fd >= 0) &&
+            ((ioctl(cardWatch.fd, SNDRV_CTL_IOCTL_SUBSCRIBE_EVENTS, &subscribe) < 0) ||
+             (epoll_ctl(_epollFd, EPOLL_CTL_ADD, cardWatch.fd, &event) < 0))) {
+
+            closeCard(cardWatch);
+        }
+    }
+}
+
+void AlsaEventMonitor::closeCard(CardWatch &cardWatch)
+{
+    if (cardWatch.fd >= 0) {
+
+        // Closing the descriptor removes it from the epoll instance
+        close(cardWatch.fd);
+        cardWatch.fd = -1;
+    }
+    cardWatch.elements.clear();
+}
+
+void AlsaEventMonitor::readEvents(const AlsaCardDescriptor &card, CardWatch &cardWatch,
+                                  ElementEventMap &elementEvents)
+{
+    struct snd_ctl_event events[_maxReadyEvents];
+    ssize_t readSize;
+
+    while ((readSize = read(cardWatch.fd, events, sizeof(events))) > 0) {
+
+        size_t eventCount = static_cast<size_t>(readSize) / sizeof(events[0]);
+
+        for (size_t index = 0; index < eventCount; index++) {
+
+            if (events[index].type != SNDRV_CTL_EVENT_ELEM) {
+
+                continue;
+            }
+            const struct snd_ctl_elem_id &id = events[index].data.elem.id;
+            ElementEvent &elementEvent =
+                elementEvents[std::make_pair(&cardWatch, static_cast<uint32_t>(id.numid))];
+
+            if (elementEvent.mask == 0) {
+
+                elementEvent.cardWatch = &cardWatch;
+                elementEvent.card = &card;
+                elementEvent.name = reinterpret_cast<const char *>(id.name);
+                // Names map the first mixer element of that name: elements sharing the name
+                // on other indexes or interfaces are only known by numid
+                elementEvent.isNamed = (id.iface == SNDRV_CTL_ELEM_IFACE_MIXER) &&
+                                       (id.index == 0);
+            }
+            elementEvent.mask |= events[index].data.elem.mask;
+        }
+    }
+}
+
+void AlsaEventMonitor::processEvent(uint32_t numid, const ElementEvent &elementEvent)
+{
+    CardWatch &cardWatch = *elementEvent.cardWatch;
+    // The remove mask has all the bits set
+    bool isRemoved = elementEvent.mask == SNDRV_CTL_EVENT_MASK_REMOVE;
+    bool isInfoChanged = isRemoved ||
+                         (elementEvent.mask & (SNDRV_CTL_EVENT_MASK_INFO |
+                                               SNDRV_CTL_EVENT_MASK_ADD));
+    Change change;
+
+    if (isInfoChanged) {
+
+        cardWatch.elements.erase(numid);
+    }
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+
+        // Changes of the elements which are not watched are not read
+        if (findControl(cardWatch, numid, elementEvent) == NULL) {
+
+            return;
+        }
+    }
+    change.isInfoChanged = isInfoChanged;
+    change.isValueChanged = !isRemoved && (elementEvent.mask & SNDRV_CTL_EVENT_MASK_VALUE) &&
+                            readValues(cardWatch, numid, change);
+
+    if (!change.isInfoChanged && !change.isValueChanged) {
+
+        return;
+    }
+    std::vector<ChangeCallback> changeListeners;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        WatchedControl *watchedControl = findControl(cardWatch, numid, elementEvent);
+
+        if (watchedControl == NULL) {
+
+            return;
+        }
+        Change *pendingChange = &watchedControl->change;
+        // Changes are merged until they are taken
+        change.card = elementEvent.card;
+        change.controlName = pendingChange->controlName;
+        change.isInfoChanged = change.isInfoChanged || pendingChange->isInfoChanged;
+
+        if (change.isValueChanged) {
+
+            *pendingChange = change;
+        } else {
+
+            pendingChange->isInfoChanged = true;
+        }
+        watchedControl->isChanged = true;
+        changeListeners = _changeListeners;
+    }
+    // Listeners are called without the lock, they may take their own
+    for (size_t index = 0; index < changeListeners.size(); index++) {
+
+        changeListeners[index](change);
+    }
+}
+
+bool AlsaEventMonitor::readValues(CardWatch &cardWatch, uint32_t numid, Change &change)
+{
+    std::map<uint32_t, ElementInfo>::iterator infoIt = cardWatch.elements.find(numid);
+
+    if (infoIt == cardWatch.elements.end()) {
+
+        struct snd_ctl_elem_info info;
+        memset(&info, 0, sizeof(info));
+        info.id.numid = numid;
+
+        if (ioctl(cardWatch.fd, SNDRV_CTL_IOCTL_ELEM_INFO, &info) < 0) {
+
+            return false;
+        }
+        ElementInfo elementInfo;
+        elementInfo.count = info.count;
+        elementInfo.isReadable = (info.access & SNDRV_CTL_ELEM_ACCESS_READ) != 0;
+
+        switch (info.type) {
+        case SNDRV_CTL_ELEM_TYPE_BOOLEAN:
+            elementInfo.type = AmixerElementBoolean;
+            break;
+        case SNDRV_CTL_ELEM_TYPE_INTEGER:
+            elementInfo.type = AmixerElementInteger;
+            break;
+        case SNDRV_CTL_ELEM_TYPE_INTEGER64:
+            elementInfo.type = AmixerElementInteger64;
+            break;
+        case SNDRV_CTL_ELEM_TYPE_ENUMERATED:
+            elementInfo.type = AmixerElementEnumerated;
+            break;
+        case SNDRV_CTL_ELEM_TYPE_BYTES:
+            elementInfo.type = AmixerElementBytes;
+            // Larger bytes controls are only accessible as TLV
+            elementInfo.isReadable = elementInfo.isReadable &&
+                                     (info.count <=
+                                      sizeof(snd_ctl_elem_value().value.bytes.data));
+            break;
+        default:
+            elementInfo.type = AmixerElementUnknown;
+            elementInfo.isReadable = false;
+            break;
+        }
+        infoIt = cardWatch.elements.insert(std::make_pair(numid, elementInfo)).first;
+    }
+    const ElementInfo &elementInfo = infoIt->second;
+
+    if (!elementInfo.isReadable) {
+
+        return false;
+    }
+    struct snd_ctl_elem_value value;
+    memset(&value, 0, sizeof(value));
+    value.id.numid = numid;
+
+    if (ioctl(cardWatch.fd, SNDRV_CTL_IOCTL_ELEM_READ, &value) < 0) {
+
+        return false;
+    }
+    change.type = elementInfo.type;
+
+    switch (elementInfo.type) {
+    case AmixerElementBytes:
+        change.bytes.assign(value.value.bytes.data, value.value.bytes.data + elementInfo.count);
+        break;
+    case AmixerElementInteger64:
+        change.values.assign(value.value.integer64.value,
+                             value.value.integer64.value + elementInfo.count);
+        break;
+    case AmixerElementEnumerated:
+        change.values.assign(value.value.enumerated.item,
+                             value.value.enumerated.item + elementInfo.count);
+        break;
+    default:
+        change.values.assign(value.value.integer.value,
+                             value.value.integer.value + elementInfo.count);
+        break;
+    }
+    return true;
+}
+
+AlsaEventMonitor::WatchedControl *AlsaEventMonitor::findControl(CardWatch &cardWatch,
+                                                                uint32_t numid,
+                                                                const ElementEvent &elementEvent)
+{
+    // Controls are mapped either by name or by numid
+    std::map<std::string, WatchedControl>::iterator it = cardWatch.controls.end();
+
+    if (elementEvent.isNamed) {
+
+        it = cardWatch.controls.find(elementEvent.name);
+    }
+    if (it == cardWatch.controls.end()) {
+
+        it = cardWatch.controls.find(std::to_string(numid));
+    }
+    return it != cardWatch.controls.end() ? &it->second : NULL;
+}
+
+void AlsaEventMonitor::wakeUp()
+{
+    uint64_t event = 1;
+
+    if (write(_eventFd, &event, sizeof(event)) < 0) {
+
+        // Only happens on a closed descriptor, when there is no worker to wake up
+        return;
+    }
+}
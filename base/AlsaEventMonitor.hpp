@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AlsaDescriptorPool.hpp"
+#include "AmixerElementType.hpp"
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <atomic>
+
+/**
+ * Alsa control event monitor.
+ *
+ * A single worker thread subscribes to the control events of the cards with watched controls,
+ * through the control devices: it works the same for all the backends. All the events pending
+ * on a wake up are merged per control, and each watched control that changed is read once.
+ *
+ * Changes are kept per control until its object takes them on its next access, and are
+ * published as they come to the change listeners, if any.
+ */
+class AlsaEventMonitor
+{
+public:
+    /** Change of a control, behind the subsystem's back */
+    struct Change
+    {
+        Change()
+            : card(NULL), controlName(NULL), isInfoChanged(false), isValueChanged(false),
+              type(AmixerElementUnknown), values(), bytes()
+        {
+        }
+
+        const AlsaCardDescriptor *card;
+        /** Interned control name, as mapped */
+        const std::string *controlName;
+        /** The control metadata (item names, dB range...) may have changed */
+        bool isInfoChanged;
+        /** The values below are the new values of the control */
+        bool isValueChanged;
+        AmixerElementType type;
+        /** Values of the elements, for all the types but bytes */
+        std::vector<long> values;
+        /** Content of a bytes control */
+        std::vector<uint8_t> bytes;
+    };
+
+    /** Called from the worker thread for each change of a watched control */
+    typedef std::function<void(const Change &change)> ChangeCallback;
+
+    AlsaEventMonitor();
+    ~AlsaEventMonitor();
+
+    /**
+     * Watch the changes of a control, starting the worker thread if needed
+     * A failure to start the thread is only reported by the first call.
+     *
+     * @param[in] card the card descriptor
+     * @param[in] controlName the interned control name, or numid
+     * @param[out] changeFlag set while the control has pending changes: accesses check it
+     *                        before taking them, without locking
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool watch(const AlsaCardDescriptor &card, const std::string &controlName,
+               const std::atomic<bool> *&changeFlag, std::string &error);
+
+    /**
+     * Take the changes of a control since the last call
+     *
+     * @param[in] card the card descriptor
+     * @param[in] controlName the interned control name
+     * @param[out] change the merged changes, the last values only
+     *
+     * @return true if the control changed
+     */
+    bool takeChange(const AlsaCardDescriptor &card, const std::string &controlName,
+                    Change &change);
+
+    /**
+     * Add a listener the changes are published to, in addition to the existing ones
+     * Listeners stay registered until the monitor is destroyed.
+     *
+     * @param[in] changeListener the listener
+     */
+    void addChangeListener(const ChangeCallback &changeListener);
+
+    /** Subscribe again to the cards rebound on hotplug */
+    void rebind() { wakeUp(); }
+
+    /** Stop the worker thread */
+    void stop();
+
+private:
+    /** Element layout, read once per element */
+    struct ElementInfo
+    {
+        AmixerElementType type;
+        uint32_t count;
+        bool isReadable;
+    };
+
+    /** Watched control */
+    struct WatchedControl
+    {
+        WatchedControl() : change(), isChanged(false) {}
+
+        /** Pending changes, merged */
+        Change change;
+        /** Set along with the pending changes */
+        std::atomic<bool> isChanged;
+    };
+
+    /** Event subscription of a card */
+    struct CardWatch
+    {
+        CardWatch() : fd(-1), generation(0), controls(), elements() {}
+
+        /** Subscribed control device, only used by the worker thread */
+        int fd;
+        /** Generation of the card the device was opened for */
+        uint32_t generation;
+        /** Watched controls, by name or numid */
+        std::map<std::string, WatchedControl> controls;
+        /** Element layouts by numid, only used by the worker thread */
+        std::map<uint32_t, ElementInfo> elements;
+    };
+    typedef std::map<const AlsaCardDescriptor *, CardWatch> CardWatchMap;
+
+    /** Events pending on an element, merged */
+    struct ElementEvent
+    {
+        ElementEvent() : cardWatch(NULL), card(NULL), name(), isNamed(false), mask(0) {}
+
+        CardWatch *cardWatch;
+        const AlsaCardDescriptor *card;
+        std::string name;
+        /** The element is the one a control mapped by name resolves to */
+        bool isNamed;
+        uint32_t mask;
+    };
+    /** Pending events, by card and numid */
+    typedef std::map<std::pair<const CardWatch *, uint32_t>, ElementEvent> ElementEventMap;
+
+    /**
+     * Create the epoll instance and the worker thread, if not done yet
+     *
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool startWorker(std::string &error);
+
+    /** Worker thread main loop */
+    void run();
+
+    /** Subscribe to the events of the cards not subscribed yet, or rebound */
+    void bindCards();
+
+    /**
+     * Close the subscription of a card
+     *
+     * @param[in] cardWatch the card subscription
+     */
+    void closeCard(CardWatch &cardWatch);
+
+    /**
+     * Read the events pending on a card
+     *
+     * @param[in] card the card descriptor
+     * @param[in] cardWatch the card subscription
+     * @param[out] elementEvents the pending events, merged per element
+     */
+    void readEvents(const AlsaCardDescriptor &card, CardWatch &cardWatch,
+                    ElementEventMap &elementEvents);
+
+    /**
+     * Read the changes of an element and publish them
+     *
+     * @param[in] numid the element numid
+     * @param[in] elementEvent the merged events of the element
+     */
+    void processEvent(uint32_t numid, const ElementEvent &elementEvent);
+
+    /**
+     * Read the values of an element
+     *
+     * @param[in] cardWatch the card subscription
+     * @param[in] numid the element numid
+     * @param[out] change receives the values of the element
+     *
+     * @return true if the values were read
+     */
+    bool readValues(CardWatch &cardWatch, uint32_t numid, Change &change);
+
+    /**
+     * Find the watched control an element is mapped by, called with the lock held
+     *
+     * @param[in] cardWatch the card subscription
+     * @param[in] numid the element numid
+     * @param[in] elementEvent the events of the element, giving its name
+     *
+     * @return the watched control, NULL if it is not watched
+     */
+    WatchedControl *findControl(CardWatch &cardWatch, uint32_t numid,
+                                const ElementEvent &elementEvent);
+
+    /** Wake up the worker thread */
+    void wakeUp();
+
+    /** Maximum number of descriptors handled per wake up */
+    static const int _maxReadyEvents = 16;
+
+    std::mutex _lock;
+    CardWatchMap _cards;
+    std::vector<ChangeCallback> _changeListeners;
+    std::thread _worker;
+    int _epollFd;
+    /** Worker wake up event, for new cards, rebinding and stop requests */
+    int _eventFd;
+    bool _isStartAttempted;
+    bool _isStopRequested;
+};
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "AlsaHotplugMonitor.hpp"
+#include <convert.hpp>
+
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+
+const char AlsaHotplugMonitor::_soundDirectory[] = "/dev/snd";
+const char AlsaHotplugMonitor::_deviceDirectory[] = "/dev";
+const char AlsaHotplugMonitor::_controlDevicePrefix[] = "controlC";
+
+AlsaHotplugMonitor::AlsaHotplugMonitor(AlsaDescriptorPool &descriptorPool)
+    : _descriptorPool(descriptorPool), _rebindListener(), _worker(), _inotifyFd(-1), _eventFd(-1), _soundWatch(-1),
+      _deviceWatch(-1), _isStartAttempted(false), _isResyncNeeded(false)
+{
+}
+
+AlsaHotplugMonitor::~AlsaHotplugMonitor()
+{
+    stop();
+}
+
+bool AlsaHotplugMonitor::start(std::string &error)
+{
+    if (_isStartAttempted) {
+
+        return true;
+    }
+    _isStartAttempted = true;
+
+    _inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    _eventFd = eventfd(0, EFD_CLOEXEC);
+
+    if ((_inotifyFd < 0) || (_eventFd < 0)) {
+
+        error = std::string("Unable to watch the sound cards: ") + strerror(errno);
+        stop();
+        return false;
+    }
+    if (!watchSoundDirectory() && (_deviceWatch < 0)) {
+
+        error = std::string("Unable to watch ") + _deviceDirectory + ": " + strerror(errno);
+        stop();
+        return false;
+    }
+    _worker = std::thread(&AlsaHotplugMonitor::run, this);
+
+    return true;
+}
+
+void AlsaHotplugMonitor::stop()
+{
+    if (_worker.joinable()) {
+
+        uint64_t event = 1;
+
+        if (write(_eventFd, &event, sizeof(event)) == sizeof(event)) {
+
+            _worker.join();
+        } else {
+
+            // The worker can not be woken up, let it die with the process
+            _worker.detach();
+        }
+    }
+    if (_inotifyFd >= 0) {
+
+        close(_inotifyFd);
+        _inotifyFd = -1;
+    }
+    if (_eventFd >= 0) {
+
+        close(_eventFd);
+        _eventFd = -1;
+    }
+    _soundWatch = -1;
+    _deviceWatch = -1;
+}
+
+bool AlsaHotplugMonitor::watchSoundDirectory()
+{
+    static const uint32_t soundEvents = IN_CREATE | IN_DELETE | IN_MOVED_TO | IN_MOVED_FROM |
+                                        IN_ONLYDIR;
+
+    _soundWatch = inotify_add_watch(_inotifyFd, _soundDirectory, soundEvents);
+
+    if ((_soundWatch < 0) && (_deviceWatch < 0)) {
+
+        // No card yet: wait for the directory creation, then check it was not missed
+        _deviceWatch = inotify_add_watch(_inotifyFd, _deviceDirectory,
+                                         IN_CREATE | IN_MOVED_TO | IN_ONLYDIR);
+        _soundWatch = inotify_add_watch(_inotifyFd, _soundDirectory, soundEvents);
+    }
+    if ((_soundWatch >= 0) && (_deviceWatch >= 0)) {
+
+        inotify_rm_watch(_inotifyFd, _deviceWatch);
+        _deviceWatch = -1;
+    }
+    return _soundWatch >= 0;
+}
+
+void AlsaHotplugMonitor::run()
+{
+    struct pollfd pollFds[] = {
+        { _inotifyFd, POLLIN, 0 },
+        { _eventFd, POLLIN, 0 }
+    };
+    uint32_t retryCount = 0;
+    int32_t pendingIndex = -1;
+
+    // Cards may have arrived before the watch was set
+    rebind(-1);
+
+    while (true) {
+
+        int timeoutMs = (retryCount != 0) ? static_cast<int>(_rebindRetryPeriodMs) : -1;
+        int ret = poll(pollFds, sizeof(pollFds) / sizeof(pollFds[0]), timeoutMs);
+
+        if (ret < 0) {
+
+            if (errno == EINTR) {
+
+                continue;
+            }
+            break;
+        }
+        if (pollFds[1].revents & POLLIN) {
+
+            // Stop requested
+            break;
+        }
+        if (ret == 0) {
+
+            retryCount = rebind(pendingIndex) ? 0 : retryCount - 1;
+            continue;
+        }
+        int32_t createdIndex;
+
+        if (!readEvents(createdIndex)) {
+
+            continue;
+        }
+        if (rebind(createdIndex) || (createdIndex < 0)) {
+
+            retryCount = 0;
+        } else {
+
+            // The created card is not listed yet, or is not mapped
+            pendingIndex = createdIndex;
+            retryCount = _maxRebindRetries;
+        }
+    }
+}
+
+bool AlsaHotplugMonitor::readEvents(int32_t &createdIndex)
+{
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    size_t prefixLength = strlen(_controlDevicePrefix);
+    bool isChanged = false;
+    ssize_t readSize;
+
+    createdIndex = -1;
+
+    while ((readSize = read(_inotifyFd, buffer, sizeof(buffer))) > 0) {
+
+        const char *position = buffer;
+
+        while (position < buffer + readSize) {
+
+            const struct inotify_event *event =
+                reinterpret_cast<const struct inotify_event *>(position);
+            const char *name = (event->len != 0) ? event->name : "";
+
+            position += sizeof(*event) + event->len;
+
+            if (event->wd == _deviceWatch) {
+
+                // The first card created /dev/snd
+                if (strcmp(name, "snd") == 0) {
+
+                    isChanged = watchSoundDirectory() || isChanged;
+                }
+            } else if (event->wd == _soundWatch) {
+
+                if (event->mask & IN_IGNORED) {
+
+                    // The last card left, along with /dev/snd
+                    _soundWatch = -1;
+                    watchSoundDirectory();
+                    isChanged = true;
+
+                } else if (strncmp(name, _controlDevicePrefix, prefixLength) == 0) {
+
+                    int32_t index;
+
+                    isChanged = true;
+
+                    if ((event->mask & (IN_CREATE | IN_MOVED_TO)) &&
+                        convertTo(name + prefixLength, index)) {
+
+                        createdIndex = index;
+                    }
+                }
+            }
+        }
+    }
+    return isChanged;
+}
+
+bool AlsaHotplugMonitor::rebind(int32_t changedIndex)
+{
+    bool isResyncNeeded;
+    bool isChangedIndexBound = _descriptorPool.rebindCards(changedIndex, isResyncNeeded);
+
+    if (isResyncNeeded) {
+
+        _isResyncNeeded = true;
+    }
+    if (_rebindListener) {
+
+        _rebindListener();
+    }
+    return isChangedIndexBound;
+}
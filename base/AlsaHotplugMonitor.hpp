@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AlsaDescriptorPool.hpp"
+#include <stdint.h>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <functional>
+
+/**
+ * Alsa card hotplug monitor.
+ *
+ * A worker thread watches the control devices appearing and disappearing in /dev/snd through
+ * inotify, and rebinds the card descriptors of the pool. Accesses only compare the descriptor
+ * generation with the one their cached handles and metadata were built for: nothing is polled
+ * on the access path.
+ */
+class AlsaHotplugMonitor
+{
+public:
+    /**
+     * @param[in] descriptorPool the pool holding the card descriptors to rebind
+     */
+    AlsaHotplugMonitor(AlsaDescriptorPool &descriptorPool);
+    ~AlsaHotplugMonitor();
+
+    /**
+     * Start watching the cards, if not done yet
+     * A failure is only reported by the first call, the cards are then never rebound.
+     *
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool start(std::string &error);
+
+    /** Stop the worker thread */
+    void stop();
+
+    /**
+     * Set the function called from the worker thread after each rebinding
+     * To be set before the monitor is started.
+     *
+     * @param[in] rebindListener the listener
+     */
+    void setRebindListener(const std::function<void()> &rebindListener)
+    {
+        _rebindListener = rebindListener;
+    }
+
+    /**
+     * Check whether a card enabling the resynchronization arrived
+     *
+     * @param[in] clear true to acknowledge the resynchronization
+     *
+     * @return true if the subsystem needs to be resynchronized
+     */
+    bool isResyncNeeded(bool clear)
+    {
+        return clear ? _isResyncNeeded.exchange(false) : _isResyncNeeded.load();
+    }
+
+private:
+    /** Worker thread main loop */
+    void run();
+
+    /**
+     * Watch /dev/snd, or /dev until /dev/snd is created by the first card
+     *
+     * @return true if /dev/snd is watched
+     */
+    bool watchSoundDirectory();
+
+    /**
+     * Handle the inotify events pending on the inotify descriptor
+     *
+     * @param[out] createdIndex index of the last card whose control device was created,
+     *                          negative if none
+     *
+     * @return true if a card may have arrived or left
+     */
+    bool readEvents(int32_t &createdIndex);
+
+    /**
+     * Rebind the card descriptors
+     *
+     * @param[in] changedIndex index of the card that arrived or left, negative if unknown
+     *
+     * @return true if a card is bound to the changed index
+     */
+    bool rebind(int32_t changedIndex);
+
+    /** Control devices are created before the card is listed in /proc/asound: retry a while */
+    static const uint32_t _rebindRetryPeriodMs = 100;
+    static const uint32_t _maxRebindRetries = 10;
+
+    /** Directory of the sound devices, and its parent */
+    static const char _soundDirectory[];
+    static const char _deviceDirectory[];
+    /** Prefix of the control device names, followed by the card index */
+    static const char _controlDevicePrefix[];
+
+    AlsaDescriptorPool &_descriptorPool;
+    std::function<void()> _rebindListener;
+    std::thread _worker;
+    int _inotifyFd;
+    /** Worker stop event */
+    int _eventFd;
+    /** Watch on /dev/snd, negative while it does not exist */
+    int _soundWatch;
+    /** Watch on /dev, only kept while /dev/snd does not exist */
+    int _deviceWatch;
+    bool _isStartAttempted;
+    std::atomic<bool> _isResyncNeeded;
+};
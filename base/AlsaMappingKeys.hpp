@@ -40,6 +40,17 @@ enum AlsaItemType
     AlsaAmend3,
     AlsaAmend4,
     AlsaAmendEnd = AlsaAmend4,
+    AlsaRampTime,
+    AlsaStateDirectory,
+    AlsaResyncOnArrival,
+    AlsaEventsEnabled,
+    AlsaRecordFile,
+    AlsaKeepAlive,
+    AlsaAccessClass,
+    AlsaSlowAccessThreshold,
+    AlsaMirrorName,
+    AlsaBrokerSocket,
+    AlsaResolutionDirectory,
 
     NbAlsaItemTypes
 };
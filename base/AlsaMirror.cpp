@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "AlsaMirror.hpp"
+#include "AlsaTrafficLog.hpp"
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+
+const size_t AlsaMirror::_maxDataSize;
+
+AlsaMirror::AlsaMirror()
+    : _lock(), _entries(), _name(), _header(NULL), _firstEntry(NULL), _segmentSize(0)
+{
+}
+
+AlsaMirror::~AlsaMirror()
+{
+    if (_header == NULL) {
+
+        return;
+    }
+    // Readers keep their mapping: they only lose the name
+    munmap(_header, _segmentSize);
+    shm_unlink(_name.c_str());
+}
+
+bool AlsaMirror::open(const std::string &name, std::string &error)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    if (_header != NULL) {
+
+        if (name != _name) {
+
+            error = "already publishing into " + _name;
+            return false;
+        }
+        return true;
+    }
+    _segmentSize = sizeof(Header) + _maxEntries * sizeof(Entry);
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+
+    if (fd < 0) {
+
+        error = "unable to open shared memory " + name + ": " + strerror(errno);
+        return false;
+    }
+    // Truncating first clears the content left by a previous instance
+    void *segment = MAP_FAILED;
+
+    if ((ftruncate(fd, 0) == 0) && (ftruncate(fd, _segmentSize) == 0)) {
+
+        segment = mmap(NULL, _segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (segment == MAP_FAILED) {
+
+        error = "unable to map shared memory " + name + ": " + strerror(errno);
+        close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    close(fd);
+
+    _header = static_cast<Header *>(segment);
+    _firstEntry = reinterpret_cast<Entry *>(_header + 1);
+    _name = name;
+
+    memcpy(_header->magic, "PFWMIRR", sizeof(_header->magic));
+    _header->version = _version;
+    _header->entrySize = sizeof(Entry);
+    _header->maxEntries = _maxEntries;
+    _header->entryCount.store(0, std::memory_order_release);
+
+    return true;
+}
+
+AlsaMirror::Entry *AlsaMirror::addEntry(const AlsaCardDescriptor &card,
+                                        const std::string &controlName, std::string &error)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    if (_header == NULL) {
+
+        error = "the shared memory is not opened";
+        return NULL;
+    }
+    EntryMap::key_type key(&card, &controlName);
+    EntryMap::const_iterator it = _entries.find(key);
+
+    if (it != _entries.end()) {
+
+        return it->second;
+    }
+    uint32_t index = _header->entryCount.load(std::memory_order_relaxed);
+
+    if (index >= _maxEntries) {
+
+        error = "the shared memory is full (" + std::to_string(_maxEntries) + " controls)";
+        return NULL;
+    }
+    Entry *entry = &_firstEntry[index];
+
+    entry->type = AmixerElementUnknown;
+    strncpy(entry->card, card.name.c_str(), sizeof(entry->card) - 1);
+    strncpy(entry->control, controlName.c_str(), sizeof(entry->control) - 1);
+
+    // Names are visible before the entry is
+    _header->entryCount.store(index + 1, std::memory_order_release);
+    _entries.insert(std::make_pair(key, entry));
+
+    return entry;
+}
+
+void AlsaMirror::publish(Entry &entry, AmixerElementType type, const long *values,
+                         const void *bytes, uint32_t count)
+{
+    uint32_t sequence = entry.sequence.load(std::memory_order_relaxed);
+
+    // Writers take the entry by making its sequence odd
+    while ((sequence & 1) ||
+           !entry.sequence.compare_exchange_weak(sequence, sequence + 1,
+                                                 std::memory_order_acquire)) {
+
+        sequence = entry.sequence.load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    entry.type = type;
+    entry.count = count;
+    entry.updateTime = AlsaTrafficRecorder::now();
+
+    if (type == AmixerElementBytes) {
+
+        entry.size = std::min<size_t>(count, _maxDataSize);
+        memcpy(entry.data.bytes, bytes, entry.size);
+    } else {
+
+        uint32_t valueCount = std::min<size_t>(count, _maxDataSize / sizeof(int64_t));
+
+        for (uint32_t index = 0; index < valueCount; index++) {
+
+            entry.data.values[index] = values[index];
+        }
+        entry.size = valueCount * sizeof(int64_t);
+    }
+    entry.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void AlsaMirror::publishChange(const AlsaEventMonitor::Change &change)
+{
+    if (!change.isValueChanged) {
+
+        return;
+    }
+    Entry *entry;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        EntryMap::const_iterator it = _entries.find(EntryMap::key_type(change.card,
+                                                                       change.controlName));
+        if (it == _entries.end()) {
+
+            return;
+        }
+        entry = it->second;
+    }
+    uint32_t count = (change.type == AmixerElementBytes) ? change.bytes.size()
+                                                         : change.values.size();
+
+    publish(*entry, change.type, change.values.data(), change.bytes.data(), count);
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AmixerElementType.hpp"
+#include "AlsaDescriptorPool.hpp"
+#include "AlsaEventMonitor.hpp"
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <map>
+#include <mutex>
+#include <atomic>
+
+/**
+ * Shared memory mirror of the last known values of the mapped controls, opt-in through the
+ * Mirror mapping key, for other processes to read them without any system call.
+ *
+ * The POSIX shared memory segment is made of a Header followed by maxEntries Entry slots, in
+ * native endianness. An entry is added per mapped control, at a stable index, its names being
+ * set before entryCount is incremented. Each entry is guarded by a sequence lock: readers copy
+ * the entry while its sequence is even, and retry if the sequence changed meanwhile.
+ *
+ * Entries are updated by the accesses of the plugin and by the control events. Publishing
+ * neither allocates nor blocks on a lock: accesses stay real-time safe.
+ */
+class AlsaMirror
+{
+public:
+    /** Segment header */
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        /** Size of an entry, in bytes */
+        uint32_t entrySize;
+        uint32_t maxEntries;
+        /** Number of entries in use */
+        std::atomic<uint32_t> entryCount;
+    };
+
+    /** Last known values of a control */
+    struct Entry
+    {
+        /** Odd while the entry is being written */
+        std::atomic<uint32_t> sequence;
+        /** AmixerElementType of the control, AmixerElementUnknown until first known */
+        uint32_t type;
+        /** Number of elements of the control, or bytes for BYTES controls */
+        uint32_t count;
+        /** Number of bytes of data below, truncated to _maxDataSize */
+        uint32_t size;
+        /** Monotonic time of the last update, in ns */
+        uint64_t updateTime;
+        char card[32];
+        char control[64];
+        /** Values as 64 bits integers, or content of BYTES controls */
+        union
+        {
+            int64_t values[64];
+            uint8_t bytes[512];
+        } data;
+    };
+
+    /** Maximum number of entries of a segment */
+    static const uint32_t _maxEntries = 1024;
+    /** Format version of the segment */
+    static const uint32_t _version = 1;
+
+    AlsaMirror();
+    ~AlsaMirror();
+
+    /**
+     * Create the shared memory segment, if not created yet
+     * A subsystem publishes into a single segment: enabling another one is an error.
+     *
+     * @param[in] name name of the segment, as given to shm_open
+     * @param[out] error string containing error description
+     *
+     * @return true if the segment is created
+     */
+    bool open(const std::string &name, std::string &error);
+
+    /**
+     * Get the entry of a control, adding it if needed
+     *
+     * @param[in] card the card descriptor
+     * @param[in] controlName the interned control name
+     * @param[out] error string containing error description
+     *
+     * @return the entry, NULL if the segment is not created or full
+     */
+    Entry *addEntry(const AlsaCardDescriptor &card, const std::string &controlName,
+                    std::string &error);
+
+    /**
+     * Publish the values of a control
+     * Concurrent publications of an entry are serialized on its sequence.
+     *
+     * @param[in,out] entry the entry of the control
+     * @param[in] type the element type of the control
+     * @param[in] values the element values, for all the types but bytes
+     * @param[in] bytes the content of a bytes control
+     * @param[in] count number of elements, or bytes
+     */
+    static void publish(Entry &entry, AmixerElementType type, const long *values,
+                        const void *bytes, uint32_t count);
+
+    /**
+     * Publish the change of a watched control, as a change callback of the event monitor
+     *
+     * @param[in] change the change of the control
+     */
+    void publishChange(const AlsaEventMonitor::Change &change);
+
+private:
+    AlsaMirror(const AlsaMirror &);
+    AlsaMirror &operator=(const AlsaMirror &);
+
+    /** Size of the data of an entry */
+    static const size_t _maxDataSize = sizeof(static_cast<Entry *>(NULL)->data);
+
+    /** Entries by card and interned control name */
+    typedef std::map<std::pair<const AlsaCardDescriptor *, const std::string *>, Entry *> EntryMap;
+
+    /** Guards the entry map, added to while loading and looked up by the event monitor */
+    std::mutex _lock;
+    EntryMap _entries;
+    std::string _name;
+    Header *_header;
+    Entry *_firstEntry;
+    size_t _segmentSize;
+};
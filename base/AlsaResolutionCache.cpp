@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "AlsaResolutionCache.hpp"
+#include "AlsaCardFingerprint.hpp"
+#include "AlsaSnapshot.hpp"
+
+void AlsaResolutionCache::addCard(const AlsaCardDescriptor &card, const std::string &directory)
+{
+    if (_cards.find(&card) == _cards.end()) {
+
+        CardCache &cache = _cards[&card];
+
+        cache.path = getPath(card, directory);
+        cache.isLoaded = false;
+        cache.generation = 0;
+        cache.isModified = false;
+    }
+}
+
+const AlsaResolutionCache::Resolution *AlsaResolutionCache::find(
+    const AlsaCardDescriptor &card, const std::string &controlName)
+{
+    CardCache *cache = getCache(card);
+
+    if (cache == NULL) {
+
+        return NULL;
+    }
+    ResolutionMap::const_iterator it = cache->resolutions.find(&controlName);
+
+    return it != cache->resolutions.end() ? &it->second : NULL;
+}
+
+void AlsaResolutionCache::add(const AlsaCardDescriptor &card, const std::string &controlName,
+                              const Resolution &resolution)
+{
+    CardCache *cache = getCache(card);
+
+    if (cache != NULL) {
+
+        cache->resolutions[&controlName] = resolution;
+        cache->isModified = true;
+    }
+}
+
+void AlsaResolutionCache::drop(const AlsaCardDescriptor &card, const std::string &controlName)
+{
+    CardCache *cache = getCache(card);
+
+    if ((cache != NULL) && (cache->resolutions.erase(&controlName) != 0)) {
+
+        cache->isModified = true;
+    }
+}
+
+std::vector<const AlsaCardDescriptor *> AlsaResolutionCache::getModifiedCards() const
+{
+    std::vector<const AlsaCardDescriptor *> cards;
+    CardMap::const_iterator it;
+
+    for (it = _cards.begin(); it != _cards.end(); ++it) {
+
+        if (it->second.isModified) {
+
+            cards.push_back(it->first);
+        }
+    }
+    return cards;
+}
+
+bool AlsaResolutionCache::store(const AlsaCardDescriptor &card, std::string &error)
+{
+    CardCache *cache = getCache(card);
+    int32_t cardIndex = card.index;
+    uint64_t fingerprint;
+
+    if (cache == NULL) {
+
+        return true;
+    }
+    if (cardIndex < 0) {
+
+        error = "Card " + card.name + " not found";
+        return false;
+    }
+    if (!AlsaCardFingerprint::compute(cardIndex, fingerprint, error)) {
+
+        return false;
+    }
+    AlsaSnapshotWriter snapshot;
+    ResolutionMap::const_iterator it;
+
+    snapshot.setFingerprint(fingerprint);
+
+    for (it = cache->resolutions.begin(); it != cache->resolutions.end(); ++it) {
+
+        const Resolution &resolution = it->second;
+        long values[_entryValueCount] = {
+            resolution.numid, resolution.type, resolution.count, resolution.itemCount,
+            (resolution.isTlvReadable ? _tlvReadable : 0) |
+            (resolution.isTlvWritable ? _tlvWritable : 0)
+        };
+        snapshot.addValues(*it->first, AmixerElementInteger64, values, _entryValueCount);
+    }
+    if (!snapshot.commit(cache->path, error)) {
+
+        return false;
+    }
+    cache->isModified = false;
+
+    return true;
+}
+
+AlsaResolutionCache::CardCache *AlsaResolutionCache::getCache(const AlsaCardDescriptor &card)
+{
+    CardMap::iterator it = _cards.find(&card);
+
+    if (it == _cards.end()) {
+
+        return NULL;
+    }
+    CardCache &cache = it->second;
+
+    // Resolutions of another binding of the card may not apply
+    uint32_t generation = card.generation;
+
+    if (!cache.isLoaded || (cache.generation != generation)) {
+
+        cache.generation = generation;
+        load(card, cache);
+    }
+    return &cache;
+}
+
+void AlsaResolutionCache::load(const AlsaCardDescriptor &card, CardCache &cache)
+{
+    cache.isLoaded = true;
+    cache.isModified = false;
+    cache.resolutions.clear();
+
+    AlsaSnapshotReader snapshot;
+    uint64_t fingerprint;
+    std::string error;
+
+    // A missing or stale cache is not an error: controls are looked up on the card
+    if ((card.index < 0) || !snapshot.open(cache.path, error) ||
+        !AlsaCardFingerprint::compute(card.index, fingerprint, error) ||
+        (snapshot.getFingerprint() != fingerprint)) {
+
+        // Written again at shutdown, once filled by the lookups
+        cache.isModified = true;
+        return;
+    }
+    AlsaSnapshotReader::Entry entry;
+
+    while (snapshot.next(entry, error)) {
+
+        // Only the names of mapped controls are interned
+        const std::string *controlName = _pool.findControlName(entry.controlName);
+
+        if ((controlName != NULL) && (entry.type == AmixerElementInteger64) &&
+            (entry.count == _entryValueCount) && (entry.values[1] >= 0) &&
+            (entry.values[1] <= AmixerElementUnknown)) {
+
+            Resolution resolution = {
+                static_cast<uint32_t>(entry.values[0]),
+                static_cast<AmixerElementType>(entry.values[1]),
+                static_cast<uint32_t>(entry.values[2]), static_cast<uint32_t>(entry.values[3]),
+                (entry.values[4] & _tlvReadable) != 0, (entry.values[4] & _tlvWritable) != 0
+            };
+            cache.resolutions[controlName] = resolution;
+        }
+    }
+    if (!error.empty()) {
+
+        // Corrupted cache: trust none of it
+        cache.resolutions.clear();
+        cache.isModified = true;
+    }
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AlsaDescriptorPool.hpp"
+#include "AmixerElementType.hpp"
+#include <stdint.h>
+#include <string>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Control resolutions of the cards, persisted across boots.
+ *
+ * The numid, element type, count, item count and TLV flags of the mapped controls are saved at
+ * shutdown in a snapshot file per card (see AlsaSnapshot.hpp), as the 64 bits integer values
+ * of an entry per control. The file of a card is loaded on first use and only
+ * trusted if the card fingerprint still matches the one saved along with it: backends then
+ * address the controls by numid, without looking them up.
+ * Resolutions are kept until the card is rebound, or an access by numid fails.
+ */
+class AlsaResolutionCache
+{
+public:
+    /** Resolution of a control */
+    struct Resolution
+    {
+        uint32_t numid;
+        AmixerElementType type;
+        uint32_t count;
+        uint32_t itemCount;
+        bool isTlvReadable;
+        bool isTlvWritable;
+    };
+
+    /**
+     * AlsaResolutionCache Class constructor
+     *
+     * @param[in] pool the descriptor pool interning the control names
+     */
+    AlsaResolutionCache(AlsaDescriptorPool &pool) : _pool(pool), _cards() {}
+
+    /**
+     * Enable the resolution cache of a card
+     *
+     * @param[in] card the card descriptor
+     * @param[in] directory directory of the cache files, one per card
+     */
+    void addCard(const AlsaCardDescriptor &card, const std::string &directory);
+
+    /**
+     * Find the resolution of a control
+     *
+     * @param[in] card the card descriptor
+     * @param[in] controlName the interned control name
+     *
+     * @return the resolution, NULL if unknown or if the cache is not enabled on the card
+     */
+    const Resolution *find(const AlsaCardDescriptor &card, const std::string &controlName);
+
+    /**
+     * Add the resolution of a control looked up on the card, if the cache is enabled on it
+     *
+     * @param[in] card the card descriptor
+     * @param[in] controlName the interned control name
+     * @param[in] resolution the resolution
+     */
+    void add(const AlsaCardDescriptor &card, const std::string &controlName,
+             const Resolution &resolution);
+
+    /**
+     * Forget the resolution of a control, which no longer applies
+     *
+     * @param[in] card the card descriptor
+     * @param[in] controlName the interned control name
+     */
+    void drop(const AlsaCardDescriptor &card, const std::string &controlName);
+
+    /**
+     * Get the cards whose resolutions changed since they were loaded
+     *
+     * @return the cards whose cache file is to be written
+     */
+    std::vector<const AlsaCardDescriptor *> getModifiedCards() const;
+
+    /**
+     * Write the cache file of a card, along with its fingerprint
+     *
+     * @param[in] card the card descriptor
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool store(const AlsaCardDescriptor &card, std::string &error);
+
+    /**
+     * Get the cache file path of a card
+     *
+     * @param[in] card the card descriptor
+     * @param[in] directory directory of the cache files
+     *
+     * @return the cache file path
+     */
+    static std::string getPath(const AlsaCardDescriptor &card, const std::string &directory)
+    {
+        return directory + "/" + card.name + ".resolution";
+    }
+
+private:
+    typedef std::unordered_map<const std::string *, Resolution> ResolutionMap;
+
+    /** Resolutions of a card */
+    struct CardCache
+    {
+        std::string path;
+        /** False until the first lookup */
+        bool isLoaded;
+        /** Card binding the resolutions apply to */
+        uint32_t generation;
+        /** Resolutions were added or dropped since loaded */
+        bool isModified;
+        /** Resolutions, by interned control name */
+        ResolutionMap resolutions;
+    };
+    typedef std::map<const AlsaCardDescriptor *, CardCache> CardMap;
+
+    /**
+     * Get the cache of a card, loading it if not done yet for its current binding
+     *
+     * @param[in] card the card descriptor
+     *
+     * @return the cache, NULL if not enabled on the card
+     */
+    CardCache *getCache(const AlsaCardDescriptor &card);
+
+    /**
+     * Load the cache file of a card, dropping it if stale
+     *
+     * @param[in] card the card descriptor
+     * @param[in] cache the cache of the card
+     */
+    void load(const AlsaCardDescriptor &card, CardCache &cache);
+
+    /** Values of an entry: numid, element type, count, item count and TLV flags */
+    static const uint32_t _entryValueCount = 5;
+    static const long _tlvReadable = 1 << 0;
+    static const long _tlvWritable = 1 << 1;
+
+    AlsaDescriptorPool &_pool;
+    CardMap _cards;
+};
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "AlsaSnapshot.hpp"
+#include <string.h>
+#include <errno.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace
+{
+
+/** Snapshot file header */
+struct SnapshotHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+    /** Fingerprint of the card the snapshot has been taken from */
+    uint64_t fingerprint;
+};
+
+/** Snapshot entry header, followed by the name and the values */
+struct SnapshotEntry
+{
+    /** Size of the whole entry, padding included */
+    uint32_t size;
+    uint32_t valueCount;
+    uint16_t nameLength;
+    uint8_t type;
+    uint8_t reserved[5];
+};
+
+const char gSnapshotMagic[8] = "PFWALSA";
+const uint32_t gSnapshotVersion = 2;
+
+/** @return size rounded up to the record alignment */
+inline size_t align(size_t size)
+{
+    return (size + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+}
+
+} // namespace
+
+AlsaSnapshotWriter::AlsaSnapshotWriter() : _buffer(sizeof(SnapshotHeader) / sizeof(uint64_t))
+{
+    SnapshotHeader *header = reinterpret_cast<SnapshotHeader *>(_buffer.data());
+
+    memcpy(header->magic, gSnapshotMagic, sizeof(header->magic));
+    header->version = gSnapshotVersion;
+    header->entryCount = 0;
+    header->fingerprint = 0;
+}
+
+void AlsaSnapshotWriter::setFingerprint(uint64_t fingerprint)
+{
+    reinterpret_cast<SnapshotHeader *>(_buffer.data())->fingerprint = fingerprint;
+}
+
+uint32_t AlsaSnapshotWriter::getEntryCount() const
+{
+    return reinterpret_cast<const SnapshotHeader *>(_buffer.data())->entryCount;
+}
+
+void *AlsaSnapshotWriter::addEntry(const std::string &controlName, AmixerElementType type,
+                                   uint32_t valueCount, size_t payloadSize)
+{
+    size_t nameSize = align(controlName.size() + 1);
+    size_t entrySize = sizeof(SnapshotEntry) + nameSize + align(payloadSize);
+    size_t offset = _buffer.size();
+
+    _buffer.resize(offset + entrySize / sizeof(uint64_t), 0);
+
+    uint8_t *location = reinterpret_cast<uint8_t *>(&_buffer[offset]);
+    SnapshotEntry *entry = reinterpret_cast<SnapshotEntry *>(location);
+
+    entry->size = entrySize;
+    entry->valueCount = valueCount;
+    entry->nameLength = controlName.size();
+    entry->type = type;
+
+    memcpy(location + sizeof(SnapshotEntry), controlName.c_str(), controlName.size() + 1);
+
+    reinterpret_cast<SnapshotHeader *>(_buffer.data())->entryCount++;
+
+    return location + sizeof(SnapshotEntry) + nameSize;
+}
+
+void AlsaSnapshotWriter::addValues(const std::string &controlName, AmixerElementType type,
+                                   const long *values, uint32_t count)
+{
+    int64_t *payload = static_cast<int64_t *>(
+        addEntry(controlName, type, count, count * sizeof(int64_t)));
+
+    for (uint32_t index = 0; index < count; index++) {
+
+        payload[index] = values[index];
+    }
+}
+
+void AlsaSnapshotWriter::addBytes(const std::string &controlName, const void *data,
+                                  uint32_t size)
+{
+    memcpy(addEntry(controlName, AmixerElementBytes, size, size), data, size);
+}
+
+bool AlsaSnapshotWriter::commit(const std::string &path, std::string &error) const
+{
+    std::string temporaryPath = path + ".tmp";
+    int fd = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+    if (fd < 0) {
+
+        error = "Unable to create " + temporaryPath + ": " + strerror(errno);
+        return false;
+    }
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(_buffer.data());
+    size_t size = _buffer.size() * sizeof(uint64_t);
+
+    while (size != 0) {
+
+        ssize_t written = write(fd, data, size);
+
+        if (written < 0) {
+
+            if (errno == EINTR) {
+
+                continue;
+            }
+            error = "Unable to write " + temporaryPath + ": " + strerror(errno);
+            ::close(fd);
+            unlink(temporaryPath.c_str());
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    // Readers either get the previous snapshot or the complete new one
+    if ((fsync(fd) < 0) || (::close(fd) < 0) ||
+        (rename(temporaryPath.c_str(), path.c_str()) < 0)) {
+
+        error = "Unable to commit " + path + ": " + strerror(errno);
+        unlink(temporaryPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+AlsaSnapshotReader::AlsaSnapshotReader() : _data(NULL), _size(0), _offset(0), _remainingEntries(0)
+{
+}
+
+AlsaSnapshotReader::~AlsaSnapshotReader()
+{
+    close();
+}
+
+void AlsaSnapshotReader::close()
+{
+    if (_data != NULL) {
+
+        munmap(const_cast<uint8_t *>(_data), _size);
+        _data = NULL;
+    }
+    _size = 0;
+    _offset = 0;
+    _remainingEntries = 0;
+}
+
+bool AlsaSnapshotReader::open(const std::string &path, std::string &error)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0) {
+
+        error = "Unable to open " + path + ": " + strerror(errno);
+        return false;
+    }
+    struct stat fileStat;
+
+    if (fstat(fd, &fileStat) < 0) {
+
+        error = "Unable to stat " + path + ": " + strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    if (static_cast<size_t>(fileStat.st_size) < sizeof(SnapshotHeader)) {
+
+        error = path + " is not a snapshot";
+        ::close(fd);
+        return false;
+    }
+    void *data = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    ::close(fd);
+
+    if (data == MAP_FAILED) {
+
+        error = "Unable to map " + path + ": " + strerror(errno);
+        return false;
+    }
+    _data = static_cast<const uint8_t *>(data);
+    _size = fileStat.st_size;
+
+    const SnapshotHeader *header = reinterpret_cast<const SnapshotHeader *>(_data);
+
+    if (memcmp(header->magic, gSnapshotMagic, sizeof(header->magic)) != 0) {
+
+        error = path + " is not a snapshot";
+        close();
+        return false;
+    }
+    if (header->version != gSnapshotVersion) {
+
+        error = path + ": unsupported snapshot version " + std::to_string(header->version);
+        close();
+        return false;
+    }
+    _offset = sizeof(SnapshotHeader);
+    _remainingEntries = header->entryCount;
+
+    return true;
+}
+
+uint32_t AlsaSnapshotReader::getEntryCount() const
+{
+    return _data != NULL ? reinterpret_cast<const SnapshotHeader *>(_data)->entryCount : 0;
+}
+
+uint64_t AlsaSnapshotReader::getFingerprint() const
+{
+    return _data != NULL ? reinterpret_cast<const SnapshotHeader *>(_data)->fingerprint : 0;
+}
+
+bool AlsaSnapshotReader::next(Entry &entry, std::string &error)
+{
+    error.clear();
+
+    if (_remainingEntries == 0) {
+
+        return false;
+    }
+    const SnapshotEntry *header = reinterpret_cast<const SnapshotEntry *>(_data + _offset);
+
+    // Never trust the file: check the entry fits before looking into it
+    if ((_size - _offset < sizeof(SnapshotEntry)) || (header->size > _size - _offset)) {
+
+        error = "Truncated snapshot";
+        return false;
+    }
+    size_t nameSize = align(header->nameLength + 1);
+    bool isBytes = (header->type == AmixerElementBytes);
+    size_t payloadSize = isBytes ? header->valueCount : header->valueCount * sizeof(int64_t);
+    const uint8_t *name = _data + _offset + sizeof(SnapshotEntry);
+
+    if ((sizeof(SnapshotEntry) + nameSize + align(payloadSize) != header->size) ||
+        (name[header->nameLength] != '\0') || (header->type >= AmixerElementUnknown)) {
+
+        error = "Corrupted snapshot entry";
+        return false;
+    }
+    const uint8_t *payload = name + nameSize;
+
+    entry.controlName = reinterpret_cast<const char *>(name);
+    entry.type = static_cast<AmixerElementType>(header->type);
+    entry.count = header->valueCount;
+    entry.values = isBytes ? NULL : reinterpret_cast<const int64_t *>(payload);
+    entry.bytes = isBytes ? payload : NULL;
+
+    _offset += header->size;
+    _remainingEntries--;
+
+    return true;
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AmixerElementType.hpp"
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/**
+ * Binary snapshot of the mixer controls of a card.
+ *
+ * The file is made of a header followed by one entry per control, keyed by control name. All the
+ * records are 8 bytes aligned and in native endianness, so that a mapped snapshot is used in place:
+ *  - header: magic, format version, entry count, fingerprint of the card
+ *  - entry: entry size, value count, name length, element type, followed by the NUL terminated
+ *    name and the values, both padded to 8 bytes. Values are 64 bits integers, or raw bytes for
+ *    BYTES controls.
+ */
+class AlsaSnapshotWriter
+{
+public:
+    AlsaSnapshotWriter();
+
+    /**
+     * Add the values of a boolean, integer or enumerated control
+     *
+     * @param[in] controlName name of the control
+     * @param[in] type element type of the control
+     * @param[in] values the element values
+     * @param[in] count number of elements
+     */
+    void addValues(const std::string &controlName, AmixerElementType type,
+                   const long *values, uint32_t count);
+
+    /**
+     * Add the content of a BYTES control
+     *
+     * @param[in] controlName name of the control
+     * @param[in] data the bytes of the control
+     * @param[in] size number of bytes
+     */
+    void addBytes(const std::string &controlName, const void *data, uint32_t size);
+
+    /**
+     * Write the snapshot, replacing any previous file atomically
+     *
+     * @param[in] path path of the snapshot file
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool commit(const std::string &path, std::string &error) const;
+
+    /** @return the number of entries */
+    uint32_t getEntryCount() const;
+
+    /**
+     * Set the fingerprint of the card the snapshot is taken from
+     *
+     * @param[in] fingerprint the card fingerprint
+     */
+    void setFingerprint(uint64_t fingerprint);
+
+private:
+    /**
+     * Append an entry, its payload being left to fill
+     *
+     * @param[in] controlName name of the control
+     * @param[in] type element type of the control
+     * @param[in] valueCount number of elements
+     * @param[in] payloadSize size of the values, in bytes
+     *
+     * @return the location of the payload
+     */
+    void *addEntry(const std::string &controlName, AmixerElementType type,
+                   uint32_t valueCount, size_t payloadSize);
+
+    /** Snapshot content, in 8 bytes words to keep the records aligned */
+    std::vector<uint64_t> _buffer;
+};
+
+/** Reader of snapshots written by AlsaSnapshotWriter, the file is mapped and never copied */
+class AlsaSnapshotReader
+{
+public:
+    /** Snapshot entry, pointing into the mapped file */
+    struct Entry
+    {
+        const char *controlName;
+        AmixerElementType type;
+        uint32_t count;
+        /** Values of the elements, NULL for BYTES controls */
+        const int64_t *values;
+        /** Content of BYTES controls, NULL otherwise */
+        const void *bytes;
+    };
+
+    AlsaSnapshotReader();
+    ~AlsaSnapshotReader();
+
+    /**
+     * Map a snapshot file and check its header
+     *
+     * @param[in] path path of the snapshot file
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool open(const std::string &path, std::string &error);
+
+    /** @return the number of entries of the snapshot */
+    uint32_t getEntryCount() const;
+
+    /** @return the fingerprint of the card the snapshot has been taken from */
+    uint64_t getFingerprint() const;
+
+    /**
+     * Get the next entry
+     *
+     * @param[out] entry the entry
+     * @param[out] error string containing error description, empty at the end of the snapshot
+     *
+     * @return true if an entry has been read
+     */
+    bool next(Entry &entry, std::string &error);
+
+private:
+    AlsaSnapshotReader(const AlsaSnapshotReader &);
+    AlsaSnapshotReader &operator=(const AlsaSnapshotReader &);
+
+    void close();
+
+    /** Mapped file */
+    const uint8_t *_data;
+    size_t _size;
+    /** Offset of the next entry */
+    size_t _offset;
+    /** Number of entries left */
+    uint32_t _remainingEntries;
+};
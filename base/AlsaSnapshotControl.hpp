@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AlsaSubsystemObject.hpp"
+#include "AlsaMappingKeys.hpp"
+#include "AmixerCardSnapshot.hpp"
+#include "InstanceConfigurableElement.h"
+#include "MappingContext.h"
+#include <string.h>
+#include <string>
+
+/**
+ * Snapshot of the mapped controls of a card.
+ *
+ * The mapping value is the path of the snapshot file, amends being supported. The mapped element
+ * is an integer parameter acting as a command: writing 1 stores the current values of all the
+ * controls of the card mapped in the subsystem, writing 2 restores them. Any other value is
+ * ignored, and the parameter always reads back as 0.
+ */
+template <class Backend>
+class AlsaSnapshotControl : public AlsaSubsystemObject
+{
+public:
+    /**
+     * AlsaSnapshotControl Class constructor
+     *
+     * @param[in] mappingValue instantiation mapping value
+     * @param[in] instanceConfigurableElement pointer to configurable element instance
+     * @param[in] context contains the context mappings
+     */
+    AlsaSnapshotControl(const std::string &mappingValue,
+                        CInstanceConfigurableElement *instanceConfigurableElement,
+                        const CMappingContext &context,
+                        core::log::Logger& logger)
+        : AlsaSubsystemObject(mappingValue, instanceConfigurableElement, logger,
+                              AlsaAmend1, gNbAlsaAmends, context),
+          _isTypeSupported((instanceConfigurableElement->getType() ==
+                            CInstanceConfigurableElement::EParameter) &&
+                           (instanceConfigurableElement->getFootPrint() <= sizeof(uint32_t)))
+    {
+    }
+
+protected:
+    virtual bool accessHW(bool receive, std::string &error);
+
+private:
+    /** Commands of the mapped parameter */
+    enum Command
+    {
+        None = 0,
+        Store,
+        Restore
+    };
+
+    /** Delayed error about supported parameter types */
+    bool _isTypeSupported;
+};
+
+template <class Backend>
+bool AlsaSnapshotControl<Backend>::accessHW(bool receive, std::string &error)
+{
+    if (!_isTypeSupported) {
+
+        error = "Parameter type not supported.";
+        return false;
+    }
+    if (receive) {
+
+        memset(getBlackboardLocation(), 0, getSize());
+        return true;
+    }
+    uint32_t command = 0;
+
+    blackboardRead(&command, getSize());
+
+    const std::string path = getFormattedMappingValue();
+    AlsaDescriptorPool &pool = getDescriptorPool();
+    uint32_t restoredCount;
+
+    switch (command) {
+    case Store:
+        if (!AmixerCardSnapshot<Backend>::store(getSubsystem(), getCard(),
+                                                pool.getControls(getCard()), path, error)) {
+
+            return false;
+        }
+        info() << "Stored " << pool.getControls(getCard()).size() << " controls of card "
+               << getCardName() << " in " << path;
+        return true;
+
+    case Restore:
+        if (!AmixerCardSnapshot<Backend>::restore(getSubsystem(), getCard(), path,
+                                                  restoredCount, error)) {
+
+            return false;
+        }
+        info() << "Restored " << restoredCount << " controls of card " << getCardName()
+               << " from " << path;
+        return true;
+
+    default:
+        return true;
+    }
+}
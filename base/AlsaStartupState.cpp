@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "AlsaStartupState.hpp"
+#include "AlsaCardFingerprint.hpp"
+
+void AlsaStartupState::addCard(const AlsaCardDescriptor &card, const std::string &directory)
+{
+    if (_cards.find(&card) == _cards.end()) {
+
+        CardState &state = _cards[&card];
+
+        state.path = getPath(card, directory);
+        state.isLoaded = false;
+    }
+}
+
+AlsaStartupState::PathMap AlsaStartupState::getPaths() const
+{
+    PathMap paths;
+    std::map<const AlsaCardDescriptor *, CardState>::const_iterator it;
+
+    for (it = _cards.begin(); it != _cards.end(); ++it) {
+
+        paths[it->first] = it->second.path;
+    }
+    return paths;
+}
+
+const AlsaSnapshotReader::Entry *AlsaStartupState::find(const AlsaCardDescriptor &card,
+                                                        const std::string &controlName)
+{
+    std::map<const AlsaCardDescriptor *, CardState>::iterator cardIt = _cards.find(&card);
+
+    if (cardIt == _cards.end()) {
+
+        return NULL;
+    }
+    CardState &state = cardIt->second;
+
+    if (!state.isLoaded) {
+
+        load(card, state);
+    }
+    EntryMap::const_iterator it = state.entries.find(&controlName);
+
+    return it != state.entries.end() ? &it->second : NULL;
+}
+
+void AlsaStartupState::load(const AlsaCardDescriptor &card, CardState &state)
+{
+    state.isLoaded = true;
+
+    std::unique_ptr<AlsaSnapshotReader> snapshot(new AlsaSnapshotReader);
+    uint64_t fingerprint;
+    std::string error;
+
+    // A missing or stale state is not an error: controls are read from the hardware
+    if ((card.index < 0) || !snapshot->open(state.path, error) ||
+        !AlsaCardFingerprint::compute(card.index, fingerprint, error) ||
+        (snapshot->getFingerprint() != fingerprint)) {
+
+        return;
+    }
+    AlsaSnapshotReader::Entry entry;
+
+    while (snapshot->next(entry, error)) {
+
+        // Only the names of mapped controls are interned
+        const std::string *controlName = _pool.findControlName(entry.controlName);
+
+        if (controlName != NULL) {
+
+            state.entries[controlName] = entry;
+        }
+    }
+    if (!error.empty()) {
+
+        // Corrupted state: trust none of it
+        state.entries.clear();
+        return;
+    }
+    state.snapshot = std::move(snapshot);
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AlsaDescriptorPool.hpp"
+#include "AlsaSnapshot.hpp"
+#include <stdint.h>
+#include <string>
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+/**
+ * Control values saved at last shutdown, answering the initial reads of the controls.
+ *
+ * The state of a card is loaded on first use and only trusted if the card fingerprint still
+ * matches the one saved along with it. Controls without a valid entry are read from the hardware.
+ */
+class AlsaStartupState
+{
+public:
+    /**
+     * AlsaStartupState Class constructor
+     *
+     * @param[in] pool the descriptor pool interning the control names
+     */
+    AlsaStartupState(AlsaDescriptorPool &pool) : _pool(pool), _cards() {}
+
+    /**
+     * Enable the startup state of a card
+     *
+     * @param[in] card the card descriptor
+     * @param[in] directory directory of the state files, one per card
+     */
+    void addCard(const AlsaCardDescriptor &card, const std::string &directory);
+
+    /**
+     * Find the saved values of a control
+     *
+     * @param[in] card the card descriptor
+     * @param[in] controlName the interned control name
+     *
+     * @return the saved entry, NULL if there is no valid one
+     */
+    const AlsaSnapshotReader::Entry *find(const AlsaCardDescriptor &card,
+                                          const std::string &controlName);
+
+    /** Paths of the state files, by card */
+    typedef std::map<const AlsaCardDescriptor *, std::string> PathMap;
+
+    /**
+     * Get the cards of which the state is to be saved at shutdown
+     *
+     * @return the state file path of each card
+     */
+    PathMap getPaths() const;
+
+    /**
+     * Get the state file path of a card
+     *
+     * @param[in] card the card descriptor
+     * @param[in] directory directory of the state files
+     *
+     * @return the state file path
+     */
+    static std::string getPath(const AlsaCardDescriptor &card, const std::string &directory)
+    {
+        return directory + "/" + card.name + ".state";
+    }
+
+private:
+    typedef std::unordered_map<const std::string *, AlsaSnapshotReader::Entry> EntryMap;
+
+    /** Startup state of a card */
+    struct CardState
+    {
+        std::string path;
+        /** False until the first lookup */
+        bool isLoaded;
+        /** Mapped state file, kept for the entries pointing into it */
+        std::unique_ptr<AlsaSnapshotReader> snapshot;
+        /** Valid entries, by interned control name */
+        EntryMap entries;
+    };
+
+    /**
+     * Load the state file of a card, dropping it if stale
+     *
+     * @param[in] card the card descriptor
+     * @param[in] state the state of the card
+     */
+    void load(const AlsaCardDescriptor &card, CardState &state);
+
+    AlsaDescriptorPool &_pool;
+    std::map<const AlsaCardDescriptor *, CardState> _cards;
+};
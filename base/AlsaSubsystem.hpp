@@ -30,19 +30,38 @@
 #pragma once
 
 #include "Subsystem.h"
+#include "AmixerRampEngine.hpp"
+#include "AlsaDescriptorPool.hpp"
+#include "AlsaHotplugMonitor.hpp"
+#include "AlsaEventMonitor.hpp"
+#include "AlsaStartupState.hpp"
+#include "AlsaResolutionCache.hpp"
+#include "AlsaTrafficLog.hpp"
+#include "AlsaMirror.hpp"
+#include "AmixerCardSnapshot.hpp"
 #include <string>
+#include <functional>
+#include <vector>
+
+class CMappingContext;
 
 /**
  * Base class for Alsa subsystems.
  *
- * It only defines which context mapping keys are to be supported by such
- * plugins.
+ * It defines which context mapping keys are to be supported by such
+ * plugins, and holds the state shared by their objects.
  */
 class AlsaSubsystem : public CSubsystem
 {
 public:
-    AlsaSubsystem(const std::string &name, core::log::Logger& logger) : CSubsystem(name, logger)
+    AlsaSubsystem(const std::string &name, core::log::Logger& logger)
+        : CSubsystem(name, logger), _logger(logger), _isMirrorListening(false),
+          _startupState(_descriptorPool), _resolutionCache(_descriptorPool),
+          _hotplugMonitor(_descriptorPool)
     {
+        // Event subscriptions follow the cards
+        _hotplugMonitor.setRebindListener(std::bind(&AlsaEventMonitor::rebind, &_eventMonitor));
+
         // Provide mapping keys to upper layer
         addContextMappingKey("Card");
         addContextMappingKey("Debug");
@@ -51,5 +70,205 @@ public:
         addContextMappingKey("Amend2");
         addContextMappingKey("Amend3");
         addContextMappingKey("Amend4");
+        addContextMappingKey("Ramp");
+        addContextMappingKey("State");
+        addContextMappingKey("Resync");
+        addContextMappingKey("Events");
+        addContextMappingKey("Record");
+        addContextMappingKey("KeepAlive");
+        addContextMappingKey("Access");
+        addContextMappingKey("SlowAccess");
+        addContextMappingKey("Mirror");
+        addContextMappingKey("Broker");
+        addContextMappingKey("Resolution");
+    }
+
+    virtual ~AlsaSubsystem()
+    {
+        // Resolutions are saved through the control devices, not through the backends
+        std::vector<const AlsaCardDescriptor *> cards = _resolutionCache.getModifiedCards();
+
+        for (size_t index = 0; index < cards.size(); index++) {
+
+            std::string error;
+
+            if (!_resolutionCache.store(*cards[index], error)) {
+
+                _logger.warning() << "Unable to save the control resolutions of card "
+                                  << cards[index]->name << ": " << error;
+            }
+        }
+    }
+
+    /**
+     * Check whether the subsystem needs to be resynchronized
+     * It does when a card enabling it arrived, so that the pending state is replayed on it.
+     *
+     * @param[in] clear true to acknowledge the resynchronization
+     *
+     * @return true if the subsystem needs to be resynchronized
+     */
+    virtual bool needResync(bool clear)
+    {
+        // Both are cleared, when required
+        bool isCardArrived = _hotplugMonitor.isResyncNeeded(clear);
+
+        return CSubsystem::needResync(clear) || isCardArrived;
+    }
+
+    /**
+     * Get the volume ramp engine
+     *
+     * @return the engine running the volume ramps of the subsystem controls
+     */
+    AmixerRampEngine &getRampEngine() { return _rampEngine; }
+
+    /**
+     * Get the descriptor pool
+     *
+     * @return the card and control name descriptors shared by the subsystem objects
+     */
+    AlsaDescriptorPool &getDescriptorPool() { return _descriptorPool; }
+
+    /**
+     * Get the startup state
+     *
+     * @return the control values saved at last shutdown
+     */
+    AlsaStartupState &getStartupState() { return _startupState; }
+
+    /**
+     * Get the resolution cache
+     *
+     * @return the control resolutions saved at last shutdown, and those looked up since
+     */
+    AlsaResolutionCache &getResolutionCache() { return _resolutionCache; }
+
+    /**
+     * Get the control event monitor
+     *
+     * @return the monitor of the control changes made behind the subsystem's back
+     */
+    AlsaEventMonitor &getEventMonitor() { return _eventMonitor; }
+
+    /**
+     * Get the traffic recorder
+     *
+     * @return the recorder of the hardware accesses, recording once opened
+     */
+    AlsaTrafficRecorder &getTrafficRecorder() { return _trafficRecorder; }
+
+    /**
+     * Start rebinding the cards on hotplug, if not done yet
+     * A failure is only reported once.
+     *
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool startHotplugMonitor(std::string &error) { return _hotplugMonitor.start(error); }
+
+    /**
+     * Get the shared memory mirror
+     *
+     * @return the mirror of the control values, publishing once opened
+     */
+    AlsaMirror &getMirror() { return _mirror; }
+
+    /**
+     * Publish the control values into a shared memory mirror, if not done yet
+     * Control events are published along with the accesses.
+     *
+     * @param[in] name name of the shared memory segment
+     * @param[out] error string containing error description
+     *
+     * @return true if the mirror is opened
+     */
+    bool openMirror(const std::string &name, std::string &error)
+    {
+        if (!_mirror.open(name, error)) {
+
+            return false;
+        }
+        if (!_isMirrorListening) {
+
+            _isMirrorListening = true;
+            _eventMonitor.addChangeListener(std::bind(&AlsaMirror::publishChange, &_mirror,
+                                                      std::placeholders::_1));
+        }
+        return true;
     }
+
+    /**
+     * Prepare the access to a card an object is bound to, ahead of its first access
+     * Called while the structure is being loaded, once per object.
+     *
+     * @param[in] card the card descriptor
+     * @param[in] context contains the context mappings of the object
+     */
+    virtual void prepareCard(const AlsaCardDescriptor &/*card*/,
+                             const CMappingContext &/*context*/) {}
+
+protected:
+    /**
+     * Stop the running volume ramps
+     * To be called by backends before releasing the resources ramp writers rely on.
+     */
+    void stopRamps() { _rampEngine.stop(); }
+
+    /**
+     * Stop the volume ramps of a card
+     * To be called by backends before releasing the handles of a rebound card.
+     *
+     * @param[in] cardIndex index of the card
+     */
+    void stopRamps(int32_t cardIndex) { _rampEngine.stop(cardIndex); }
+
+    /**
+     * Save the startup state of the cards it is enabled on
+     * To be called by backends on destruction, while the controls are still accessible.
+     */
+    template <class Backend>
+    void storeStartupState();
+
+private:
+    core::log::Logger &_logger;
+    /** Hardware accesses log, flushed on destruction */
+    AlsaTrafficRecorder _trafficRecorder;
+    /** Control values shared with other processes, outlives the event monitor publishing */
+    AlsaMirror _mirror;
+    /** The mirror listens to the control changes */
+    bool _isMirrorListening;
+    /** Volume ramps of the subsystem controls */
+    AmixerRampEngine _rampEngine;
+    /** Interned card and control name descriptors */
+    AlsaDescriptorPool _descriptorPool;
+    /** Control values saved at last shutdown */
+    AlsaStartupState _startupState;
+    /** Control resolutions, saved on destruction */
+    AlsaResolutionCache _resolutionCache;
+    /** Control changes, relies on the card descriptors */
+    AlsaEventMonitor _eventMonitor;
+    /** Rebinds the card descriptors, stopped before they and the event monitor are released */
+    AlsaHotplugMonitor _hotplugMonitor;
 };
+
+template <class Backend>
+void AlsaSubsystem::storeStartupState()
+{
+    AlsaStartupState::PathMap paths = _startupState.getPaths();
+    AlsaStartupState::PathMap::const_iterator it;
+
+    for (it = paths.begin(); it != paths.end(); ++it) {
+
+        const AlsaCardDescriptor &card = *it->first;
+        std::string error;
+
+        if (!AmixerCardSnapshot<Backend>::store(this, card, _descriptorPool.getControls(card),
+                                                it->second, error)) {
+
+            _logger.warning() << "Unable to save the startup state of card " << card.name
+                              << ": " << error;
+        }
+    }
+}
@@ -28,31 +28,25 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 #include "AlsaSubsystemObject.hpp"
+#include "AlsaSubsystem.hpp"
 #include "MappingContext.h"
 #include "AlsaMappingKeys.hpp"
-#include <convert.hpp>
-
-#include <limits.h>
-#include <unistd.h>
-#include <errno.h>
-#include <string.h>
 #include <string>
 
 using std::string;
 
 #define base CFormattedSubsystemObject
 
-const char AlsaSubsystemObject::_soundCardPath[] = "/proc/asound/";
-
 AlsaSubsystemObject::AlsaSubsystemObject(const string &mappingValue,
                                          CInstanceConfigurableElement *instanceConfigurableElement,
                                          const CMappingContext &context,
                                          core::log::Logger& logger)
     : base(instanceConfigurableElement, logger, mappingValue),
-      _cardName(context.getItem(AlsaCard)),
-      _cardIndex(getCardNumberByName(context.getItem(AlsaCard)))
+      _card(&getDescriptorPool().getCard(getCardNames(context).front())),
+      _trafficRecorder(NULL)
 {
-
+    bindCard(context);
+    enableRecording(context);
 }
 
 AlsaSubsystemObject::AlsaSubsystemObject(const string &mappingValue,
@@ -62,40 +56,68 @@ AlsaSubsystemObject::AlsaSubsystemObject(const string &mappingValue,
                                          uint32_t nbAmendKeys,
                                          const CMappingContext &context)
     : base(instanceConfigurableElement, logger, mappingValue, firstAmendKey, nbAmendKeys, context),
-      _cardName(context.getItem(AlsaCard)),
-      _cardIndex(getCardNumberByName(context.getItem(AlsaCard)))
+      _card(&getDescriptorPool().getCard(getCardNames(context).front())),
+      _trafficRecorder(NULL)
 {
-
+    bindCard(context);
+    enableRecording(context);
 }
-int32_t AlsaSubsystemObject::getCardNumberByName(const string &cardName)
-{
-    string idFilePath;
-    char numberFilepath[PATH_MAX] = "";
-    ssize_t writtenSize;
 
-    // Compute card path (Example: /proc/asound/cloverviewaudio)
-    idFilePath = string(_soundCardPath) + cardName;
+void AlsaSubsystemObject::bindCard(const CMappingContext &context)
+{
+    std::string error;
 
-    // Read corresponding link (Example: card5)
-    writtenSize = readlink(idFilePath.c_str(), numberFilepath, sizeof(numberFilepath));
+    if (context.iSet(AlsaResyncOnArrival)) {
 
-    if (writtenSize < 0) {
+        getDescriptorPool().enableResync(*_card);
+    }
+    getAlsaSubsystem().prepareCard(*_card, context);
+    if (!getAlsaSubsystem().startHotplugMonitor(error)) {
 
-        // Sound card does not exist
-        return -errno;
+        warning() << "Cards will not be rebound on hotplug: " << error;
     }
+}
+
+void AlsaSubsystemObject::enableRecording(const CMappingContext &context)
+{
+    std::string error;
+
+    if (!context.iSet(AlsaRecordFile)) {
 
-    if (static_cast<size_t>(writtenSize) >= sizeof(numberFilepath)) {
+        return;
+    }
+    if (!getAlsaSubsystem().getTrafficRecorder().open(context.getItem(AlsaRecordFile), error)) {
 
-        // buffer too small
-        return -ENAMETOOLONG;
+        warning() << "Hardware accesses will not be recorded: " << error;
+        return;
     }
+    _trafficRecorder = &getAlsaSubsystem().getTrafficRecorder();
+}
+
+std::vector<std::string> AlsaSubsystemObject::getCardNames(const CMappingContext &context)
+{
+    const std::string &cardList = context.getItem(AlsaCard);
+    std::vector<std::string> cardNames;
+    size_t start = 0;
+    size_t end;
+
+    while ((end = cardList.find(_cardSeparator, start)) != std::string::npos) {
 
-    // Extract card number from link (Example: 5 from card5)
-    int32_t cardNumber = 0;
-    if (convertTo(numberFilepath + strlen("card"), cardNumber)) {
-        return cardNumber;
+        cardNames.push_back(cardList.substr(start, end - start));
+        start = end + 1;
     }
+    cardNames.push_back(cardList.substr(start));
 
-    return -1; // A negative value indicates a failure
+    return cardNames;
+}
+
+AlsaSubsystem &AlsaSubsystemObject::getAlsaSubsystem() const
+{
+    // The subsystem state is shared by all the objects: forcefully remove its constness
+    return *const_cast<AlsaSubsystem *>(static_cast<const AlsaSubsystem *>(getSubsystem()));
+}
+
+AlsaDescriptorPool &AlsaSubsystemObject::getDescriptorPool() const
+{
+    return getAlsaSubsystem().getDescriptorPool();
 }
@@ -30,8 +30,13 @@
 #pragma once
 
 #include "FormattedSubsystemObject.h"
+#include "AlsaDescriptorPool.hpp"
 #include <stdint.h>
 #include <string>
+#include <vector>
+
+class AlsaSubsystem;
+class AlsaTrafficRecorder;
 
 /**
  * Alsa subsystem object class.
@@ -54,32 +59,77 @@ public:
 protected:
     /**
      * Get card number
+     * It changes when the card is rebound on hotplug, and must be read on each access.
      *
      * @return the number of the alsa card
      */
-    int32_t getCardNumber() const { return _cardIndex; }
+    int32_t getCardNumber() const { return _card->index; }
 
     /**
      * Get card name
      *
      * @return the name of the alsa card
      */
-    const std::string &getCardName() const { return _cardName; }
+    const std::string &getCardName() const { return _card->name; }
+
+    /**
+     * Get card descriptor
+     *
+     * @return the descriptor of the alsa card, shared by the objects of the card
+     */
+    const AlsaCardDescriptor &getCard() const { return *_card; }
+
+    /**
+     * Get the descriptors shared by the objects of the subsystem
+     *
+     * @return the descriptor pool of the subsystem
+     */
+    AlsaDescriptorPool &getDescriptorPool() const;
+
+    /**
+     * Get the alsa subsystem the object belongs to
+     *
+     * @return the subsystem, the state it holds being shared by all its objects
+     */
+    AlsaSubsystem &getAlsaSubsystem() const;
+
+    /**
+     * Get the recorder of the hardware accesses
+     *
+     * @return the recorder if the accesses of the object are recorded, NULL otherwise
+     */
+    AlsaTrafficRecorder *getTrafficRecorder() const { return _trafficRecorder; }
+
+    /**
+     * Get the cards given by the Card mapping key, as a list of names separated by '|'
+     * Objects are bound to the first one, only fan-out controls use the others.
+     *
+     * @param[in] context contains the context mappings
+     *
+     * @return the card names, at least one
+     */
+    static std::vector<std::string> getCardNames(const CMappingContext &context);
 
 private:
     /**
-     * This function return the card number associated with the card ID (name) passed as argument
+     * Track the arrival and removal of the card
      *
-     * @param[in] cardName an alsa card name
+     * @param[in] context contains the context mappings
+     */
+    void bindCard(const CMappingContext &context);
+
+    /**
+     * Record the hardware accesses, if enabled
      *
-     * @return the number of the corresponding alsa card
+     * @param[in] context contains the context mappings
      */
-    static int getCardNumberByName(const std::string &cardName);
+    void enableRecording(const CMappingContext &context);
+
+    /** Separator of the card names in the Card mapping key */
+    static const char _cardSeparator = '|';
 
-    /** Path of the sound card in the file system */
-    static const char _soundCardPath[];
-    /** Card name to which the Alsa device belong */
-    std::string _cardName;
-    /** Card Index to which the Alsa device belong */
-    int32_t _cardIndex;
+    /** Card to which the Alsa device belong, shared with the other objects of the card */
+    const AlsaCardDescriptor *_card;
+    /** Recorder of the hardware accesses, NULL if they are not recorded */
+    AlsaTrafficRecorder *_trafficRecorder;
 };
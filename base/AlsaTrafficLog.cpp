@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "AlsaTrafficLog.hpp"
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+
+/** Log file header */
+struct TrafficHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+};
+
+/** Record header, followed by the payload */
+struct TrafficRecord
+{
+    uint64_t timestamp;
+    uint32_t duration;
+    uint32_t payloadSize;
+    uint16_t cardId;
+    uint16_t nameId;
+    uint8_t operation;
+    uint8_t type;
+    uint8_t isSuccessful;
+    uint8_t reserved;
+    /** Number of elements, or device number of PortConfig */
+    uint32_t count;
+} __attribute__((packed));
+
+const char gTrafficMagic[8] = "PFWTRAF";
+const uint32_t gTrafficVersion = 1;
+
+/** Identifier of records without card or name */
+const uint16_t gNoString = 0xffff;
+
+} // namespace
+
+uint64_t AlsaTrafficRecorder::now()
+{
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return static_cast<uint64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+AlsaTrafficRecorder::AlsaTrafficRecorder()
+    : _lock(), _fd(-1), _path(), _origin(0), _buffer(), _stringIds(), _values()
+{
+}
+
+AlsaTrafficRecorder::~AlsaTrafficRecorder()
+{
+    if (_fd >= 0) {
+
+        flush();
+        close(_fd);
+    }
+}
+
+bool AlsaTrafficRecorder::open(const std::string &path, std::string &error)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    if (_fd >= 0) {
+
+        if (path != _path) {
+
+            error = "Already recording into " + _path;
+            return false;
+        }
+        return true;
+    }
+    _fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+    if (_fd < 0) {
+
+        error = "Unable to create " + path + ": " + strerror(errno);
+        return false;
+    }
+    _path = path;
+    _origin = now();
+    _buffer.reserve(_flushSize);
+
+    TrafficHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, gTrafficMagic, sizeof(header.magic));
+    header.version = gTrafficVersion;
+
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(&header);
+    _buffer.insert(_buffer.end(), data, data + sizeof(header));
+
+    return true;
+}
+
+void AlsaTrafficRecorder::recordControl(const std::string &card, const std::string &controlName,
+                                        bool receive, AmixerElementType type,
+                                        const long *values, const void *bytes, uint32_t count,
+                                        uint64_t start, bool isSuccessful)
+{
+    uint64_t end = now();
+    std::lock_guard<std::mutex> guard(_lock);
+
+    if (_fd < 0) {
+
+        return;
+    }
+    const void *payload = bytes;
+    uint32_t payloadSize = (bytes != NULL) ? count : 0;
+
+    if (values != NULL) {
+
+        _values.assign(values, values + count);
+        payload = _values.data();
+        payloadSize = count * sizeof(int64_t);
+
+    } else if (bytes == NULL) {
+
+        count = 0;
+    }
+    append(receive ? AlsaTrafficControlRead : AlsaTrafficControlWrite, getStringId(card),
+           getStringId(controlName), type, count, start, end, isSuccessful, payload,
+           payloadSize);
+}
+
+void AlsaTrafficRecorder::recordPortConfig(const std::string &card, uint32_t device,
+                                           const void *portConfig, uint32_t size,
+                                           uint64_t start, bool isSuccessful)
+{
+    uint64_t end = now();
+    std::lock_guard<std::mutex> guard(_lock);
+
+    if (_fd < 0) {
+
+        return;
+    }
+    append(AlsaTrafficPortConfigWrite, getStringId(card), gNoString, AmixerElementBytes, device,
+           start, end, isSuccessful, portConfig, size);
+}
+
+uint16_t AlsaTrafficRecorder::getStringId(const std::string &name)
+{
+    std::map<std::string, uint16_t>::const_iterator it = _stringIds.find(name);
+
+    if (it != _stringIds.end()) {
+
+        return it->second;
+    }
+    // Identifiers are never reused: past the last one, names are no longer recorded
+    if (_stringIds.size() >= gNoString) {
+
+        return gNoString;
+    }
+    uint16_t id = _stringIds.size();
+
+    _stringIds[name] = id;
+    append(AlsaTrafficStringDefinition, gNoString, id, AmixerElementUnknown, 0, _origin, _origin,
+           true, name.data(), name.size());
+
+    return id;
+}
+
+void AlsaTrafficRecorder::append(AlsaTrafficOperation operation, uint16_t cardId,
+                                 uint16_t nameId, uint8_t type, uint32_t count, uint64_t start,
+                                 uint64_t end, bool isSuccessful, const void *payload,
+                                 uint32_t payloadSize)
+{
+    TrafficRecord record;
+
+    record.timestamp = start - _origin;
+    record.duration = end - start;
+    record.payloadSize = payloadSize;
+    record.cardId = cardId;
+    record.nameId = nameId;
+    record.operation = operation;
+    record.type = type;
+    record.isSuccessful = isSuccessful;
+    record.reserved = 0;
+    record.count = count;
+
+    const uint8_t *header = reinterpret_cast<const uint8_t *>(&record);
+    const uint8_t *data = static_cast<const uint8_t *>(payload);
+
+    _buffer.insert(_buffer.end(), header, header + sizeof(record));
+    _buffer.insert(_buffer.end(), data, data + payloadSize);
+
+    if (_buffer.size() >= _flushSize) {
+
+        flush();
+    }
+}
+
+void AlsaTrafficRecorder::flush()
+{
+    const uint8_t *data = _buffer.data();
+    size_t size = _buffer.size();
+
+    while (size != 0) {
+
+        ssize_t written = write(_fd, data, size);
+
+        if (written < 0) {
+
+            if (errno == EINTR) {
+
+                continue;
+            }
+            // Nothing to report the error to: the log is truncated
+            break;
+        }
+        data += written;
+        size -= written;
+    }
+    _buffer.clear();
+}
+
+AlsaTrafficReader::AlsaTrafficReader() : _data(), _offset(0), _strings()
+{
+}
+
+bool AlsaTrafficReader::open(const std::string &path, std::string &error)
+{
+    std::ifstream file(path.c_str(), std::ios::binary);
+
+    if (!file) {
+
+        error = "Unable to open " + path;
+        return false;
+    }
+    _data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    _strings.clear();
+
+    TrafficHeader header;
+
+    if (_data.size() < sizeof(header)) {
+
+        error = path + " is not a traffic log";
+        return false;
+    }
+    memcpy(&header, _data.data(), sizeof(header));
+
+    if (memcmp(header.magic, gTrafficMagic, sizeof(header.magic)) != 0) {
+
+        error = path + " is not a traffic log";
+        return false;
+    }
+    if (header.version != gTrafficVersion) {
+
+        error = path + ": unsupported traffic log version " + std::to_string(header.version);
+        return false;
+    }
+    _offset = sizeof(header);
+
+    return true;
+}
+
+bool AlsaTrafficReader::next(Record &record, std::string &error)
+{
+    error.clear();
+
+    while (_offset < _data.size()) {
+
+        TrafficRecord header;
+
+        // Never trust the file: check the record fits before looking into it
+        if (_data.size() - _offset < sizeof(header)) {
+
+            error = "Truncated traffic log";
+            return false;
+        }
+        memcpy(&header, &_data[_offset], sizeof(header));
+
+        if (header.payloadSize > _data.size() - _offset - sizeof(header)) {
+
+            error = "Truncated traffic log";
+            return false;
+        }
+        const uint8_t *payload = &_data[_offset] + sizeof(header);
+        _offset += sizeof(header) + header.payloadSize;
+
+        if (header.operation == AlsaTrafficStringDefinition) {
+
+            _strings[header.nameId].assign(reinterpret_cast<const char *>(payload),
+                                           header.payloadSize);
+            continue;
+        }
+        if ((header.operation > AlsaTrafficPortConfigWrite) ||
+            (header.type > AmixerElementUnknown)) {
+
+            error = "Corrupted traffic log record";
+            return false;
+        }
+        record.operation = static_cast<AlsaTrafficOperation>(header.operation);
+        record.timestamp = header.timestamp;
+        record.duration = header.duration;
+        record.card = _strings[header.cardId];
+        record.type = static_cast<AmixerElementType>(header.type);
+        record.isSuccessful = header.isSuccessful != 0;
+        record.values.clear();
+        record.bytes.clear();
+
+        if (record.operation == AlsaTrafficPortConfigWrite) {
+
+            record.controlName.clear();
+            record.device = header.count;
+            record.bytes.assign(payload, payload + header.payloadSize);
+            return true;
+        }
+        record.controlName = _strings[header.nameId];
+        record.device = 0;
+
+        if (record.type == AmixerElementBytes) {
+
+            record.bytes.assign(payload, payload + header.payloadSize);
+
+        } else if (header.payloadSize == header.count * sizeof(int64_t)) {
+
+            record.values.resize(header.count);
+            memcpy(record.values.data(), payload, header.payloadSize);
+
+        } else {
+
+            error = "Corrupted traffic log record";
+            return false;
+        }
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AmixerElementType.hpp"
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+
+/**
+ * Binary log of the hardware accesses of a subsystem, to replay production traffic offline.
+ *
+ * The file is made of a header followed by records, in native endianness and unaligned:
+ *  - header: magic, format version
+ *  - record: timestamp and duration in ns, payload size, card and name identifiers, operation,
+ *    element type, status and value count (device number for PortConfig), followed by the
+ *    payload. Values are 64 bits integers, or raw bytes for BYTES controls and PortConfig.
+ * Card and control names are only written once, in a string record defining their identifier
+ * before the first record using it.
+ */
+enum AlsaTrafficOperation
+{
+    AlsaTrafficControlRead,
+    AlsaTrafficControlWrite,
+    AlsaTrafficPortConfigWrite,
+    /** Definition of a card or control name, not returned by the reader */
+    AlsaTrafficStringDefinition
+};
+
+/**
+ * Recorder of the hardware accesses, opt-in through the Record mapping key.
+ *
+ * Records are buffered and written in batches. Recording allocates and takes a lock: accesses
+ * of a recorded subsystem are not real-time safe.
+ */
+class AlsaTrafficRecorder
+{
+public:
+    AlsaTrafficRecorder();
+    ~AlsaTrafficRecorder();
+
+    /** @return the monotonic timestamp to give as the start of an access, in ns */
+    static uint64_t now();
+
+    /**
+     * Start recording into a file, if not recording yet
+     * A subsystem records into a single file: enabling another one is an error.
+     *
+     * @param[in] path path of the log file, truncated
+     * @param[out] error string containing error description
+     *
+     * @return true if recording into the file
+     */
+    bool open(const std::string &path, std::string &error);
+
+    /**
+     * Record a control access
+     *
+     * @param[in] card name of the card
+     * @param[in] controlName name of the control
+     * @param[in] receive is true for a read, false for a write
+     * @param[in] type element type of the control
+     * @param[in] values the element values, NULL for BYTES controls or if unknown
+     * @param[in] bytes the content of BYTES controls, NULL otherwise
+     * @param[in] count number of elements, or bytes
+     * @param[in] start timestamp of the start of the access
+     * @param[in] isSuccessful status of the access
+     */
+    void recordControl(const std::string &card, const std::string &controlName, bool receive,
+                       AmixerElementType type, const long *values, const void *bytes,
+                       uint32_t count, uint64_t start, bool isSuccessful);
+
+    /**
+     * Record a port configuration
+     *
+     * @param[in] card name of the card
+     * @param[in] device the alsa device number
+     * @param[in] portConfig the requested configuration, as laid out in the blackboard
+     * @param[in] size size of the configuration
+     * @param[in] start timestamp of the start of the configuration
+     * @param[in] isSuccessful status of the configuration
+     */
+    void recordPortConfig(const std::string &card, uint32_t device, const void *portConfig,
+                          uint32_t size, uint64_t start, bool isSuccessful);
+
+private:
+    AlsaTrafficRecorder(const AlsaTrafficRecorder &);
+    AlsaTrafficRecorder &operator=(const AlsaTrafficRecorder &);
+
+    /**
+     * Append a record to the buffer, flushed when full
+     * Called with the lock held.
+     */
+    void append(AlsaTrafficOperation operation, uint16_t cardId, uint16_t nameId,
+                uint8_t type, uint32_t count, uint64_t start, uint64_t end, bool isSuccessful,
+                const void *payload, uint32_t payloadSize);
+
+    /**
+     * Get the identifier of a name, defining it on first use
+     * Called with the lock held.
+     */
+    uint16_t getStringId(const std::string &name);
+
+    /** Write the buffered records, called with the lock held */
+    void flush();
+
+    /** Size of the buffer triggering a flush */
+    static const size_t _flushSize = 64 * 1024;
+
+    std::mutex _lock;
+    int _fd;
+    std::string _path;
+    /** Timestamp of the start of the recording, records are relative to it */
+    uint64_t _origin;
+    std::vector<uint8_t> _buffer;
+    std::map<std::string, uint16_t> _stringIds;
+    /** Element values converted to 64 bits */
+    std::vector<int64_t> _values;
+};
+
+/** Reader of logs written by AlsaTrafficRecorder */
+class AlsaTrafficReader
+{
+public:
+    /** Log record */
+    struct Record
+    {
+        AlsaTrafficOperation operation;
+        /** Time since the start of the recording, in ns */
+        uint64_t timestamp;
+        /** Duration of the access, in ns */
+        uint32_t duration;
+        std::string card;
+        /** Name of the control, empty for PortConfig */
+        std::string controlName;
+        /** Device number of PortConfig */
+        uint32_t device;
+        AmixerElementType type;
+        bool isSuccessful;
+        /** Element values, empty for BYTES controls and PortConfig */
+        std::vector<int64_t> values;
+        /** Content of BYTES controls and PortConfig, empty otherwise */
+        std::vector<uint8_t> bytes;
+    };
+
+    AlsaTrafficReader();
+
+    /**
+     * Load a log file and check its header
+     *
+     * @param[in] path path of the log file
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool open(const std::string &path, std::string &error);
+
+    /**
+     * Get the next record
+     *
+     * @param[out] record the record
+     * @param[out] error string containing error description, empty at the end of the log
+     *
+     * @return true if a record has been read
+     */
+    bool next(Record &record, std::string &error);
+
+private:
+    std::vector<uint8_t> _data;
+    /** Offset of the next record */
+    size_t _offset;
+    /** Names defined so far, by identifier */
+    std::map<uint16_t, std::string> _strings;
+};
@@ -0,0 +1,867 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AmixerControl.hpp"
+#include "AmixerElementType.hpp"
+#include "AmixerEnumItemTable.hpp"
+#include "AmixerDbScale.hpp"
+#include "AmixerRampEngine.hpp"
+#include "AlsaTrafficLog.hpp"
+#include "InstanceConfigurableElement.h"
+#include "MappingContext.h"
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/**
+ * Alsa mixer control, implemented once for all the backends.
+ *
+ * The Backend policy gives access to the controls of a card. It is a class providing:
+ *  - bool open(const CSubsystem *subsystem, const AlsaCardDescriptor &card, std::string &error)
+ *  - bool resolve(const std::string &controlName, std::string &error)
+ *  - void close(), the resolved control staying valid across close and open until the card is
+ *    rebound
+ *  - int32_t getCardIndex() const, index of the opened card
+ *  - AmixerElementType getType() const, uint32_t getCount() const
+ *  - uintptr_t getKey() const, identifying the control for the translation tables
+ *  - bool read(long *values, uint32_t count, std::string &error), and write(const long *, ...)
+ *  - bool readBytes(void *data, size_t size, std::string &error), and writeBytes(const void *, ...)
+ *  - uint32_t getItemCount() const, bool getItemName(uint32_t item, std::string &name, error)
+ *  - bool readDbTlv(unsigned int *tlv, size_t &tlvSize, long &min, long &max, error)
+ *  - AmixerRampWriter *createRampWriter(), handing the control over to the ramp engine
+ *  - uint32_t getIoctlCount() const, number of ioctls issued since the card was opened
+ * Error strings only describe the cause, the control name is added here.
+ *
+ * The Codec is AmixerControl or a mapping type derived from it (AmixerMutableVolume...). Its
+ * blackboard conversion functions and translation tables are not virtual: they are resolved at
+ * compile time, so that the element loops do not go through virtual calls. Mapping types
+ * converting all the elements in one pass provide fromBlackboardValues and toBlackboardValues.
+ *
+ * Once the translation tables are built, a successful access neither allocates nor blocks on a
+ * lock, so that writes can be issued from a real-time thread. Error strings are only built on
+ * failure, and logs only in debug mode. Ramped writes, the startup state, pending change
+ * events and recorded accesses are not covered, nor is the first access after the card is
+ * bound or rebound: resolving the control again may reload and fill the resolution cache.
+ *
+ * The access class of the control tells which reads reach the hardware: write-only controls are
+ * never read, and cacheable ones are answered from a copy of the blackboard taken after each
+ * successful access, until the card is rebound or the control changes behind our back.
+ *
+ * Values of successful accesses are published into the shared memory mirror, if enabled: ramps
+ * publish their target levels.
+ *
+ * When a SlowAccess threshold is set, the hardware accesses are timed phase by phase, and the
+ * ones exceeding the threshold are reported with their breakdown and ioctl count.
+ */
+template <class Backend, class Codec = AmixerControl>
+class AmixerBackendControl : public Codec
+{
+public:
+    /**
+     * AmixerBackendControl Class constructor
+     *
+     * @param[in] mappingValue instantiation mapping value
+     * @param[in] instanceConfigurableElement pointer to configurable element instance
+     * @param[in] context contains the context mappings
+     */
+    AmixerBackendControl(const std::string &mappingValue,
+                         CInstanceConfigurableElement *instanceConfigurableElement,
+                         const CMappingContext &context,
+                         core::log::Logger& logger)
+        : Codec(mappingValue, instanceConfigurableElement, context, logger), _backend(), _values(),
+          _cardGeneration(0), _cache(), _isCacheValid(false)
+    {
+        reserveValues();
+    }
+
+    /**
+     * AmixerBackendControl Class constructor
+     *
+     * @param[in] mappingValue instantiation mapping value
+     * @param[in] instanceConfigurableElement pointer to configurable element instance
+     * @param[in] context contains the context mappings
+     * @param[in] scalarSize used to force scalarSize value
+     */
+    AmixerBackendControl(const std::string &mappingValue,
+                         CInstanceConfigurableElement *instanceConfigurableElement,
+                         const CMappingContext &context,
+                         core::log::Logger& logger,
+                         uint32_t scalarSize)
+        : Codec(mappingValue, instanceConfigurableElement, context, logger, scalarSize),
+          _backend(),
+          _values(),
+          _cardGeneration(0),
+          _cache(),
+          _isCacheValid(false)
+    {
+        reserveValues();
+    }
+
+protected:
+    virtual bool accessHW(bool receive, std::string &error);
+
+private:
+    /** Size the element values and the cache once, so that accesses do not allocate */
+    void reserveValues()
+    {
+        _values.reserve(this->getBlackboardElementCount());
+
+        if (this->getAccessClass() == AmixerControl::AccessCacheable) {
+
+            _cache.resize(this->getSize());
+        }
+    }
+
+    /**
+     * Answer a read from the cache, if valid
+     *
+     * @return true if the read was answered
+     */
+    bool readCache();
+
+    /**
+     * Open the card and access the control
+     *
+     * @param[in] receive is true for a read, false for a write
+     * @param[out] isOpened set once the card is opened, the backend is then to be closed
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool accessCard(bool receive, bool &isOpened, std::string &error);
+
+    /**
+     * Access the control, once the card is opened
+     *
+     * @param[in] receive is true for a read, false for a write
+     * @param[in] controlName name of the control
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool accessControl(bool receive, const std::string &controlName, std::string &error);
+
+    /**
+     * Read the control from the startup state into the blackboard
+     *
+     * @return true if the startup state had a valid entry for the control
+     */
+    bool readStartupEntry();
+
+    /**
+     * Apply the changes made behind the subsystem's back: outdated tables are invalidated, and
+     * a read is answered from the last values
+     *
+     * @param[in] receive is true for a read, false for a write
+     *
+     * @return true if the read was answered
+     */
+    bool applyControlChange(bool receive);
+
+    /**
+     * Write values known without accessing the hardware into the blackboard
+     *
+     * @param[in] type element type of the control
+     * @param[in] count number of elements, or bytes
+     * @param[in] values the element values, for all the types but bytes
+     * @param[in] bytes the content of a bytes control
+     *
+     * @return true if the values fit the parameter and the mapping type
+     */
+    template <typename Value>
+    bool readKnownValues(AmixerElementType type, uint32_t count, const Value *values,
+                         const void *bytes);
+
+    /**
+     * Record a hardware access, along with the element values accessed
+     *
+     * @param[in] recorder the traffic recorder
+     * @param[in] receive is true for a read, false for a write
+     * @param[in] start timestamp of the start of the access
+     * @param[in] isSuccessful status of the access
+     */
+    void recordAccess(AlsaTrafficRecorder &recorder, bool receive, uint64_t start,
+                      bool isSuccessful);
+
+    /** Publish the values of the last successful access into the mirror, if enabled */
+    void publishAccess()
+    {
+        if (_backend.getType() == AmixerElementBytes) {
+
+            this->publishValues(AmixerElementBytes, NULL, this->getBlackboardLocation(),
+                                this->getSize());
+        } else {
+
+            this->publishValues(_backend.getType(), _values.data(), NULL, _values.size());
+        }
+    }
+
+    /**
+     * Read the element values from the blackboard, in one pass if the mapping type supports it
+     *
+     * @param[out] values the element values
+     * @param[in] count the number of elements
+     */
+    void convertFromBlackboard(long *values, uint32_t count)
+    {
+        if (this->fromBlackboardValues(values, count)) {
+
+            return;
+        }
+        for (uint32_t index = 0; index < count; index++) {
+
+            // Read data from blackboard (beware this code is OK on Little Endian machines only)
+            values[index] = this->fromBlackboard();
+        }
+    }
+
+    /**
+     * Write the element values to the blackboard, in one pass if the mapping type supports it
+     *
+     * @param[in] values the element values
+     * @param[in] count the number of elements
+     */
+    template <typename Value>
+    void convertToBlackboard(const Value *values, uint32_t count)
+    {
+        if (this->toBlackboardValues(values, count)) {
+
+            return;
+        }
+        for (uint32_t index = 0; index < count; index++) {
+
+            // Write data to blackboard (beware this code is OK on Little Endian machines only)
+            this->toBlackboard(values[index]);
+        }
+    }
+
+    /** Invalidate the translation tables of the mapping type, if any */
+    void invalidateTables();
+
+    /**
+     * Fill the item name table of the mapping type, if any and if outdated
+     *
+     * @param[in] controlName name of the control
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool updateEnumItemTable(const std::string &controlName, std::string &error);
+
+    /**
+     * Fill the dB scale of the mapping type, if any and if outdated
+     *
+     * @param[in] controlName name of the control
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool updateDbScale(const std::string &controlName, std::string &error);
+
+    /**
+     * Read all the element values of the control into the blackboard
+     *
+     * @param[in] controlName name of the control
+     * @param[in] elementCount number of elements of the control
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool readValues(const std::string &controlName, uint32_t elementCount, std::string &error);
+
+    /**
+     * Write all the element values of the control from the blackboard
+     *
+     * @param[in] controlName name of the control
+     * @param[in] elementCount number of elements of the control
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool writeValues(const std::string &controlName, uint32_t elementCount, std::string &error);
+
+    /**
+     * Hand a volume write over to the ramp engine
+     *
+     * @param[in] controlName name of the control
+     * @param[in] elementCount number of channels of the control
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool startRamp(const std::string &controlName, uint32_t elementCount, std::string &error);
+
+    /** Maximum size of a dB TLV, in 32 bits words */
+    static const size_t _maxDbTlvWords = 256;
+
+    /** Access to the controls of the card */
+    Backend _backend;
+    /** Element values of the control, kept across accesses */
+    std::vector<long> _values;
+    /** Generation of the card the translation tables were built for */
+    uint32_t _cardGeneration;
+    /** Blackboard content after the last successful access, for cacheable controls */
+    std::vector<uint8_t> _cache;
+    /** The cache matches the hardware */
+    bool _isCacheValid;
+};
+
+template <class Backend, class Codec>
+bool AmixerBackendControl<Backend, Codec>::accessHW(bool receive, std::string &error)
+{
+#ifdef SIMULATION
+    if (receive) {
+
+        memset(this->getBlackboardLocation(), 0, this->getSize());
+    }
+    this->logControlInfo(receive);
+
+    return true;
+#endif
+
+    // Debug conditionnaly enabled in XML
+    this->logControlInfo(receive);
+
+    // Check parameter type is ok (deferred error, no exceptions available :-()
+    if (!this->isTypeSupported()) {
+
+        error = "Parameter type not supported.";
+        return false;
+    }
+
+    // Write-only controls are never read back
+    if (receive && (this->getAccessClass() == AmixerControl::AccessWriteOnly)) {
+
+        if (this->isDebugEnabled()) {
+
+            this->info() << "Skipping read of write-only alsa element " << this->getControlName();
+        }
+        return true;
+    }
+
+    // The initial read is answered from the state saved at last shutdown, when still valid
+    if (receive && readStartupEntry()) {
+
+        return true;
+    }
+
+    // Reads following a change made behind the subsystem's back are answered from its event
+    if (applyControlChange(receive)) {
+
+        return true;
+    }
+
+    if (receive && readCache()) {
+
+        return true;
+    }
+
+    AlsaAccessTimer &timer = this->getAccessTimer();
+    bool isOpened = false;
+
+    timer.start();
+
+    bool success = accessCard(receive, isOpened, error);
+
+    // Failed card lookups and opens are reported as well, they are the slowest
+    if (timer.isEnabled()) {
+
+        if (isOpened) {
+
+            timer.addIoctls(_backend.getIoctlCount());
+        }
+        this->reportSlowAccess(receive);
+    }
+    if (isOpened) {
+
+        _backend.close();
+    }
+    return success;
+}
+
+template <class Backend, class Codec>
+bool AmixerBackendControl<Backend, Codec>::accessCard(bool receive, bool &isOpened,
+                                                      std::string &error)
+{
+    AlsaAccessTimer &timer = this->getAccessTimer();
+
+    // Generation first: a concurrent rebinding then at worst leads to a spurious table update
+    uint32_t cardGeneration = this->getCard().generation;
+    int32_t cardIndex = this->getCardNumber();
+    if (cardIndex < 0) {
+
+        error = "Card " + this->getCardName() + " not found. Error: " + strerror(-cardIndex);
+        return false;
+    }
+
+    // The controls of a rebound card may have changed
+    if (cardGeneration != _cardGeneration) {
+
+        invalidateTables();
+        _cardGeneration = cardGeneration;
+    }
+    timer.lap(AmixerControl::PhaseCardLookup);
+
+    if (!_backend.open(this->getSubsystem(), this->getCard(), error)) {
+
+        error = "ALSA: Unable to open card " + this->getCardName() + ": " + error;
+        return false;
+    }
+    isOpened = true;
+    timer.lap(AmixerControl::PhaseOpen);
+
+    AlsaTrafficRecorder *recorder = this->getTrafficRecorder();
+    uint64_t start = (recorder != NULL) ? AlsaTrafficRecorder::now() : 0;
+
+    bool success = accessControl(receive, this->getControlName(), error);
+
+    // Ramps are not over yet: the hardware will only match the blackboard at their end
+    if (!_cache.empty()) {
+
+        _isCacheValid = success && (this->getRampDuration() == 0);
+
+        if (_isCacheValid) {
+
+            memcpy(_cache.data(), this->getBlackboardLocation(), _cache.size());
+        }
+    }
+
+    if (recorder != NULL) {
+
+        recordAccess(*recorder, receive, start, success);
+    }
+    if (success) {
+
+        publishAccess();
+    }
+    return success;
+}
+
+template <class Backend, class Codec>
+bool AmixerBackendControl<Backend, Codec>::accessControl(bool receive,
+                                                         const std::string &controlName,
+                                                         std::string &error)
+{
+    if (!_backend.resolve(controlName, error)) {
+
+        error = "ALSA: Unable to get element info " + controlName + ": " + error;
+        return false;
+    }
+    this->getAccessTimer().lap(AmixerControl::PhaseResolve);
+
+    // Translation tables of enumerated items and dB levels, built once per control
+    if (!updateEnumItemTable(controlName, error) || !updateDbScale(controlName, error)) {
+
+        return false;
+    }
+    this->getAccessTimer().lap(AmixerControl::PhaseTables);
+
+    AmixerElementType type = _backend.getType();
+    uint32_t elementCount = _backend.getCount();
+
+    // For Bytes control force scalar size to 1 byte
+    uint32_t blackboardCount = (type == AmixerElementBytes) ? this->getSize()
+                                                            : this->getBlackboardElementCount();
+
+    // If size defined in the PFW different from alsa mixer control size, return an error
+    if (elementCount != blackboardCount) {
+
+        error = "ALSA: Control element count (" + std::to_string(elementCount) +
+                ") and configurable scalar element count (" +
+                std::to_string(blackboardCount) + ") mismatch";
+        return false;
+    }
+
+    switch (type) {
+    case AmixerElementBytes:
+        // Bytes go straight between the blackboard and the control
+        if (receive) {
+
+            if (!_backend.readBytes(this->getBlackboardLocation(), elementCount, error)) {
+
+                error = "ALSA: Unable to read element " + controlName + ": " + error;
+                return false;
+            }
+            this->getAccessTimer().lap(AmixerControl::PhaseTransfer);
+            this->logControlBytes(true, this->getBlackboardLocation(), elementCount);
+
+            return true;
+        }
+        this->logControlBytes(false, this->getBlackboardLocation(), elementCount);
+
+        if (!_backend.writeBytes(this->getBlackboardLocation(), elementCount, error)) {
+
+            error = "ALSA: Unable to write element " + controlName + ": " + error;
+            return false;
+        }
+        this->getAccessTimer().lap(AmixerControl::PhaseTransfer);
+
+        return true;
+
+    case AmixerElementUnknown:
+        error = "ALSA: Unknown control element type while accessing alsa element " + controlName;
+        return false;
+
+    default:
+        break;
+    }
+
+    if (receive) {
+
+        return readValues(controlName, elementCount, error);
+    }
+
+    // Ramped volumes are handed over to the ramp engine, along with the control
+    if ((type == AmixerElementInteger) && (this->getRampDuration() != 0)) {
+
+        return startRamp(controlName, elementCount, error);
+    }
+    return writeValues(controlName, elementCount, error);
+}
+
+template <class Backend, class Codec>
+bool AmixerBackendControl<Backend, Codec>::readStartupEntry()
+{
+    const AlsaSnapshotReader::Entry *entry = this->takeStartupEntry();
+
+    if ((entry == NULL) ||
+        !readKnownValues(entry->type, entry->count, entry->values, entry->bytes)) {
+
+        return false;
+    }
+    if (this->isDebugEnabled()) {
+
+        this->info() << "Reading alsa element " << this->getControlName()
+                     << " from the startup state";
+    }
+    return true;
+}
+
+template <class Backend, class Codec>
+bool AmixerBackendControl<Backend, Codec>::applyControlChange(bool receive)
+{
+    AlsaEventMonitor::Change change;
+
+    if (!this->takeControlChange(change)) {
+
+        return false;
+    }
+    _isCacheValid = false;
+
+    if (change.isInfoChanged) {
+
+        invalidateTables();
+    }
+    if (!receive || !change.isValueChanged) {
+
+        return false;
+    }
+    uint32_t count = (change.type == AmixerElementBytes) ? change.bytes.size()
+                                                         : change.values.size();
+
+    if (!readKnownValues(change.type, count, change.values.data(), change.bytes.data())) {
+
+        return false;
+    }
+    if (this->isDebugEnabled()) {
+
+        this->info() << "Reading alsa element " << this->getControlName()
+                     << " from its last change event";
+    }
+    return true;
+}
+
+template <class Backend, class Codec>
+template <typename Value>
+bool AmixerBackendControl<Backend, Codec>::readKnownValues(AmixerElementType type,
+                                                           uint32_t count, const Value *values,
+                                                           const void *bytes)
+{
+    // Mapping types relying on the control metadata need the hardware
+    if ((this->getEnumItemTable() != NULL) || (this->getDbScale() != NULL)) {
+
+        return false;
+    }
+    if (type == AmixerElementBytes) {
+
+        if (count != this->getSize()) {
+
+            return false;
+        }
+        memcpy(this->getBlackboardLocation(), bytes, count);
+
+    } else {
+
+        if (count != this->getBlackboardElementCount()) {
+
+            return false;
+        }
+        convertToBlackboard(values, count);
+    }
+    return true;
+}
+
+template <class Backend, class Codec>
+bool AmixerBackendControl<Backend, Codec>::readCache()
+{
+    // The controls of a rebound card may have changed
+    if (!_isCacheValid || (this->getCard().generation != _cardGeneration)) {
+
+        return false;
+    }
+    memcpy(this->getBlackboardLocation(), _cache.data(), _cache.size());
+
+    if (this->isDebugEnabled()) {
+
+        this->info() << "Reading alsa element " << this->getControlName() << " from the cache";
+    }
+    return true;
+}
+
+template <class Backend, class Codec>
+void AmixerBackendControl<Backend, Codec>::recordAccess(AlsaTrafficRecorder &recorder,
+                                                        bool receive, uint64_t start,
+                                                        bool isSuccessful)
+{
+    // Values are only known once the control has been resolved and accessed
+    AmixerElementType type = isSuccessful ? _backend.getType() : AmixerElementUnknown;
+    const long *values = NULL;
+    const void *bytes = NULL;
+    uint32_t count = 0;
+
+    if (type == AmixerElementBytes) {
+
+        bytes = this->getBlackboardLocation();
+        count = this->getSize();
+
+    } else if (isSuccessful) {
+
+        values = _values.data();
+        count = _values.size();
+    }
+    recorder.recordControl(this->getCardName(), this->getControlName(), receive, type, values,
+                           bytes, count, start, isSuccessful);
+}
+
+template <class Backend, class Codec>
+void AmixerBackendControl<Backend, Codec>::invalidateTables()
+{
+    AmixerEnumItemTable *itemTable = this->getEnumItemTable();
+    AmixerDbScale *dbScale = this->getDbScale();
+
+    if (itemTable != NULL) {
+
+        itemTable->invalidate();
+    }
+    if (dbScale != NULL) {
+
+        dbScale->invalidate();
+    }
+}
+
+template <class Backend, class Codec>
+bool AmixerBackendControl<Backend, Codec>::updateEnumItemTable(const std::string &controlName,
+                                                               std::string &error)
+{
+    AmixerEnumItemTable *itemTable = this->getEnumItemTable();
+
+    if (itemTable == NULL) {
+
+        return true;
+    }
+    if (_backend.getType() != AmixerElementEnumerated) {
+
+        error = "ALSA: Element " + controlName + " is not enumerated";
+        return false;
+    }
+    uintptr_t controlKey = _backend.getKey();
+    uint32_t itemCount = _backend.getItemCount();
+
+    if (itemTable->isValidFor(controlKey, itemCount)) {
+
+        return true;
+    }
+    itemTable->reset(controlKey, itemCount);
+
+    for (uint32_t item = 0; item < itemCount; item++) {
+
+        std::string itemName;
+
+        if (!_backend.getItemName(item, itemName, error)) {
+
+            error = "ALSA: Unable to get item " + std::to_string(item) + " of element " +
+                    controlName + ": " + error;
+
+            itemTable->invalidate();
+            return false;
+        }
+        itemTable->addItem(itemName);
+    }
+    return true;
+}
+
+template <class Backend, class Codec>
+bool AmixerBackendControl<Backend, Codec>::updateDbScale(const std::string &controlName,
+                                                         std::string &error)
+{
+    AmixerDbScale *dbScale = this->getDbScale();
+
+    if (dbScale == NULL) {
+
+        return true;
+    }
+    uintptr_t controlKey = _backend.getKey();
+
+    if (dbScale->isValidFor(controlKey)) {
+
+        return true;
+    }
+    if (_backend.getType() != AmixerElementInteger) {
+
+        error = "ALSA: Element " + controlName + " has no dB information";
+        return false;
+    }
+    unsigned int tlv[_maxDbTlvWords];
+    size_t tlvSize = sizeof(tlv);
+    long min;
+    long max;
+
+    if (!_backend.readDbTlv(tlv, tlvSize, min, max, error)) {
+
+        error = "ALSA: Unable to read dB information of element " + controlName + ": " + error;
+        return false;
+    }
+    if (!dbScale->build(controlKey, tlv, tlvSize, min, max, error)) {
+
+        error = "ALSA: Element " + controlName + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+template <class Backend, class Codec>
+bool AmixerBackendControl<Backend, Codec>::readValues(const std::string &controlName,
+                                                      uint32_t elementCount,
+                                                      std::string &error)
+{
+    _values.resize(elementCount);
+
+    // All the elements are read at once
+    if (!_backend.read(_values.data(), elementCount, error)) {
+
+        error = "ALSA: Unable to read element " + controlName + ": " + error;
+        return false;
+    }
+    this->getAccessTimer().lap(AmixerControl::PhaseTransfer);
+
+    if (this->isDebugEnabled()) {
+
+        for (uint32_t index = 0; index < elementCount; index++) {
+
+            this->info() << "Reading alsa element " << controlName
+                         << ", index " << index << " with value " << _values[index];
+        }
+    }
+    convertToBlackboard(_values.data(), elementCount);
+    this->getAccessTimer().lap(AmixerControl::PhaseConversion);
+
+    return true;
+}
+
+template <class Backend, class Codec>
+bool AmixerBackendControl<Backend, Codec>::writeValues(const std::string &controlName,
+                                                       uint32_t elementCount,
+                                                       std::string &error)
+{
+    _values.resize(elementCount);
+    convertFromBlackboard(_values.data(), elementCount);
+
+    if (this->isDebugEnabled()) {
+
+        for (uint32_t index = 0; index < elementCount; index++) {
+
+            this->info() << "Writing alsa element " << controlName
+                         << ", index " << index << " with value " << _values[index];
+        }
+    }
+    this->getAccessTimer().lap(AmixerControl::PhaseConversion);
+
+    // All the elements are written at once
+    if (!_backend.write(_values.data(), elementCount, error)) {
+
+        error = "ALSA: Unable to write element " + controlName + ": " + error;
+        return false;
+    }
+    this->getAccessTimer().lap(AmixerControl::PhaseTransfer);
+
+    return true;
+}
+
+template <class Backend, class Codec>
+bool AmixerBackendControl<Backend, Codec>::startRamp(const std::string &controlName,
+                                                     uint32_t elementCount,
+                                                     std::string &error)
+{
+    std::vector<long> fromLevels(elementCount);
+    // Target levels are kept along with the values of the other writes
+    std::vector<long> &toLevels = _values;
+
+    toLevels.resize(elementCount);
+
+    // The ramp starts from the current levels
+    if (!_backend.read(fromLevels.data(), elementCount, error)) {
+
+        error = "ALSA: Unable to read element " + controlName + ": " + error;
+        return false;
+    }
+    this->getAccessTimer().lap(AmixerControl::PhaseTransfer);
+
+    convertFromBlackboard(toLevels.data(), elementCount);
+
+    if (this->isDebugEnabled()) {
+
+        for (uint32_t index = 0; index < elementCount; index++) {
+
+            this->info() << "Ramping alsa element " << controlName << ", index " << index
+                         << " from value " << fromLevels[index] << " to value "
+                         << toLevels[index] << " in " << this->getRampDuration() << "ms";
+        }
+    }
+    this->getAccessTimer().lap(AmixerControl::PhaseConversion);
+
+    bool success = this->getRampEngine().startRamp(this, _backend.getCardIndex(),
+                                                   _backend.createRampWriter(), fromLevels,
+                                                   toLevels, this->getRampDuration(), error);
+    this->getAccessTimer().lap(AmixerControl::PhaseTransfer);
+
+    return success;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AmixerControl.hpp"
+#include <string>
+#include <sstream>
+
+/** This class implements a bytes control holding the raw content of any parameter type.
+ *
+ * The scalar size is forced to one byte, so that strings, blocks and integers of any size map
+ * onto the bytes of the control. The content is logged in hexadecimal, 64 bytes per line.
+ *
+ * The template parameter is AmixerControl or another mapping type: the resulting codec is
+ * instantiated over a backend through AmixerBackendControl.
+ */
+template <class SubsystemObjectBase>
+class AmixerByteArray : public SubsystemObjectBase
+{
+public:
+    /**
+     * AmixerByteArray Class constructor
+     *
+     * @param[in] mappingValue instantiation mapping value
+     * @param[in] instConfigElement pointer to configurable element instance
+     * @param[in] context contains the context mappings
+     */
+    AmixerByteArray(const std::string &mappingValue,
+                    CInstanceConfigurableElement *instConfigElement,
+                    const CMappingContext &context,
+                    core::log::Logger& logger)
+        : SubsystemObjectBase(mappingValue, instConfigElement, context, logger, _byteScalarSize)
+    {
+    }
+
+protected:
+    /**
+     * Log the content of the control in hexadecimal, when in debug mode
+     *
+     * @param[in] receive is true for a read, false for a write
+     * @param[in] data the bytes of the control
+     * @param[in] size the number of bytes
+     */
+    void logControlBytes(bool receive, const void *data, size_t size) const
+    {
+        if (!this->isDebugEnabled()) {
+
+            return;
+        }
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        std::ostringstream line;
+
+        this->info() << (receive ? "Reading" : "Writing") << " alsa element: "
+                     << this->getControlName() << " with value: ";
+
+        for (size_t index = 0; index < size; index++) {
+
+            line.width(2);
+            line.fill('0');
+            line << std::hex << static_cast<unsigned short>(bytes[index]) << " ";
+
+            if ((index != 0) && ((index % _maxLogLine) == 0)) {
+
+                this->info() << line.str();
+                line.str(std::string());
+            }
+        }
+        if (!line.str().empty()) {
+
+            this->info() << line.str();
+        }
+        this->info() << "[" << size << " bytes]";
+    }
+
+private:
+    /** Scalar size of bytes controls */
+    static const uint32_t _byteScalarSize = 1;
+    /** Bytes per line of the content log */
+    static const size_t _maxLogLine = 64;
+};
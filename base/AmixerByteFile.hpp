@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AmixerControl.hpp"
+#include "AmixerElementType.hpp"
+#include "AlsaCardFingerprint.hpp"
+#include "InstanceConfigurableElement.h"
+#include "MappingContext.h"
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+/**
+ * BYTES control loaded from a file.
+ *
+ * The mapped element is a string parameter holding the path of a coefficient file. On write, the
+ * file is mapped and its content handed to the backend straight from the mapping: blobs neither
+ * transit through the blackboard nor are copied by the plugin. The file may be smaller than the
+ * control: TLV bytes controls get the file alone, others get it padded with zeros by the backend.
+ *
+ * The content hash of the last upload is kept: selecting a file with the same content again
+ * does not access the control, and selecting the same unmodified file does not even read it.
+ * The padding being always zeros, the file content tells the whole content of the control.
+ * The upload is done again once the card is rebound or the control changed behind our back.
+ * Reads return the path of the last uploaded file, without accessing the control.
+ */
+template <class Backend>
+class AmixerByteFile : public AmixerControl
+{
+public:
+    /**
+     * AmixerByteFile Class constructor
+     *
+     * @param[in] mappingValue instantiation mapping value
+     * @param[in] instConfigElement pointer to configurable element instance
+     * @param[in] context contains the context mappings
+     */
+    AmixerByteFile(const std::string &mappingValue,
+                   CInstanceConfigurableElement *instConfigElement,
+                   const CMappingContext &context,
+                   core::log::Logger& logger)
+        : AmixerControl(mappingValue, instConfigElement, context, logger,
+                        instConfigElement->getFootPrint()),
+          _backend(), _pathBuffer(instConfigElement->getFootPrint() + 1, '\0'), _path(),
+          _isUploaded(false), _uploadedHash(0), _uploadedSize(0), _uploadedFile(),
+          _cardGeneration(0)
+    {
+        // The path is read as a whole string
+        if (instConfigElement->getType() != CInstanceConfigurableElement::EStringParameter) {
+
+            setTypeIsSupported(false);
+        }
+    }
+
+protected:
+    virtual bool accessHW(bool receive, std::string &error);
+
+private:
+    /** Identity of a file, telling whether it may have changed */
+    struct FileIdentity
+    {
+        FileIdentity() : device(0), inode(0), size(0), modificationTime(0) {}
+
+        explicit FileIdentity(const struct stat &status)
+            : device(status.st_dev), inode(status.st_ino), size(status.st_size),
+              modificationTime(static_cast<uint64_t>(status.st_mtim.tv_sec) * 1000000000 +
+                               status.st_mtim.tv_nsec)
+        {
+        }
+
+        bool operator==(const FileIdentity &other) const
+        {
+            return (device == other.device) && (inode == other.inode) && (size == other.size) &&
+                   (modificationTime == other.modificationTime);
+        }
+
+        uint64_t device;
+        uint64_t inode;
+        uint64_t size;
+        uint64_t modificationTime;
+    };
+
+    /**
+     * Upload a mapped file to the control, unless its content is already there
+     *
+     * @param[in] data the content of the file
+     * @param[in] size the size of the file
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool upload(const void *data, size_t size, std::string &error);
+
+    /**
+     * Write the content of a file to the control
+     *
+     * @param[in] data the content of the file
+     * @param[in] size the size of the file
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool writeControl(const void *data, size_t size, std::string &error);
+
+    /**
+     * Tell whether a change event is the one of the last upload
+     *
+     * @param[in] change the change of the control
+     *
+     * @return true if the control still holds the content of the last upload
+     */
+    bool isUploadedContent(const AlsaEventMonitor::Change &change) const;
+
+    /** Access to the controls of the card */
+    Backend _backend;
+    /** Blackboard string, with room for a terminator */
+    std::vector<char> _pathBuffer;
+    /** Path of the last uploaded file */
+    std::string _path;
+    /** The control holds the content of the last uploaded file */
+    bool _isUploaded;
+    uint64_t _uploadedHash;
+    size_t _uploadedSize;
+    FileIdentity _uploadedFile;
+    /** Generation of the card the file was uploaded to */
+    uint32_t _cardGeneration;
+};
+
+template <class Backend>
+bool AmixerByteFile<Backend>::accessHW(bool receive, std::string &error)
+{
+    logControlInfo(receive);
+
+    if (!isTypeSupported()) {
+
+        error = "Parameter type not supported.";
+        return false;
+    }
+    if (receive) {
+
+        std::fill(_pathBuffer.begin(), _pathBuffer.end(), '\0');
+        _path.copy(_pathBuffer.data(), getSize());
+        blackboardWrite(_pathBuffer.data(), getSize());
+
+        return true;
+    }
+    _pathBuffer[getSize()] = '\0';
+    blackboardRead(_pathBuffer.data(), getSize());
+
+    const char *path = _pathBuffer.data();
+
+#ifdef SIMULATION
+    _path = path;
+
+    return true;
+#endif
+
+    // The control may have been written behind our back, or the card rebound
+    AlsaEventMonitor::Change change;
+
+    if ((takeControlChange(change) && !isUploadedContent(change)) ||
+        (getCard().generation != _cardGeneration)) {
+
+        _isUploaded = false;
+    }
+
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    struct stat status;
+
+    if ((fd < 0) || (fstat(fd, &status) < 0)) {
+
+        error = "Unable to open " + std::string(path) + " for alsa element " + getControlName() +
+                ": " + strerror(errno);
+        if (fd >= 0) {
+
+            ::close(fd);
+        }
+        return false;
+    }
+    FileIdentity file(status);
+
+    // The same unmodified file is not even read
+    if (_isUploaded && (file == _uploadedFile)) {
+
+        ::close(fd);
+        _path = path;
+
+        if (isDebugEnabled()) {
+
+            info() << "Alsa element " << getControlName() << " already holds " << path;
+        }
+        return true;
+    }
+    if (file.size == 0) {
+
+        ::close(fd);
+        error = "Coefficient file " + std::string(path) + " is empty";
+        return false;
+    }
+    void *data = mmap(NULL, file.size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping outlives the descriptor
+    ::close(fd);
+
+    if (data == MAP_FAILED) {
+
+        error = "Unable to map " + std::string(path) + ": " + strerror(errno);
+        return false;
+    }
+    bool success = upload(data, file.size, error);
+
+    munmap(data, file.size);
+
+    if (success) {
+
+        _path = path;
+        _uploadedFile = file;
+    }
+    return success;
+}
+
+template <class Backend>
+bool AmixerByteFile<Backend>::upload(const void *data, size_t size, std::string &error)
+{
+    uint64_t hash = AlsaCardFingerprint::hash(AlsaCardFingerprint::_hashBasis, data, size);
+
+    if (_isUploaded && (hash == _uploadedHash)) {
+
+        if (isDebugEnabled()) {
+
+            info() << "Alsa element " << getControlName() << " already holds this content";
+        }
+        return true;
+    }
+    // Generation first: a concurrent rebinding then at worst leads to a spurious upload
+    uint32_t cardGeneration = getCard().generation;
+
+    _isUploaded = false;
+
+    if (!writeControl(data, size, error)) {
+
+        return false;
+    }
+    _isUploaded = true;
+    _uploadedHash = hash;
+    _uploadedSize = size;
+    _cardGeneration = cardGeneration;
+
+    return true;
+}
+
+template <class Backend>
+bool AmixerByteFile<Backend>::isUploadedContent(const AlsaEventMonitor::Change &change) const
+{
+    // Our own uploads are notified too: only other contents invalidate the upload
+    if (!_isUploaded || !change.isValueChanged || change.isInfoChanged ||
+        (change.type != AmixerElementBytes) || (change.bytes.size() < _uploadedSize) ||
+        (AlsaCardFingerprint::hash(AlsaCardFingerprint::_hashBasis, change.bytes.data(),
+                                   _uploadedSize) != _uploadedHash)) {
+
+        return false;
+    }
+    // Past a shorter file, the control holds the zeros it was padded with
+    return std::find_if(change.bytes.begin() + _uploadedSize, change.bytes.end(),
+                        [](uint8_t byte) { return byte != 0; }) == change.bytes.end();
+}
+
+template <class Backend>
+bool AmixerByteFile<Backend>::writeControl(const void *data, size_t size, std::string &error)
+{
+    int32_t cardIndex = getCardNumber();
+
+    if (cardIndex < 0) {
+
+        error = "Card " + getCardName() + " not found. Error: " + strerror(-cardIndex);
+        return false;
+    }
+    if (!_backend.open(getSubsystem(), getCard(), error)) {
+
+        error = "ALSA: Unable to open card " + getCardName() + ": " + error;
+        return false;
+    }
+    const std::string &controlName = getControlName();
+    bool success = false;
+
+    if (!_backend.resolve(controlName, error)) {
+
+        error = "ALSA: Unable to get element info " + controlName + ": " + error;
+
+    } else if (_backend.getType() != AmixerElementBytes) {
+
+        error = "ALSA: Element " + controlName + " is not a bytes control";
+
+    } else if (size > _backend.getCount()) {
+
+        error = "ALSA: Coefficient file of " + std::to_string(size) +
+                " bytes exceeds the size of element " + controlName + " (" +
+                std::to_string(_backend.getCount()) + " bytes)";
+
+    } else if (!_backend.writeBytes(data, size, error)) {
+
+        error = "ALSA: Unable to write element " + controlName + ": " + error;
+
+    } else {
+
+        logControlBytes(false, data, size);
+        success = true;
+    }
+    _backend.close();
+
+    return success;
+}
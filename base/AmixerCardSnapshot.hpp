@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AlsaDescriptorPool.hpp"
+#include "AlsaSnapshot.hpp"
+#include "AlsaCardFingerprint.hpp"
+#include "AmixerElementType.hpp"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class CSubsystem;
+
+/**
+ * Store and restore of the mapped controls of a card, over a backend.
+ *
+ * The card is opened once for the whole pass and controls are resolved through the backend,
+ * bypassing the parameter-framework and the per-control accesses.
+ */
+template <class Backend>
+class AmixerCardSnapshot
+{
+public:
+    /**
+     * Dump the current values of the mapped controls of a card into a snapshot file, along
+     * with the card fingerprint
+     *
+     * @param[in] subsystem the subsystem the card belongs to
+     * @param[in] card the card descriptor
+     * @param[in] controlNames the names of the mapped controls of the card
+     * @param[in] path path of the snapshot file
+     * @param[out] error string containing error description
+     *
+     * @return true if no error, the snapshot is not written otherwise
+     */
+    static bool store(const CSubsystem *subsystem, const AlsaCardDescriptor &card,
+                      const AlsaDescriptorPool::ControlNameSet &controlNames,
+                      const std::string &path, std::string &error);
+
+    /**
+     * Write back the values of a snapshot file
+     *
+     * Restoring goes on after a control failure, so that as much state as possible is restored.
+     *
+     * @param[in] subsystem the subsystem the card belongs to
+     * @param[in] card the card descriptor
+     * @param[in] path path of the snapshot file
+     * @param[out] restoredCount number of restored controls
+     * @param[out] error string containing error description
+     *
+     * @return true if all the controls have been restored
+     */
+    static bool restore(const CSubsystem *subsystem, const AlsaCardDescriptor &card,
+                        const std::string &path, uint32_t &restoredCount, std::string &error);
+
+private:
+    /**
+     * Write back one snapshot entry
+     *
+     * @param[in] backend the backend, card opened
+     * @param[in] entry the snapshot entry
+     * @param[in] values conversion buffer
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    static bool restoreEntry(Backend &backend, const AlsaSnapshotReader::Entry &entry,
+                             std::vector<long> &values, std::string &error);
+};
+
+template <class Backend>
+bool AmixerCardSnapshot<Backend>::store(const CSubsystem *subsystem,
+                                        const AlsaCardDescriptor &card,
+                                        const AlsaDescriptorPool::ControlNameSet &controlNames,
+                                        const std::string &path, std::string &error)
+{
+    int32_t cardIndex = card.index;
+
+    if (cardIndex < 0) {
+
+        error = "Card " + card.name + " not found";
+        return false;
+    }
+    AlsaSnapshotWriter snapshot;
+    uint64_t fingerprint;
+
+    if (!AlsaCardFingerprint::compute(cardIndex, fingerprint, error)) {
+
+        return false;
+    }
+    snapshot.setFingerprint(fingerprint);
+
+    Backend backend;
+
+    if (!backend.open(subsystem, card, error)) {
+
+        error = "ALSA: Unable to open card " + card.name + ": " + error;
+        return false;
+    }
+
+    std::vector<long> values;
+    std::vector<uint8_t> bytes;
+
+    AlsaDescriptorPool::ControlNameSet::const_iterator it;
+    for (it = controlNames.begin(); it != controlNames.end(); ++it) {
+
+        const std::string &controlName = **it;
+        bool success = backend.resolve(controlName, error);
+
+        if (success) {
+
+            AmixerElementType type = backend.getType();
+            uint32_t count = backend.getCount();
+
+            if (type == AmixerElementBytes) {
+
+                bytes.resize(count);
+                if ((success = backend.readBytes(bytes.data(), count, error))) {
+
+                    snapshot.addBytes(controlName, bytes.data(), count);
+                }
+            } else if (type != AmixerElementUnknown) {
+
+                values.resize(count);
+                if ((success = backend.read(values.data(), count, error))) {
+
+                    snapshot.addValues(controlName, type, values.data(), count);
+                }
+            }
+        }
+        if (!success) {
+
+            error = "ALSA: Unable to read element " + controlName + ": " + error;
+            backend.close();
+            return false;
+        }
+    }
+    backend.close();
+
+    return snapshot.commit(path, error);
+}
+
+template <class Backend>
+bool AmixerCardSnapshot<Backend>::restoreEntry(Backend &backend,
+                                               const AlsaSnapshotReader::Entry &entry,
+                                               std::vector<long> &values, std::string &error)
+{
+    if (!backend.resolve(entry.controlName, error)) {
+
+        return false;
+    }
+    // The control may have changed since the snapshot
+    if ((backend.getType() != entry.type) || (backend.getCount() != entry.count)) {
+
+        error = "control type or element count changed";
+        return false;
+    }
+    if (entry.type == AmixerElementBytes) {
+
+        return backend.writeBytes(entry.bytes, entry.count, error);
+    }
+    values.assign(entry.values, entry.values + entry.count);
+
+    return backend.write(values.data(), entry.count, error);
+}
+
+template <class Backend>
+bool AmixerCardSnapshot<Backend>::restore(const CSubsystem *subsystem,
+                                          const AlsaCardDescriptor &card,
+                                          const std::string &path, uint32_t &restoredCount,
+                                          std::string &error)
+{
+    restoredCount = 0;
+
+    if (card.index < 0) {
+
+        error = "Card " + card.name + " not found";
+        return false;
+    }
+    AlsaSnapshotReader snapshot;
+
+    if (!snapshot.open(path, error)) {
+
+        return false;
+    }
+    Backend backend;
+
+    if (!backend.open(subsystem, card, error)) {
+
+        error = "ALSA: Unable to open card " + card.name + ": " + error;
+        return false;
+    }
+    AlsaSnapshotReader::Entry entry;
+    std::vector<long> values;
+    std::string entryError;
+    std::string failures;
+
+    // Single streaming pass over the mapped file
+    while (snapshot.next(entry, entryError)) {
+
+        if (restoreEntry(backend, entry, values, entryError)) {
+
+            restoredCount++;
+        } else {
+
+            failures += std::string(failures.empty() ? "" : ", ") + entry.controlName + " (" +
+                        entryError + ")";
+        }
+    }
+    backend.close();
+
+    if (!entryError.empty()) {
+
+        error = path + ": " + entryError;
+        return false;
+    }
+    if (!failures.empty()) {
+
+        error = "ALSA: Unable to restore elements " + failures;
+        return false;
+    }
+    return true;
+}
@@ -35,13 +35,20 @@
 #include "ParameterBlockType.h"
 #include "MappingContext.h"
 #include "AlsaMappingKeys.hpp"
+#include "AlsaSubsystem.hpp"
+#include "AlsaAccessHook.hpp"
 #include <string.h>
 #include <string>
 #include <ctype.h>
 #include <algorithm>
+#include <sstream>
 
 #define base AlsaSubsystemObject
 
+const char *const AmixerControl::_accessPhaseNames[NbAccessPhases] = {
+    "card lookup", "open", "element info", "tables", "conversion", "transfer"
+};
+
 AmixerControl::AmixerControl(const std::string &mappingValue,
                              CInstanceConfigurableElement *instanceConfigurableElement,
                              const CMappingContext &context,
@@ -52,8 +59,18 @@ AmixerControl::AmixerControl(const std::string &mappingValue,
            context),
       _scalarSize(0),
       _hasWrongElementTypeError(false),
-      _isDebugEnabled(context.iSet(AlsaDebugEnable))
+      _isDebugEnabled(context.iSet(AlsaDebugEnable)),
+      _accessClass(AccessDefault),
+      _controlName(&getDescriptorPool().getControlName(getFormattedMappingValue())),
+      _isStartupStatePending(context.iSet(AlsaStateDirectory)),
+      _changeFlag(NULL),
+      _accessTimer(_accessPhaseNames, NbAccessPhases,
+                   context.iSet(AlsaSlowAccessThreshold) ?
+                   context.getItemAsInteger(AlsaSlowAccessThreshold) : 0),
+      _mirrorEntry(NULL)
 {
+    init(context);
+
     // Check we are able to handle elements (no exception support, defer the error)
     switch (instanceConfigurableElement->getType()) {
 
@@ -87,21 +104,92 @@ AmixerControl::AmixerControl(const std::string &mappingValue,
            context),
       _scalarSize(scalarSize),
       _hasWrongElementTypeError(false),
-      _isDebugEnabled(context.iSet(AlsaDebugEnable))
+      _isDebugEnabled(context.iSet(AlsaDebugEnable)),
+      _accessClass(AccessDefault),
+      _controlName(&getDescriptorPool().getControlName(getFormattedMappingValue())),
+      _isStartupStatePending(context.iSet(AlsaStateDirectory)),
+      _changeFlag(NULL),
+      _accessTimer(_accessPhaseNames, NbAccessPhases,
+                   context.iSet(AlsaSlowAccessThreshold) ?
+                   context.getItemAsInteger(AlsaSlowAccessThreshold) : 0),
+      _mirrorEntry(NULL)
+{
+    init(context);
+}
+
+void AmixerControl::init(const CMappingContext &context)
+{
+    getDescriptorPool().addControl(getCard(), *_controlName);
+
+    if (_isStartupStatePending) {
+
+        getAlsaSubsystem().getStartupState().addCard(getCard(),
+                                                     context.getItem(AlsaStateDirectory));
+    }
+    if (context.iSet(AlsaResolutionDirectory)) {
+
+        getAlsaSubsystem().getResolutionCache().addCard(
+            getCard(), context.getItem(AlsaResolutionDirectory));
+    }
+    readAccessClass(context);
+    watchEvents(context);
+    enableMirror(context);
+}
+
+bool AmixerControl::sendToHW(std::string &error)
 {
+    AlsaAccessHook hook;
+
+    return accessHW(false, error);
+}
+
+bool AmixerControl::receiveFromHW(std::string &error)
+{
+    AlsaAccessHook hook;
+
+    return accessHW(true, error);
 }
 
 void AmixerControl::logControlInfo(bool receive) const
 {
     if (_isDebugEnabled) {
 
-        std::string controlName = getFormattedMappingValue();
         info() << (receive ? "Reading" : "Writing")
                << " ALSA Element Instance: " << getConfigurableElement()->getPath()
-               << "\t\t(Control Element: " << controlName << ")";
+               << "\t\t(Control Element: " << getControlName() << ")";
     }
 }
 
+void AmixerControl::reportSlowAccess(bool receive) const
+{
+    if (_accessTimer.isSlow()) {
+
+        warning() << "Slow " << (receive ? "read" : "write") << " of alsa element "
+                  << getControlName() << ": " << _accessTimer.getBreakdown();
+    }
+}
+
+void AmixerControl::logControlBytes(bool receive, const void *data, size_t size) const
+{
+    if (!_isDebugEnabled) {
+
+        return;
+    }
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    std::ostringstream values;
+
+    for (size_t index = 0; index < size; index++) {
+
+        if (index != 0) {
+
+            values << ',';
+        }
+        values << static_cast<unsigned int>(bytes[index]);
+    }
+    info() << (receive ? "Reading" : "Writing") << " alsa element " << getControlName() << ": "
+           << values.str();
+}
+
 int AmixerControl::fromBlackboard()
 {
     int value = 0;
@@ -116,3 +204,86 @@ void AmixerControl::toBlackboard(int value)
 {
     blackboardWrite(&value, getScalarSize());
 }
+
+AmixerRampEngine &AmixerControl::getRampEngine() const
+{
+    return getAlsaSubsystem().getRampEngine();
+}
+
+const AlsaSnapshotReader::Entry *AmixerControl::takeStartupEntry()
+{
+    if (!_isStartupStatePending) {
+
+        return NULL;
+    }
+    // Only the initial read is answered from the startup state
+    _isStartupStatePending = false;
+
+    return getAlsaSubsystem().getStartupState().find(getCard(), getControlName());
+}
+
+void AmixerControl::readAccessClass(const CMappingContext &context)
+{
+    if (!context.iSet(AlsaAccessClass)) {
+
+        return;
+    }
+    const std::string &accessClass = context.getItem(AlsaAccessClass);
+
+    if (accessClass == "volatile") {
+
+        // Nor are they answered from the startup state
+        _accessClass = AccessVolatile;
+        _isStartupStatePending = false;
+    } else if (accessClass == "cacheable") {
+
+        _accessClass = AccessCacheable;
+    } else if (accessClass == "writeonly") {
+
+        _accessClass = AccessWriteOnly;
+    } else {
+
+        warning() << "Unknown access class " << accessClass << " of alsa element "
+                  << getControlName() << ", expected volatile, cacheable or writeonly";
+    }
+}
+
+void AmixerControl::watchEvents(const CMappingContext &context)
+{
+    std::string error;
+
+    // Volatile controls are always read from the hardware: their events are of no use
+    if (!context.iSet(AlsaEventsEnabled) || (_accessClass == AccessVolatile)) {
+
+        return;
+    }
+    if (!getAlsaSubsystem().getEventMonitor().watch(getCard(), getControlName(), _changeFlag,
+                                                    error)) {
+
+        warning() << "Changes of alsa element " << getControlName()
+                  << " will not be tracked: " << error;
+        _changeFlag = NULL;
+    }
+}
+
+void AmixerControl::enableMirror(const CMappingContext &context)
+{
+    std::string error;
+
+    if (!context.iSet(AlsaMirrorName)) {
+
+        return;
+    }
+    if (!getAlsaSubsystem().openMirror(context.getItem(AlsaMirrorName), error) ||
+        ((_mirrorEntry = getAlsaSubsystem().getMirror().addEntry(getCard(), getControlName(),
+                                                                 error)) == NULL)) {
+
+        warning() << "Alsa element " << getControlName() << " will not be mirrored: " << error;
+    }
+}
+
+bool AmixerControl::takeControlChange(AlsaEventMonitor::Change &change)
+{
+    return (_changeFlag != NULL) && *_changeFlag &&
+           getAlsaSubsystem().getEventMonitor().takeChange(getCard(), getControlName(), change);
+}
@@ -30,19 +30,61 @@
 #pragma once
 
 #include "AlsaSubsystemObject.hpp"
+#include "AlsaSnapshot.hpp"
+#include "AlsaEventMonitor.hpp"
+#include "AlsaAccessTimer.hpp"
+#include "AlsaMirror.hpp"
 #include <string>
 
 class CInstanceConfigurableElement;
 class CMappingContext;
+class AmixerEnumItemTable;
+class AmixerDbScale;
+class AmixerRampEngine;
 
 /**
  * Alsa mixer control class.
- * This class handles the configuration of an alsa mixer control through the PFW. It will be
- * derivated for both Legacy alsa subsystem and tiny alsa subsystem.
+ * This class handles the configuration of an alsa mixer control through the PFW. The access to
+ * the hardware is implemented by AmixerBackendControl, over the backend of each subsystem.
+ *
+ * The blackboard conversion functions and translation tables below form the default value codec.
+ * Mapping types hide them: they are not virtual, the codec being known at compile time.
  */
 class AmixerControl : public AlsaSubsystemObject
 {
 public:
+    /** How the control values may be read, as declared by the Access mapping key */
+    enum AccessClass
+    {
+        /** Reads hit the hardware, unless answered by the startup state or change events */
+        AccessDefault,
+        /** Reads always hit the hardware */
+        AccessVolatile,
+        /** Reads are answered from the last values read or written, once known */
+        AccessCacheable,
+        /** Reads are skipped, the blackboard being left as is */
+        AccessWriteOnly
+    };
+
+    /** Phases of a hardware access, timed when the SlowAccess mapping key is set */
+    enum AccessPhase
+    {
+        /** Card index and generation of the card descriptor */
+        PhaseCardLookup,
+        /** Opening the control interface of the card */
+        PhaseOpen,
+        /** Element lookup and info */
+        PhaseResolve,
+        /** Enumerated item names and dB TLV, when the translation tables are outdated */
+        PhaseTables,
+        /** Blackboard conversion of the element values */
+        PhaseConversion,
+        /** Element read or write */
+        PhaseTransfer,
+
+        NbAccessPhases
+    };
+
     /**
      * AmixerControl Class constructor
      *
@@ -72,6 +114,10 @@ public:
 protected:
     virtual bool accessHW(bool receive, std::string &error) = 0;
 
+    /** Synchronization entry points, calling accessHW within the access hooks */
+    virtual bool sendToHW(std::string &error);
+    virtual bool receiveFromHW(std::string &error);
+
     /**
      * Logging Control Info
      * When in debug mode, this function will log information on the parameter name and
@@ -81,12 +127,21 @@ protected:
      */
     void logControlInfo(bool receive) const;
 
+    /**
+     * Log the content of a BYTES control, when in debug mode
+     *
+     * @param[in] receive is true for a read, false for a write
+     * @param[in] data the bytes of the control
+     * @param[in] size the number of bytes
+     */
+    void logControlBytes(bool receive, const void *data, size_t size) const;
+
     /**
      * Return the name of the alsa mixer control
      *
      * @return the name of the control
      */
-    const std::string getControlName() const { return getFormattedMappingValue(); }
+    const std::string &getControlName() const { return *_controlName; }
 
     /**
      * Get the parameter scalar size for elementary access
@@ -118,27 +173,160 @@ protected:
      */
     bool isDebugEnabled() const { return _isDebugEnabled; }
 
+    /**
+     * Get the access class of the control
+     *
+     * @return the access class, AccessDefault if not declared
+     */
+    AccessClass getAccessClass() const { return _accessClass; }
+
+    /**
+     * Get the timer of the hardware accesses, disabled if no SlowAccess threshold is set
+     *
+     * @return the access timer
+     */
+    AlsaAccessTimer &getAccessTimer() { return _accessTimer; }
+
+    /**
+     * Warn about the last access if it took longer than the SlowAccess threshold
+     *
+     * @param[in] receive is true for a read, false for a write
+     */
+    void reportSlowAccess(bool receive) const;
+
+    /**
+     * Publish the values of the control into the shared memory mirror, if enabled
+     *
+     * @param[in] type the element type of the control
+     * @param[in] values the element values, for all the types but bytes
+     * @param[in] bytes the content of a bytes control
+     * @param[in] count number of elements, or bytes
+     */
+    void publishValues(AmixerElementType type, const long *values, const void *bytes,
+                       uint32_t count)
+    {
+        if (_mirrorEntry != NULL) {
+
+            AlsaMirror::publish(*_mirrorEntry, type, values, bytes, count);
+        }
+    }
+
 protected:
     /** Read an integer from the blackboard
      *
      * @return the read int
      */
-    virtual int fromBlackboard();
+    int fromBlackboard();
 
     /** Write an integer to the blackboard
      *
      * @param[in] value the control value to write
      */
-    virtual void toBlackboard(int value);
+    void toBlackboard(int value);
+
+    /** Number of control elements the blackboard holds
+     *
+     * @return the blackboard size over the scalar size, 0 if the type is not supported
+     */
+    uint32_t getBlackboardElementCount() const
+    {
+        return (_scalarSize != 0) ? getSize() / _scalarSize : 0;
+    }
+
+    /** Read all the element values from the blackboard in one pass
+     *
+     * @param[out] values the element values
+     * @param[in] count the number of elements
+     *
+     * @return false if the mapping type converts element by element through fromBlackboard()
+     */
+    bool fromBlackboardValues(long * /*values*/, uint32_t /*count*/) { return false; }
+
+    /** Write all the element values to the blackboard in one pass
+     *
+     * @param[in] values the element values
+     * @param[in] count the number of elements
+     *
+     * @return false if the mapping type converts element by element through toBlackboard()
+     */
+    template <typename Value>
+    bool toBlackboardValues(const Value * /*values*/, uint32_t /*count*/) { return false; }
+
+    /** Item name table to be filled by the backend for enumerated controls
+     *
+     * @return the table of the mapping type addressing items by name, NULL otherwise
+     */
+    AmixerEnumItemTable *getEnumItemTable() { return NULL; }
+
+    /** dB scale to be filled by the backend for volume controls
+     *
+     * @return the scale of the mapping type addressing levels in dB, NULL otherwise
+     */
+    AmixerDbScale *getDbScale() { return NULL; }
+
+    /**
+     * Get the duration of the ramp to apply on writes
+     *
+     * @return the ramp duration in milliseconds, 0 to write levels at once
+     */
+    uint32_t getRampDuration() const { return 0; }
+
+    /**
+     * Get the volume ramp engine of the subsystem
+     *
+     * @return the ramp engine
+     */
+    AmixerRampEngine &getRampEngine() const;
+
+    /**
+     * Get the value saved at last shutdown, for the initial read only
+     *
+     * @return the saved entry of the control, NULL if the control has to be read from hardware
+     */
+    const AlsaSnapshotReader::Entry *takeStartupEntry();
+
+    /**
+     * Take the changes of the control made behind the subsystem's back since the last access
+     * The event monitor is only locked when there are changes.
+     *
+     * @param[out] change the changes, if any
+     *
+     * @return true if the control events are watched and the control changed
+     */
+    bool takeControlChange(AlsaEventMonitor::Change &change);
 
 private:
     /**
-     * Format control name
-     * Builds the name of the alsa control from the mapping read in XML file
+     * Wire the control into the features of the subsystem enabled by its context
+     * Shared by the constructors.
+     *
+     * @param[in] context contains the context mappings
+     */
+    void init(const CMappingContext &context);
+
+    /**
+     * Read the access class of the control, if declared
      *
-     * @param[in] context read in xml file containing the alsa mixer control name
+     * @param[in] context contains the context mappings
      */
-    void formatControlName(const CMappingContext &context);
+    void readAccessClass(const CMappingContext &context);
+
+    /**
+     * Watch the control events, if enabled
+     *
+     * @param[in] context contains the context mappings
+     */
+    void watchEvents(const CMappingContext &context);
+
+    /**
+     * Publish the values into the shared memory mirror, if enabled
+     *
+     * @param[in] context contains the context mappings
+     */
+    void enableMirror(const CMappingContext &context);
+
+    /** Names of the access phases, in AccessPhase order */
+    static const char *const _accessPhaseNames[NbAccessPhases];
 
     /** Scalar parameter size for elementary access */
     uint32_t _scalarSize;
@@ -146,4 +334,16 @@ private:
     bool _hasWrongElementTypeError;
     /** Debug on */
     bool _isDebugEnabled;
+    /** How the control values may be read */
+    AccessClass _accessClass;
+    /** Formatted control name, shared with the other controls of the same name */
+    const std::string *_controlName;
+    /** True until the initial read, if the startup state is enabled */
+    bool _isStartupStatePending;
+    /** Set while the control has pending change events, NULL if they are not watched */
+    const std::atomic<bool> *_changeFlag;
+    /** Per-phase timing of the hardware accesses */
+    AlsaAccessTimer _accessTimer;
+    /** Entry of the control in the shared memory mirror, NULL if not mirrored */
+    AlsaMirror::Entry *_mirrorEntry;
 };
@@ -0,0 +1,366 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AlsaSubsystemObject.hpp"
+#include "AlsaMappingKeys.hpp"
+#include "AmixerElementType.hpp"
+#include "InstanceConfigurableElement.h"
+#include "TypeElement.h"
+#include "MappingContext.h"
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+/**
+ * Group of alsa mixer controls mapped on the fields of a single parameter block.
+ *
+ * The mapping value lists the control names, separated by '|', amends being supported: the n-th
+ * control maps to the n-th field of the block, at the offset of the field in the blackboard.
+ * Fields are integer parameters, scalar or arrays, or byte arrays for BYTES controls.
+ *
+ * A single object handles all the controls: the card is opened once per access, and the controls
+ * are accessed back-to-back on its cached handle. Controls are resolved on their first access,
+ * and again once the card is rebound only. An access stops at the first failing control.
+ *
+ * The Backend policy is the one of AmixerBackendControl, the resolved control staying valid across
+ * close and open until the card is rebound. The translation tables, startup state, change events
+ * and ramps of single controls are not supported.
+ */
+template <class Backend>
+class AmixerControlGroup : public AlsaSubsystemObject
+{
+public:
+    /**
+     * AmixerControlGroup Class constructor
+     *
+     * @param[in] mappingValue instantiation mapping value
+     * @param[in] instanceConfigurableElement pointer to configurable element instance
+     * @param[in] context contains the context mappings
+     */
+    AmixerControlGroup(const std::string &mappingValue,
+                       CInstanceConfigurableElement *instanceConfigurableElement,
+                       const CMappingContext &context,
+                       core::log::Logger& logger)
+        : AlsaSubsystemObject(mappingValue, instanceConfigurableElement, logger,
+                              AlsaAmend1, gNbAlsaAmends, context),
+          _isDebugEnabled(context.iSet(AlsaDebugEnable)), _members(), _values(),
+          _cardGeneration(0), _typeError()
+    {
+        addMembers(instanceConfigurableElement);
+    }
+
+protected:
+    virtual bool accessHW(bool receive, std::string &error);
+
+private:
+    /** Control mapped on a field of the block */
+    struct Member
+    {
+        Member(const std::string &name, const CInstanceConfigurableElement *field,
+               uint32_t fieldOffset, uint32_t fieldSize, uint32_t fieldScalarSize)
+            : controlName(&name), element(field), offset(fieldOffset), size(fieldSize),
+              scalarSize(fieldScalarSize), backend(new Backend), isResolved(false),
+              type(AmixerElementUnknown), count(0)
+        {
+        }
+
+        /** Interned control name */
+        const std::string *controlName;
+        /** Field of the block, for sign extension */
+        const CInstanceConfigurableElement *element;
+        /** Location of the field in the blackboard of the block */
+        uint32_t offset;
+        uint32_t size;
+        uint32_t scalarSize;
+        std::unique_ptr<Backend> backend;
+        /** The control was found for the current card generation, and not failed since */
+        bool isResolved;
+        AmixerElementType type;
+        uint32_t count;
+    };
+
+    /**
+     * Map the control names on the fields of the block
+     *
+     * @param[in] instanceConfigurableElement the mapped block
+     */
+    void addMembers(const CInstanceConfigurableElement *instanceConfigurableElement);
+
+    /**
+     * Look a control up, checking it matches its field
+     *
+     * @param[in,out] member the control
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool resolveMember(Member &member, std::string &error);
+
+    /**
+     * Read or write a control, the card being opened
+     *
+     * @param[in,out] member the control
+     * @param[in] receive is true for a read, false for a write
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool accessMember(Member &member, bool receive, std::string &error);
+
+    /** Debug on */
+    bool _isDebugEnabled;
+    /** Controls, in field order */
+    std::vector<Member> _members;
+    /** Element values, sized for the largest control */
+    std::vector<long> _values;
+    /** Generation of the card the controls were resolved for */
+    uint32_t _cardGeneration;
+    /** Delayed error about the mapped block, empty if supported */
+    std::string _typeError;
+};
+
+template <class Backend>
+void AmixerControlGroup<Backend>::addMembers(
+    const CInstanceConfigurableElement *instanceConfigurableElement)
+{
+    const std::string names = getFormattedMappingValue();
+    std::vector<std::string> controlNames;
+    size_t start = 0;
+    size_t end;
+
+    while ((end = names.find('|', start)) != std::string::npos) {
+
+        controlNames.push_back(names.substr(start, end - start));
+        start = end + 1;
+    }
+    controlNames.push_back(names.substr(start));
+
+    if ((instanceConfigurableElement->getType() != CInstanceConfigurableElement::EParameterBlock) ||
+        (instanceConfigurableElement->getNbChildren() != controlNames.size())) {
+
+        _typeError = "Control group of " + std::to_string(controlNames.size()) +
+                     " controls requires a parameter block of as many fields";
+        return;
+    }
+    size_t blockOffset = instanceConfigurableElement->getOffset();
+    size_t maxCount = 0;
+
+    for (size_t index = 0; index < controlNames.size(); index++) {
+
+        const CInstanceConfigurableElement *field = instanceConfigurableElement->getChild(index);
+
+        if (field->getType() != CInstanceConfigurableElement::EParameter) {
+
+            _typeError = "Field " + field->getName() + " of a control group is not a parameter";
+            return;
+        }
+        uint32_t size = field->getFootPrint();
+        uint32_t scalarSize = size / std::max(field->getTypeElement()->getArrayLength(),
+                                              size_t{1});
+        const std::string &controlName = getDescriptorPool().getControlName(controlNames[index]);
+
+        getDescriptorPool().addControl(getCard(), controlName);
+
+        _members.push_back(Member(controlName, field, field->getOffset() - blockOffset, size,
+                                  scalarSize));
+        maxCount = std::max(maxCount, size_t{size / scalarSize});
+    }
+    _values.reserve(maxCount);
+}
+
+template <class Backend>
+bool AmixerControlGroup<Backend>::accessHW(bool receive, std::string &error)
+{
+#ifdef SIMULATION
+    if (receive) {
+
+        memset(getBlackboardLocation(), 0, getSize());
+    }
+    return true;
+#endif
+
+    // Check parameter type is ok (deferred error, no exceptions available :-()
+    if (!_typeError.empty()) {
+
+        error = _typeError;
+        return false;
+    }
+
+    // Generation first: a concurrent rebinding then at worst leads to a spurious resolution
+    uint32_t cardGeneration = getCard().generation;
+    int32_t cardIndex = getCardNumber();
+
+    if (cardIndex < 0) {
+
+        error = "Card " + getCardName() + " not found. Error: " + strerror(-cardIndex);
+        return false;
+    }
+    // The controls of a rebound card may have changed
+    if (cardGeneration != _cardGeneration) {
+
+        for (size_t index = 0; index < _members.size(); index++) {
+
+            _members[index].isResolved = false;
+        }
+        _cardGeneration = cardGeneration;
+    }
+
+    bool success = true;
+
+    // Backends all get the handle cached by the subsystem for the card
+    for (size_t index = 0; success && (index < _members.size()); index++) {
+
+        Member &member = _members[index];
+
+        if (!member.backend->open(getSubsystem(), getCard(), error)) {
+
+            error = "ALSA: Unable to open card " + getCardName() + ": " + error;
+            success = false;
+
+        } else {
+
+            success = accessMember(member, receive, error);
+            member.backend->close();
+        }
+        // The control of a failing member may have changed: it is resolved again
+        if (!success) {
+
+            member.isResolved = false;
+        }
+    }
+    return success;
+}
+
+template <class Backend>
+bool AmixerControlGroup<Backend>::resolveMember(Member &member, std::string &error)
+{
+    const std::string &controlName = *member.controlName;
+    Backend &backend = *member.backend;
+
+    if (!backend.resolve(controlName, error)) {
+
+        error = "ALSA: Unable to get element info " + controlName + ": " + error;
+        return false;
+    }
+    member.type = backend.getType();
+    member.count = backend.getCount();
+
+    // For Bytes control force scalar size to 1 byte
+    uint32_t scalarSize = (member.type == AmixerElementBytes) ? 1 : member.scalarSize;
+
+    if (member.type == AmixerElementUnknown) {
+
+        error = "ALSA: Unknown control element type while accessing alsa element " + controlName;
+        return false;
+    }
+    if ((member.type != AmixerElementBytes) && (member.scalarSize > sizeof(int))) {
+
+        error = "ALSA: Field of alsa element " + controlName + " is wider than an integer";
+        return false;
+    }
+    if (member.count * scalarSize != member.size) {
+
+        error = "ALSA: Control element count (" + std::to_string(member.count) +
+                ") and configurable scalar element count (" +
+                std::to_string(member.size / scalarSize) + ") of " + controlName + " mismatch";
+        return false;
+    }
+    member.isResolved = true;
+
+    return true;
+}
+
+template <class Backend>
+bool AmixerControlGroup<Backend>::accessMember(Member &member, bool receive, std::string &error)
+{
+    const std::string &controlName = *member.controlName;
+    Backend &backend = *member.backend;
+    uint8_t *location = getBlackboardLocation() + member.offset;
+
+    if (_isDebugEnabled) {
+
+        info() << (receive ? "Reading" : "Writing") << " alsa element " << controlName
+               << " of group " << getConfigurableElement()->getPath();
+    }
+    if (!member.isResolved && !resolveMember(member, error)) {
+
+        return false;
+    }
+
+    // Bytes go straight between the blackboard and the control
+    if (member.type == AmixerElementBytes) {
+
+        if (receive ? !backend.readBytes(location, member.count, error)
+                    : !backend.writeBytes(location, member.count, error)) {
+
+            error = "ALSA: Unable to " + std::string(receive ? "read" : "write") + " element " +
+                    controlName + ": " + error;
+            return false;
+        }
+        return true;
+    }
+    _values.resize(member.count);
+
+    if (receive) {
+
+        if (!backend.read(_values.data(), member.count, error)) {
+
+            error = "ALSA: Unable to read element " + controlName + ": " + error;
+            return false;
+        }
+        // Beware this code is OK on Little Endian machines only
+        for (uint32_t index = 0; index < member.count; index++) {
+
+            int value = _values[index];
+
+            memcpy(location + index * member.scalarSize, &value, member.scalarSize);
+        }
+        return true;
+    }
+    for (uint32_t index = 0; index < member.count; index++) {
+
+        int value = 0;
+
+        memcpy(&value, location + index * member.scalarSize, member.scalarSize);
+
+        // Take care of sign extension
+        _values[index] = toPlainInteger(member.element, value);
+    }
+    if (!backend.write(_values.data(), member.count, error)) {
+
+        error = "ALSA: Unable to write element " + controlName + ": " + error;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "AmixerDbScale.hpp"
+#include <math.h>
+
+/* TLV types and flags, from sound/tlv.h which cannot be included along with alsa-lib headers */
+enum TlvType
+{
+    TlvContainer = 0,
+    TlvDbScale = 1,
+    TlvDbLinear = 2,
+    TlvDbRange = 3,
+    TlvDbMinMax = 4,
+    TlvDbMinMaxMute = 5
+};
+
+static const uint32_t gTlvDbScaleMuteFlag = 0x10000;
+static const uint32_t gTlvDbScaleStepMask = 0xffff;
+/** Number of words of a TLV header (type and length) */
+static const size_t gTlvHeaderWords = 2;
+
+const int32_t AmixerDbScale::_muteGain;
+
+AmixerDbScale::AmixerDbScale()
+    : _gainByLevel(), _levelByGain(), _minLevel(0), _minGain(0), _gainStep(1), _controlKey(0),
+      _isValid(false)
+{
+}
+
+bool AmixerDbScale::isValidFor(uintptr_t controlKey) const
+{
+    return _isValid && (_controlKey == controlKey);
+}
+
+void AmixerDbScale::invalidate()
+{
+    _isValid = false;
+}
+
+bool AmixerDbScale::parseGain(const uint32_t *tlv, size_t tlvWords,
+                              int32_t minLevel, int32_t maxLevel, int32_t level, int32_t &gain)
+{
+    if (tlvWords < gTlvHeaderWords) {
+
+        return false;
+    }
+    uint32_t type = tlv[0];
+    size_t dataWords = tlv[1] / sizeof(uint32_t);
+    const uint32_t *data = tlv + gTlvHeaderWords;
+
+    if (dataWords > tlvWords - gTlvHeaderWords) {
+
+        return false;
+    }
+
+    switch (type) {
+
+    case TlvContainer: {
+
+        // First dB TLV of the container covering the level wins
+        size_t position = 0;
+        while (position + gTlvHeaderWords <= dataWords) {
+
+            if (parseGain(data + position, dataWords - position,
+                          minLevel, maxLevel, level, gain)) {
+                return true;
+            }
+            position += gTlvHeaderWords + data[position + 1] / sizeof(uint32_t);
+        }
+        return false;
+    }
+    case TlvDbRange: {
+
+        // Sequence of (min level, max level, TLV) sub ranges
+        size_t position = 0;
+        while (position + 2 + gTlvHeaderWords <= dataWords) {
+
+            int32_t rangeMin = static_cast<int32_t>(data[position]);
+            int32_t rangeMax = static_cast<int32_t>(data[position + 1]);
+
+            if ((level >= rangeMin) && (level <= rangeMax)) {
+
+                return parseGain(data + position + 2, dataWords - position - 2,
+                                 rangeMin, rangeMax, level, gain);
+            }
+            position += 2 + gTlvHeaderWords + data[position + 3] / sizeof(uint32_t);
+        }
+        return false;
+    }
+    case TlvDbScale: {
+
+        if (dataWords < 2) {
+
+            return false;
+        }
+        int32_t min = static_cast<int32_t>(data[0]);
+        int32_t step = data[1] & gTlvDbScaleStepMask;
+
+        if ((data[1] & gTlvDbScaleMuteFlag) && (level <= minLevel)) {
+
+            gain = _muteGain;
+        } else {
+
+            gain = min + (level - minLevel) * step;
+        }
+        return true;
+    }
+    case TlvDbMinMax:
+    case TlvDbMinMaxMute: {
+
+        if (dataWords < 2) {
+
+            return false;
+        }
+        int32_t min = static_cast<int32_t>(data[0]);
+        int32_t max = static_cast<int32_t>(data[1]);
+
+        if ((type == TlvDbMinMaxMute) && (level <= minLevel)) {
+
+            gain = _muteGain;
+        } else if (maxLevel <= minLevel) {
+
+            gain = min;
+        } else {
+
+            gain = min + static_cast<int32_t>(static_cast<int64_t>(max - min) *
+                                              (level - minLevel) / (maxLevel - minLevel));
+        }
+        return true;
+    }
+    case TlvDbLinear: {
+
+        if (dataWords < 2) {
+
+            return false;
+        }
+        int32_t min = static_cast<int32_t>(data[0]);
+        int32_t max = static_cast<int32_t>(data[1]);
+
+        // Same computation as alsa-lib's snd_tlv_convert_to_dB()
+        if ((level <= minLevel) || (maxLevel <= minLevel)) {
+
+            gain = (min <= _muteGain) ? _muteGain : min;
+        } else if (level >= maxLevel) {
+
+            gain = max;
+        } else {
+
+            double ratio = static_cast<double>(level - minLevel) / (maxLevel - minLevel);
+
+            if (min <= _muteGain) {
+
+                gain = static_cast<int32_t>(2000.0 * log10(ratio)) + max;
+            } else {
+
+                double linearMin = pow(10.0, min / 2000.0);
+                double linearMax = pow(10.0, max / 2000.0);
+
+                gain = static_cast<int32_t>(
+                    2000.0 * log10((linearMax - linearMin) * ratio + linearMin));
+            }
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+bool AmixerDbScale::build(uintptr_t controlKey, const uint32_t *tlv, size_t tlvSize,
+                          int32_t minLevel, int32_t maxLevel, std::string &error)
+{
+    _isValid = false;
+
+    if ((maxLevel < minLevel) ||
+        (static_cast<int64_t>(maxLevel) - minLevel >= static_cast<int64_t>(_maxTableSize))) {
+
+        error = "Unsupported level range [" + std::to_string(minLevel) + ", " +
+                std::to_string(maxLevel) + "] for a dB volume";
+        return false;
+    }
+    size_t levelCount = maxLevel - minLevel + 1;
+
+    // Level to gain table, and lowest non muting gain
+    _gainByLevel.assign(levelCount, _muteGain);
+    _minLevel = minLevel;
+    size_t firstAudible = levelCount;
+
+    for (size_t index = 0; index < levelCount; index++) {
+
+        int32_t &gain = _gainByLevel[index];
+
+        if (!parseGain(tlv, tlvSize / sizeof(uint32_t), minLevel, maxLevel,
+                       minLevel + static_cast<int32_t>(index), gain)) {
+
+            error = "Unsupported or incomplete dB TLV for level " +
+                    std::to_string(minLevel + static_cast<int32_t>(index));
+            return false;
+        }
+        if ((index != 0) && (gain < _gainByLevel[index - 1])) {
+
+            error = "dB TLV is not monotonic";
+            return false;
+        }
+        if ((gain != _muteGain) && (firstAudible == levelCount)) {
+
+            firstAudible = index;
+        }
+    }
+    if (firstAudible == levelCount) {
+
+        error = "dB TLV only describes muting levels";
+        return false;
+    }
+    _minGain = _gainByLevel[firstAudible];
+    int32_t maxGain = _gainByLevel.back();
+
+    // Gain step: greatest common divisor of all gain offsets, to keep the reverse table small
+    int32_t step = 0;
+    for (size_t index = firstAudible; index < levelCount; index++) {
+
+        int32_t offset = _gainByLevel[index] - _minGain;
+        while (offset != 0) {
+
+            int32_t remainder = step % offset;
+            step = offset;
+            offset = remainder;
+        }
+    }
+    _gainStep = (step != 0) ? step : 1;
+
+    size_t gainCount = (maxGain - _minGain) / _gainStep + 1;
+    if (gainCount > _maxTableSize) {
+
+        error = "dB range too wide: " + std::to_string(gainCount) + " gain steps";
+        return false;
+    }
+
+    // Gain to level table: highest level not louder than each gain step
+    _levelByGain.resize(gainCount);
+    size_t levelIndex = 0;
+    for (size_t index = 0; index < gainCount; index++) {
+
+        int32_t gain = _minGain + static_cast<int32_t>(index) * _gainStep;
+
+        while ((levelIndex + 1 < levelCount) && (_gainByLevel[levelIndex + 1] <= gain)) {
+
+            levelIndex++;
+        }
+        _levelByGain[index] = minLevel + static_cast<int32_t>(levelIndex);
+    }
+
+    _controlKey = controlKey;
+    _isValid = true;
+
+    return true;
+}
+
+int32_t AmixerDbScale::toLevel(int32_t gain) const
+{
+    if (gain < _minGain) {
+
+        return _minLevel;
+    }
+    size_t index = static_cast<size_t>((static_cast<int64_t>(gain) - _minGain) / _gainStep);
+
+    return index < _levelByGain.size() ? _levelByGain[index] : _levelByGain.back();
+}
+
+int32_t AmixerDbScale::toGain(int32_t level) const
+{
+    int64_t index = static_cast<int64_t>(level) - _minLevel;
+
+    if (index < 0) {
+
+        return _gainByLevel.front();
+    }
+    return index < static_cast<int64_t>(_gainByLevel.size()) ? _gainByLevel[index]
+                                                             : _gainByLevel.back();
+}
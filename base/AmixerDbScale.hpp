@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/**
+ * dB scale of an integer alsa mixer control.
+ *
+ * The scale is built once from the dB TLV of the control (dBscale, dBminmax, dBlinear or
+ * dBrange) and its level range. Both conversion directions are then served by a dense table
+ * lookup. Gains are expressed in hundredths of dB, as in alsa TLVs.
+ */
+class AmixerDbScale
+{
+public:
+    /** Gain reported for muting levels, as SND_CTL_TLV_DB_GAIN_MUTE */
+    static const int32_t _muteGain = -9999999;
+
+    AmixerDbScale();
+
+    /**
+     * Check whether the scale has been built from a control
+     *
+     * @param[in] controlKey backend specific identifier of the control (numid, handle...)
+     *
+     * @return true if the scale is up to date, false if it needs to be rebuilt
+     */
+    bool isValidFor(uintptr_t controlKey) const;
+
+    /** Drop the content of the scale, forcing a rebuild on next access */
+    void invalidate();
+
+    /**
+     * Build the conversion tables
+     *
+     * @param[in] controlKey backend specific identifier of the control the TLV belongs to
+     * @param[in] tlv dB TLV of the control, starting with its type and length words
+     * @param[in] tlvSize size of the TLV buffer in bytes
+     * @param[in] minLevel minimum level of the control
+     * @param[in] maxLevel maximum level of the control
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool build(uintptr_t controlKey, const uint32_t *tlv, size_t tlvSize,
+               int32_t minLevel, int32_t maxLevel, std::string &error);
+
+    /**
+     * Convert a gain into a control level
+     *
+     * @param[in] gain in hundredths of dB
+     *
+     * @return the highest level whose gain does not exceed the requested one, the minimum level
+     *         if there is none
+     */
+    int32_t toLevel(int32_t gain) const;
+
+    /**
+     * Convert a control level into a gain
+     *
+     * @param[in] level the control level, clamped to the control range
+     *
+     * @return the gain in hundredths of dB, _muteGain if the level mutes the control
+     */
+    int32_t toGain(int32_t level) const;
+
+    /** @return the lowest level of the control */
+    int32_t getMinLevel() const { return _minLevel; }
+
+    /** @return the lowest gain of the control which does not mute it */
+    int32_t getMinGain() const { return _minGain; }
+
+    /** @return true if the lowest level mutes the control, as flagged by its dB TLV */
+    bool hasMuteLevel() const
+    {
+        return !_gainByLevel.empty() && (_gainByLevel.front() == _muteGain);
+    }
+
+private:
+    /**
+     * Compute the gain of a level by walking a TLV
+     *
+     * @param[in] tlv the TLV to walk, starting with its type and length words
+     * @param[in] tlvWords size of the TLV buffer in 32 bits words
+     * @param[in] minLevel minimum level of the range the TLV applies to
+     * @param[in] maxLevel maximum level of the range the TLV applies to
+     * @param[in] level the level to convert
+     * @param[out] gain the gain of the level in hundredths of dB
+     *
+     * @return true if the TLV is supported and covers the level
+     */
+    static bool parseGain(const uint32_t *tlv, size_t tlvWords,
+                          int32_t minLevel, int32_t maxLevel, int32_t level, int32_t &gain);
+
+    /** Maximum number of entries of each table */
+    static const size_t _maxTableSize = 1 << 20;
+
+    /** Gain of each level, indexed by level - _minLevel */
+    std::vector<int32_t> _gainByLevel;
+    /** Level of each gain step, indexed by (gain - _minGain) / _gainStep */
+    std::vector<int32_t> _levelByGain;
+    /** Lowest level of the control */
+    int32_t _minLevel;
+    /** Lowest non muting gain of the control */
+    int32_t _minGain;
+    /** Greatest common divisor of the gain differences, step of _levelByGain */
+    int32_t _gainStep;
+    /** Identifier of the control the scale has been built from */
+    uintptr_t _controlKey;
+    /** False until the tables have been filled */
+    bool _isValid;
+};
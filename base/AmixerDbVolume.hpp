@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AmixerMutableVolume.hpp"
+#include "AmixerDbScale.hpp"
+#include <string>
+
+/** This class implements a mutable volume expressed in dB.
+ *
+ * The blackboard layout is the one of AmixerMutableVolume, the level being a gain in hundredths
+ * of dB. Gains are translated into control levels through the dB scale the backend builds once
+ * from the control TLV: there is no TLV walk on the access path.
+ *
+ * Muting writes the lowest level of the control, which is only silent when the TLV flags it as
+ * muting: otherwise a warning reports that mute is not supported by the control.
+ *
+ * The template parameter is AmixerControl or another mapping type: the resulting codec is
+ * instantiated over a backend through AmixerBackendControl.
+ */
+template <class SubsystemObjectBase>
+class AmixerDbVolume : public AmixerMutableVolume<SubsystemObjectBase>
+{
+public:
+    /**
+     * AmixerDbVolume Class constructor
+     *
+     * @param[in] mappingValue instantiation mapping value
+     * @param[in] instConfigElement pointer to configurable element instance
+     * @param[in] context contains the context mappings
+     */
+    AmixerDbVolume(const std::string &mappingValue,
+                   CInstanceConfigurableElement *instConfigElement,
+                   const CMappingContext &context,
+                   core::log::Logger& logger)
+        : AmixerMutableVolume<SubsystemObjectBase>(mappingValue, instConfigElement, context, logger),
+          _dbScale(), _isMuteWarned(false)
+    {
+    }
+
+protected:
+    AmixerDbScale *getDbScale() { return &_dbScale; }
+
+    int fromBlackboard();
+    void toBlackboard(int volumeLevel);
+
+private:
+    /** dB scale of the control */
+    AmixerDbScale _dbScale;
+    /** Whether muting a control without muting level has been reported */
+    bool _isMuteWarned;
+};
+
+template <class SubsystemObjectBase>
+int AmixerDbVolume<SubsystemObjectBase>::fromBlackboard()
+{
+    bool isMuted;
+    int gain = this->readVolume(isMuted);
+
+    if (!isMuted) {
+
+        return _dbScale.toLevel(gain);
+    }
+    // Without mute flag in the TLV, the lowest level is still audible
+    if (!_dbScale.hasMuteLevel() && !_isMuteWarned) {
+
+        _isMuteWarned = true;
+        this->warning() << "Mute is not supported by alsa element " << this->getControlName()
+                        << ": its dB scale has no muting level, muted writes set the lowest "
+                        << "audible gain";
+    }
+    return _dbScale.getMinLevel();
+}
+
+template <class SubsystemObjectBase>
+void AmixerDbVolume<SubsystemObjectBase>::toBlackboard(int volumeLevel)
+{
+    int gain = _dbScale.toGain(volumeLevel);
+
+    // A muting level is reported as muted at the lowest audible gain
+    if (gain == AmixerDbScale::_muteGain) {
+
+        this->writeVolume(true, _dbScale.getMinGain());
+    } else {
+
+        this->writeVolume(false, gain);
+    }
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AmixerControl.hpp"
+#include "AmixerEnumItemTable.hpp"
+#include "InstanceConfigurableElement.h"
+#include "MappingContext.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+
+/** This class implements an enumerated control addressed by item names.
+ *
+ * The mapped element is a string parameter holding the name of the selected item. Item names
+ * are translated through a table the backend builds once per control, so that the structure
+ * files do not depend on the item order of the driver.
+ *
+ * The template parameter is AmixerControl or another mapping type: the resulting codec is
+ * instantiated over a backend through AmixerBackendControl.
+ */
+template <class SubsystemObjectBase>
+class AmixerEnumControl : public SubsystemObjectBase
+{
+public:
+    /**
+     * AmixerEnumControl Class constructor
+     *
+     * @param[in] mappingValue instantiation mapping value
+     * @param[in] instConfigElement pointer to configurable element instance
+     * @param[in] context contains the context mappings
+     */
+    AmixerEnumControl(const std::string &mappingValue,
+                      CInstanceConfigurableElement *instConfigElement,
+                      const CMappingContext &context,
+                      core::log::Logger& logger)
+        : SubsystemObjectBase(mappingValue, instConfigElement, context, logger,
+                              instConfigElement->getFootPrint()),
+          _itemTable(),
+          _itemBuffer(instConfigElement->getFootPrint() + 1, '\0'),
+          _itemName()
+    {
+        // Item names are read into buffers sized once, accesses do not allocate
+        _itemName.reserve(instConfigElement->getFootPrint());
+
+        // Whole string is one scalar: only single element controls can be mapped
+        if (instConfigElement->getType() != CInstanceConfigurableElement::EStringParameter) {
+
+            this->setTypeIsSupported(false);
+        }
+    }
+
+protected:
+    AmixerEnumItemTable *getEnumItemTable() { return &_itemTable; }
+
+    int fromBlackboard();
+    void toBlackboard(int itemIndex);
+
+private:
+    /** Item names of the control */
+    AmixerEnumItemTable _itemTable;
+    /** Blackboard string, with room for a terminator */
+    std::vector<char> _itemBuffer;
+    /** Item name looked up in the table */
+    std::string _itemName;
+};
+
+template <class SubsystemObjectBase>
+int AmixerEnumControl<SubsystemObjectBase>::fromBlackboard()
+{
+    const size_t stringSize = this->getScalarSize();
+
+    _itemBuffer[stringSize] = '\0';
+    this->blackboardRead(_itemBuffer.data(), stringSize);
+
+    _itemName.assign(_itemBuffer.data());
+    int32_t itemIndex = _itemTable.getIndex(_itemName);
+
+    if (itemIndex < 0) {
+
+        // Let the driver reject the out of range index
+        this->warning() << "Unknown item '" << _itemName << "' for alsa element "
+                        << this->getControlName();
+    }
+    return itemIndex;
+}
+
+template <class SubsystemObjectBase>
+void AmixerEnumControl<SubsystemObjectBase>::toBlackboard(int itemIndex)
+{
+    const size_t stringSize = this->getScalarSize();
+
+    std::fill(_itemBuffer.begin(), _itemBuffer.end(), '\0');
+
+    // Keep room for the string terminator
+    _itemTable.getName(itemIndex).copy(_itemBuffer.data(), stringSize - 1);
+
+    this->blackboardWrite(_itemBuffer.data(), stringSize);
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "AmixerEnumItemTable.hpp"
+
+AmixerEnumItemTable::AmixerEnumItemTable() : _indexes(), _names(), _controlKey(0), _isValid(false)
+{
+}
+
+bool AmixerEnumItemTable::isValidFor(uintptr_t controlKey, uint32_t itemCount) const
+{
+    return _isValid && (_controlKey == controlKey) && (_names.size() == itemCount);
+}
+
+void AmixerEnumItemTable::invalidate()
+{
+    _isValid = false;
+}
+
+void AmixerEnumItemTable::reset(uintptr_t controlKey, uint32_t itemCount)
+{
+    _indexes.clear();
+    _indexes.reserve(itemCount);
+    _names.clear();
+    _names.reserve(itemCount);
+    _controlKey = controlKey;
+    _isValid = true;
+}
+
+void AmixerEnumItemTable::addItem(const std::string &itemName)
+{
+    // In case of duplicated names, the first item wins as it would in a linear search
+    _indexes.insert(std::make_pair(itemName, static_cast<uint32_t>(_names.size())));
+    _names.push_back(itemName);
+}
+
+int32_t AmixerEnumItemTable::getIndex(const std::string &itemName) const
+{
+    IndexMap::const_iterator it = _indexes.find(itemName);
+
+    return it != _indexes.end() ? static_cast<int32_t>(it->second) : -1;
+}
+
+const std::string &AmixerEnumItemTable::getName(uint32_t index) const
+{
+    static const std::string unknownItem;
+
+    return index < _names.size() ? _names[index] : unknownItem;
+}
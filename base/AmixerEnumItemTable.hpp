@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/**
+ * Item name table of an enumerated alsa mixer control.
+ *
+ * The table is filled once by the backend from the control's item names, then used to translate
+ * item names into item indexes (and back) with a single hash lookup per access. It is bound to the
+ * control it has been built from and has to be rebuilt when this control or its item count change.
+ */
+class AmixerEnumItemTable
+{
+public:
+    AmixerEnumItemTable();
+
+    /**
+     * Check whether the table still matches a control
+     *
+     * @param[in] controlKey backend specific identifier of the control (numid, handle...)
+     * @param[in] itemCount current number of items of the control
+     *
+     * @return true if the table is up to date, false if it needs to be rebuilt
+     */
+    bool isValidFor(uintptr_t controlKey, uint32_t itemCount) const;
+
+    /** Drop the content of the table, forcing a rebuild on next access */
+    void invalidate();
+
+    /**
+     * Start a rebuild of the table
+     *
+     * @param[in] controlKey backend specific identifier of the control the items belong to
+     * @param[in] itemCount number of items about to be added
+     */
+    void reset(uintptr_t controlKey, uint32_t itemCount);
+
+    /**
+     * Append an item to the table, its index being the current item count
+     *
+     * @param[in] itemName the name of the item
+     */
+    void addItem(const std::string &itemName);
+
+    /**
+     * Translate an item name into its index
+     *
+     * @param[in] itemName the name of the item
+     *
+     * @return the index of the item, -1 if the control has no such item
+     */
+    int32_t getIndex(const std::string &itemName) const;
+
+    /**
+     * Translate an item index into its name
+     *
+     * @param[in] index the index of the item
+     *
+     * @return the name of the item, empty if the index is out of range
+     */
+    const std::string &getName(uint32_t index) const;
+
+private:
+    typedef std::unordered_map<std::string, uint32_t> IndexMap;
+
+    /** Item name to item index map */
+    IndexMap _indexes;
+    /** Item names, by index */
+    std::vector<std::string> _names;
+    /** Identifier of the control the table has been built from */
+    uintptr_t _controlKey;
+    /** False until the table has been filled */
+    bool _isValid;
+};
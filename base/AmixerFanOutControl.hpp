@@ -0,0 +1,519 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AmixerControl.hpp"
+#include "AmixerElementType.hpp"
+#include "AlsaMappingKeys.hpp"
+#include "InstanceConfigurableElement.h"
+#include "MappingContext.h"
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <system_error>
+
+/**
+ * Alsa mixer control programmed identically on several cards.
+ *
+ * The Card mapping key lists the cards, separated by '|': writes convert the blackboard once and
+ * issue the element write on all the cards concurrently. Each card past the first has a worker
+ * thread, started along with the control and woken up on each write. A card failing does not
+ * prevent the others from being written, the error naming each failing card. A card whose worker
+ * thread cannot be created is written by the caller. Reads come from the first card, which the
+ * control is bound to.
+ *
+ * The Backend policy is the one of AmixerBackendControl. Values are plain integers or bytes: the
+ * translation tables, startup state, change events and cache of single card controls are not
+ * supported, nor are ramps. Fan-out writes wait for the workers: they are not real-time safe.
+ */
+template <class Backend>
+class AmixerFanOutControl : public AmixerControl
+{
+public:
+    /**
+     * AmixerFanOutControl Class constructor
+     *
+     * @param[in] mappingValue instantiation mapping value
+     * @param[in] instanceConfigurableElement pointer to configurable element instance
+     * @param[in] context contains the context mappings
+     */
+    AmixerFanOutControl(const std::string &mappingValue,
+                        CInstanceConfigurableElement *instanceConfigurableElement,
+                        const CMappingContext &context,
+                        core::log::Logger& logger)
+        : AmixerControl(mappingValue, instanceConfigurableElement, context, logger), _targets(),
+          _values(), _writeType(AmixerElementUnknown), _writeCount(0)
+    {
+        addCards(context);
+
+        if (getScalarSize() != 0) {
+
+            _values.reserve(getSize() / getScalarSize());
+        }
+    }
+
+    virtual ~AmixerFanOutControl();
+
+protected:
+    virtual bool accessHW(bool receive, std::string &error);
+
+private:
+    /** Thread writing one of the cards past the first */
+    struct Worker
+    {
+        Worker() : lock(), wakeUp(), isWritePending(false), isStopRequested(false), thread() {}
+
+        std::mutex lock;
+        /** Signaled on write and stop requests, and once a write is done */
+        std::condition_variable wakeUp;
+        /** Set by the caller to request a write, cleared by the worker once done */
+        bool isWritePending;
+        bool isStopRequested;
+        std::thread thread;
+    };
+
+    /** Control on one of the cards */
+    struct Target
+    {
+        explicit Target(const AlsaCardDescriptor &targetCard)
+            : card(&targetCard), backend(new Backend), worker(), isResolved(false),
+              isSuccessful(false), error()
+        {
+        }
+
+        const AlsaCardDescriptor *card;
+        std::unique_ptr<Backend> backend;
+        /** NULL for the first card, or if no thread could be created: the caller writes it */
+        std::unique_ptr<Worker> worker;
+        /** The control was found with the expected type and count */
+        bool isResolved;
+        /** Status of the last write */
+        bool isSuccessful;
+        /** Cause of the last failure on this card */
+        std::string error;
+    };
+
+    /**
+     * Add the cards of the Card mapping key, each one once
+     *
+     * @param[in] context contains the context mappings
+     */
+    void addCards(const CMappingContext &context);
+
+    /**
+     * Worker thread main loop, writing a card on each write request until stopped
+     *
+     * @param[in,out] target the control on the card
+     * @param[in,out] worker the worker of the card
+     */
+    void runWorker(Target *target, Worker *worker);
+
+    /**
+     * Open a card and look its control up, checking it matches the parameter
+     *
+     * @param[in,out] target the control on the card, holding the error on failure
+     * @param[out] type element type of the control
+     * @param[out] count number of elements, or bytes
+     *
+     * @return true if no error
+     */
+    bool resolveTarget(Target &target, AmixerElementType &type, uint32_t &count);
+
+    /**
+     * Write the converted values on a resolved card, from the caller or the worker of the card
+     *
+     * @param[in,out] target the control on the card, holding the error on failure
+     * @param[in] type element type of the control
+     * @param[in] count number of elements, or bytes
+     */
+    void writeTarget(Target &target, AmixerElementType type, uint32_t count);
+
+    /**
+     * Read the control of the first card into the blackboard
+     *
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool readFirstTarget(std::string &error);
+
+    /**
+     * Write the control on all the cards
+     *
+     * @param[out] error string containing the errors of all the failing cards
+     *
+     * @return true if all the cards were written
+     */
+    bool writeTargets(std::string &error);
+
+    /** Controls on each card, the first one being the card of the object */
+    std::vector<Target> _targets;
+    /** Element values converted once for all the cards */
+    std::vector<long> _values;
+    /** Element type and count of the ongoing write, for the workers */
+    AmixerElementType _writeType;
+    uint32_t _writeCount;
+};
+
+template <class Backend>
+AmixerFanOutControl<Backend>::~AmixerFanOutControl()
+{
+    for (size_t index = 0; index < _targets.size(); index++) {
+
+        Worker *worker = _targets[index].worker.get();
+
+        if (worker == NULL) {
+
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> guard(worker->lock);
+
+            worker->isStopRequested = true;
+        }
+        worker->wakeUp.notify_all();
+        worker->thread.join();
+    }
+}
+
+template <class Backend>
+void AmixerFanOutControl<Backend>::addCards(const CMappingContext &context)
+{
+    std::vector<std::string> cardNames = getCardNames(context);
+    std::vector<std::string>::const_iterator it;
+
+    _targets.push_back(Target(getCard()));
+
+    for (it = cardNames.begin(); it != cardNames.end(); ++it) {
+
+        const AlsaCardDescriptor &card = getDescriptorPool().getCard(*it);
+        bool isAdded = false;
+
+        for (size_t index = 0; index < _targets.size(); index++) {
+
+            isAdded = isAdded || (_targets[index].card == &card);
+        }
+        if (isAdded) {
+
+            continue;
+        }
+        // Other cards are tracked as the card of the object
+        getDescriptorPool().addControl(card, getControlName());
+
+        if (context.iSet(AlsaResyncOnArrival)) {
+
+            getDescriptorPool().enableResync(card);
+        }
+        getAlsaSubsystem().prepareCard(card, context);
+        _targets.push_back(Target(card));
+    }
+
+    // Targets no longer move: the workers are given their address
+    for (size_t index = 1; index < _targets.size(); index++) {
+
+        std::unique_ptr<Worker> worker(new Worker);
+
+        try {
+
+            worker->thread = std::thread(&AmixerFanOutControl::runWorker, this, &_targets[index],
+                                         worker.get());
+        } catch (const std::system_error &) {
+
+            // Out of threads: the card is written by the caller instead
+            continue;
+        }
+        _targets[index].worker = std::move(worker);
+    }
+}
+
+template <class Backend>
+void AmixerFanOutControl<Backend>::runWorker(Target *target, Worker *worker)
+{
+    std::unique_lock<std::mutex> guard(worker->lock);
+
+    while (true) {
+
+        worker->wakeUp.wait(guard, [worker] {
+            return worker->isWritePending || worker->isStopRequested;
+        });
+
+        if (worker->isStopRequested) {
+
+            return;
+        }
+        // The caller waits for the write, the element type and count are stable
+        guard.unlock();
+        writeTarget(*target, _writeType, _writeCount);
+        guard.lock();
+
+        worker->isWritePending = false;
+        worker->wakeUp.notify_all();
+    }
+}
+
+template <class Backend>
+bool AmixerFanOutControl<Backend>::accessHW(bool receive, std::string &error)
+{
+#ifdef SIMULATION
+    if (receive) {
+
+        memset(getBlackboardLocation(), 0, getSize());
+    }
+    logControlInfo(receive);
+
+    return true;
+#endif
+
+    logControlInfo(receive);
+
+    if (!isTypeSupported()) {
+
+        error = "Parameter type not supported.";
+        return false;
+    }
+    return receive ? readFirstTarget(error) : writeTargets(error);
+}
+
+template <class Backend>
+bool AmixerFanOutControl<Backend>::resolveTarget(Target &target, AmixerElementType &type,
+                                                 uint32_t &count)
+{
+    const std::string &controlName = getControlName();
+    Backend &backend = *target.backend;
+
+    target.isResolved = false;
+
+    if (target.card->index < 0) {
+
+        target.error = "card not found. Error: " + std::string(strerror(-target.card->index));
+        return false;
+    }
+    if (!backend.open(getSubsystem(), *target.card, target.error)) {
+
+        target.error = "ALSA: Unable to open card: " + target.error;
+        return false;
+    }
+    if (!backend.resolve(controlName, target.error)) {
+
+        target.error = "ALSA: Unable to get element info " + controlName + ": " + target.error;
+        return false;
+    }
+    type = backend.getType();
+    count = backend.getCount();
+
+    // For Bytes control force scalar size to 1 byte
+    uint32_t scalarSize = (type == AmixerElementBytes) ? 1 : getScalarSize();
+
+    if (type == AmixerElementUnknown) {
+
+        target.error = "ALSA: Unknown control element type while accessing alsa element " +
+                       controlName;
+        return false;
+    }
+    if (count * scalarSize != getSize()) {
+
+        target.error = "ALSA: Control element count (" + std::to_string(count) +
+                       ") and configurable scalar element count (" +
+                       std::to_string(getSize() / scalarSize) + ") mismatch";
+        return false;
+    }
+    target.isResolved = true;
+
+    return true;
+}
+
+template <class Backend>
+bool AmixerFanOutControl<Backend>::readFirstTarget(std::string &error)
+{
+    Target &target = _targets.front();
+    AmixerElementType type = AmixerElementUnknown;
+    uint32_t count = 0;
+    bool success = resolveTarget(target, type, count);
+
+    if (success && (type == AmixerElementBytes)) {
+
+        success = target.backend->readBytes(getBlackboardLocation(), count, target.error);
+
+        if (success) {
+
+            logControlBytes(true, getBlackboardLocation(), count);
+        }
+    } else if (success) {
+
+        _values.resize(count);
+        success = target.backend->read(_values.data(), count, target.error);
+
+        for (uint32_t index = 0; success && (index < count); index++) {
+
+            toBlackboard(_values[index]);
+        }
+    }
+    target.backend->close();
+
+    if (!success) {
+
+        error = "Card " + target.card->name + ": " + target.error;
+    }
+    return success;
+}
+
+template <class Backend>
+void AmixerFanOutControl<Backend>::writeTarget(Target &target, AmixerElementType type,
+                                               uint32_t count)
+{
+    if (type == AmixerElementBytes) {
+
+        target.isSuccessful = target.backend->writeBytes(getBlackboardLocation(), count,
+                                                         target.error);
+    } else {
+
+        target.isSuccessful = target.backend->write(_values.data(), count, target.error);
+    }
+    if (!target.isSuccessful) {
+
+        target.error = "ALSA: Unable to write element " + getControlName() + ": " + target.error;
+    }
+}
+
+template <class Backend>
+bool AmixerFanOutControl<Backend>::writeTargets(std::string &error)
+{
+    AmixerElementType type = AmixerElementUnknown;
+    uint32_t count = 0;
+    bool isConverted = false;
+
+    // Cards are opened by the caller: the handles cached by the subsystem are not shared
+    for (size_t index = 0; index < _targets.size(); index++) {
+
+        Target &target = _targets[index];
+        AmixerElementType targetType = AmixerElementUnknown;
+        uint32_t targetCount = 0;
+
+        target.isSuccessful = resolveTarget(target, targetType, targetCount);
+
+        if (!target.isSuccessful) {
+
+            continue;
+        }
+        if (!isConverted) {
+
+            type = targetType;
+            count = targetCount;
+            isConverted = true;
+
+        } else if ((targetType != type) || (targetCount != count)) {
+
+            target.error = "ALSA: Element " + getControlName() + " does not match the one of "
+                           "the other cards";
+            target.isResolved = target.isSuccessful = false;
+        }
+    }
+
+    // Values are converted once for all the cards
+    if (isConverted && (type == AmixerElementBytes)) {
+
+        logControlBytes(false, getBlackboardLocation(), count);
+
+    } else if (isConverted) {
+
+        _values.resize(count);
+
+        for (uint32_t index = 0; index < count; index++) {
+
+            _values[index] = fromBlackboard();
+
+            if (isDebugEnabled()) {
+
+                info() << "Writing alsa element " << getControlName() << " on "
+                       << _targets.size() << " cards, index " << index << " with value "
+                       << _values[index];
+            }
+        }
+    }
+
+    // The workers write their card while the caller writes the others
+    _writeType = type;
+    _writeCount = count;
+
+    for (size_t index = 0; index < _targets.size(); index++) {
+
+        Target &target = _targets[index];
+
+        if (target.isResolved && (target.worker != NULL)) {
+
+            std::lock_guard<std::mutex> guard(target.worker->lock);
+
+            target.worker->isWritePending = true;
+            target.worker->wakeUp.notify_all();
+        }
+    }
+    for (size_t index = 0; index < _targets.size(); index++) {
+
+        Target &target = _targets[index];
+
+        if (target.isResolved && (target.worker == NULL)) {
+
+            writeTarget(target, type, count);
+        }
+    }
+    for (size_t index = 0; index < _targets.size(); index++) {
+
+        Worker *worker = _targets[index].worker.get();
+
+        if (worker != NULL) {
+
+            std::unique_lock<std::mutex> guard(worker->lock);
+
+            worker->wakeUp.wait(guard, [worker] { return !worker->isWritePending; });
+        }
+    }
+
+    // Errors of all the failing cards are reported
+    error.clear();
+
+    for (size_t index = 0; index < _targets.size(); index++) {
+
+        Target &target = _targets[index];
+
+        target.backend->close();
+
+        if (!target.isSuccessful) {
+
+            error += (error.empty() ? "" : "; ") + ("Card " + target.card->name) + ": " +
+                     target.error;
+        }
+    }
+    return error.empty();
+}
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AmixerControl.hpp"
+#include "AlsaMappingKeys.hpp"
+#include "InstanceConfigurableElement.h"
+#include "TypeElement.h"
+#include "MappingContext.h"
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/** This class implements a mutable volume with one level per channel.
+ *
+ * The parameter is a block of a muted flag on one byte, followed by an array of levels holding
+ * one level per element of the control. The whole block is moved between the blackboard and
+ * the element values in one pass, and written by the backend in a single element write: muting
+ * sets all the channels to the mute level. Levels read from the hardware are reported unmuted.
+ *
+ * When the "Ramp" mapping key gives a duration in milliseconds, written levels are reached
+ * through a linear ramp run by the subsystem ramp engine instead of at once.
+ *
+ * The template parameter is AmixerControl or another mapping type: the resulting codec is
+ * instantiated over a backend through AmixerBackendControl.
+ */
+template <class SubsystemObjectBase>
+class AmixerMultiChannelVolume : public SubsystemObjectBase
+{
+private:
+    typedef int8_t MutedState;
+
+    /** Indexes of mute and levels children parameters in the parameter tree */
+    enum MultiChannelVolumeChildren
+    {
+        muted = 0,
+        levels
+    };
+
+public:
+    /**
+     * AmixerMultiChannelVolume Class constructor
+     *
+     * @param[in] mappingValue instantiation mapping value
+     * @param[in] instConfigElement pointer to configurable element instance
+     * @param[in] context contains the context mappings
+     */
+    AmixerMultiChannelVolume(const std::string &mappingValue,
+                             CInstanceConfigurableElement *instConfigElement,
+                             const CMappingContext &context,
+                             core::log::Logger& logger)
+        : SubsystemObjectBase(mappingValue, instConfigElement, context, logger),
+          _levelCount(0),
+          _levelSize(0),
+          _isSigned(false),
+          _volume(),
+          _rampDuration(context.iSet(AlsaRampTime) ? context.getItemAsInteger(AlsaRampTime) : 0)
+    {
+        if ((instConfigElement->getType() == CInstanceConfigurableElement::EParameterBlock) &&
+            (instConfigElement->getNbChildren() == 2) &&
+            (instConfigElement->getChild(muted)->getFootPrint() == sizeof(MutedState))) {
+
+            const CInstanceConfigurableElement *levelsElement = instConfigElement->getChild(levels);
+
+            _levelCount = levelsElement->getTypeElement()->getArrayLength();
+
+            if (_levelCount != 0) {
+
+                _levelSize = levelsElement->getFootPrint() / _levelCount;
+            }
+            // Sign extension is told once from the top bit of a level, instead of on each access
+            _isSigned = (_levelSize < sizeof(int)) && (_levelSize != 0) &&
+                        (this->toPlainInteger(levelsElement, 1 << (_levelSize * 8 - 1)) < 0);
+        }
+        if (((_levelSize == sizeof(int8_t)) || (_levelSize == sizeof(int16_t)) ||
+             (_levelSize == sizeof(int32_t))) &&
+            (this->getSize() == sizeof(MutedState) + _levelCount * _levelSize)) {
+
+            // The block is staged here, so that accesses do not allocate
+            _volume.resize(this->getSize());
+        } else {
+
+            this->setTypeIsSupported(false);
+        }
+    }
+
+protected:
+    uint32_t getBlackboardElementCount() const { return _levelCount; }
+
+    bool fromBlackboardValues(long *values, uint32_t count);
+
+    template <typename Value>
+    bool toBlackboardValues(const Value *values, uint32_t count);
+
+    uint32_t getRampDuration() const { return _rampDuration; }
+
+private:
+    /**
+     * Widen the levels of the staged block into element values
+     *
+     * @param[out] values the element values
+     * @param[in] count the number of elements
+     */
+    template <typename Level>
+    void readLevels(long *values, uint32_t count) const;
+
+    /**
+     * Narrow element values into the levels of the staged block
+     *
+     * @param[in] values the element values
+     * @param[in] count the number of elements
+     */
+    template <typename Level, typename Value>
+    void writeLevels(const Value *values, uint32_t count);
+
+    static const int muteLevelValue = 0;
+    /** Number of channels, matching the element count of the control */
+    uint32_t _levelCount;
+    /** Size of each level in bytes */
+    size_t _levelSize;
+    /** Levels are sign extended */
+    bool _isSigned;
+    /** Blackboard content of the volume: muted flag, then the levels */
+    std::vector<uint8_t> _volume;
+    /** Duration of the ramps applied on writes, in milliseconds */
+    uint32_t _rampDuration;
+};
+
+#include <cassert>
+
+template <class SubsystemObjectBase>
+template <typename Level>
+void AmixerMultiChannelVolume<SubsystemObjectBase>::readLevels(long *values, uint32_t count) const
+{
+    const uint8_t *levels = &_volume[sizeof(MutedState)];
+
+    // Fixed size copies, for the compiler to turn the loop into vector loads and widenings
+    for (uint32_t index = 0; index < count; index++) {
+
+        Level level;
+
+        memcpy(&level, levels + index * sizeof(Level), sizeof(Level));
+        values[index] = level;
+    }
+}
+
+template <class SubsystemObjectBase>
+template <typename Level, typename Value>
+void AmixerMultiChannelVolume<SubsystemObjectBase>::writeLevels(const Value *values,
+                                                                uint32_t count)
+{
+    uint8_t *levels = &_volume[sizeof(MutedState)];
+
+    for (uint32_t index = 0; index < count; index++) {
+
+        Level level = static_cast<Level>(values[index]);
+
+        memcpy(levels + index * sizeof(Level), &level, sizeof(Level));
+    }
+}
+
+template <class SubsystemObjectBase>
+bool AmixerMultiChannelVolume<SubsystemObjectBase>::fromBlackboardValues(long *values,
+                                                                         uint32_t count)
+{
+    assert(count == _levelCount);
+
+    // The muted flag and all the levels are read at once
+    this->blackboardRead(_volume.data(), _volume.size());
+
+    if (_volume.front() != 0) {
+
+        std::fill(values, values + count, static_cast<long>(muteLevelValue));
+        return true;
+    }
+    switch (_levelSize) {
+    case sizeof(int8_t):
+        _isSigned ? readLevels<int8_t>(values, count) : readLevels<uint8_t>(values, count);
+        break;
+    case sizeof(int16_t):
+        _isSigned ? readLevels<int16_t>(values, count) : readLevels<uint16_t>(values, count);
+        break;
+    default:
+        readLevels<int32_t>(values, count);
+        break;
+    }
+    return true;
+}
+
+template <class SubsystemObjectBase>
+template <typename Value>
+bool AmixerMultiChannelVolume<SubsystemObjectBase>::toBlackboardValues(const Value *values,
+                                                                       uint32_t count)
+{
+    assert(count == _levelCount);
+
+    _volume.front() = false;
+
+    switch (_levelSize) {
+    case sizeof(int8_t):
+        writeLevels<int8_t>(values, count);
+        break;
+    case sizeof(int16_t):
+        writeLevels<int16_t>(values, count);
+        break;
+    default:
+        writeLevels<int32_t>(values, count);
+        break;
+    }
+    // The muted flag and all the levels are written at once
+    this->blackboardWrite(_volume.data(), _volume.size());
+
+    return true;
+}
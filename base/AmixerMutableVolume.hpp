@@ -30,14 +30,18 @@
 #pragma once
 
 #include "AmixerControl.hpp"
+#include "AlsaMappingKeys.hpp"
 #include "InstanceConfigurableElement.h"
 #include "MappingContext.h"
 #include <string>
 
 /** This class implements a mutable volume.
  *
- * The template parameter must be a subsystemObject
- * using the virtual from and to blackboard functions.
+ * When the "Ramp" mapping key gives a duration in milliseconds, written levels are reached
+ * through a linear ramp run by the subsystem ramp engine instead of at once.
+ *
+ * The template parameter is AmixerControl or another mapping type: the resulting codec is
+ * instantiated over a backend through AmixerBackendControl.
  */
 template <class SubsystemObjectBase>
 class AmixerMutableVolume : public SubsystemObjectBase
@@ -77,7 +81,8 @@ public:
                         const CMappingContext &context,
                         core::log::Logger& logger)
         : SubsystemObjectBase(mappingValue, instConfigElement, context, logger),
-          _volumeLevelConfigurableElement(NULL)
+          _volumeLevelConfigurableElement(NULL),
+          _rampDuration(context.iSet(AlsaRampTime) ? context.getItemAsInteger(AlsaRampTime) : 0)
     {
         if ((instConfigElement->getType() == CInstanceConfigurableElement::EParameterBlock) &&
             (this->getScalarSize() <= sizeof(MutableVolume)) &&
@@ -95,19 +100,40 @@ public:
     }
 
 protected:
-    virtual int fromBlackboard();
-    virtual void toBlackboard(int volumeLevel);
+    int fromBlackboard();
+    void toBlackboard(int volumeLevel);
+
+    uint32_t getRampDuration() const { return _rampDuration; }
+
+    /**
+     * Read the mutable volume from the blackboard
+     *
+     * @param[out] isMuted the muted state
+     *
+     * @return the volume level, sign extended
+     */
+    int readVolume(bool &isMuted);
+
+    /**
+     * Write a mutable volume to the blackboard
+     *
+     * @param[in] isMuted the muted state
+     * @param[in] volumeLevel the volume level
+     */
+    void writeVolume(bool isMuted, int volumeLevel);
 
 private:
     static const int muteLevelValue = 0;
     /** Pointer on configurable element corresponding to volume level */
     const CInstanceConfigurableElement *_volumeLevelConfigurableElement;
+    /** Duration of the ramps applied on writes, in milliseconds */
+    uint32_t _rampDuration;
 };
 
 #include <cassert>
 
 template <class SubsystemObjectBase>
-int AmixerMutableVolume<SubsystemObjectBase>::fromBlackboard()
+int AmixerMutableVolume<SubsystemObjectBase>::readVolume(bool &isMuted)
 {
     const size_t volumeSize = this->getScalarSize();
     assert(volumeSize <= sizeof(MutableVolume));
@@ -118,20 +144,36 @@ int AmixerMutableVolume<SubsystemObjectBase>::fromBlackboard()
     };
     this->blackboardRead(&volume, volumeSize);
 
+    isMuted = volume.muted;
+
     // Take care of sign extension
-    return this->toPlainInteger(_volumeLevelConfigurableElement,
-                                volume.muted ? muteLevelValue : volume.level);
+    return this->toPlainInteger(_volumeLevelConfigurableElement, volume.level);
 }
 
 template <class SubsystemObjectBase>
-void AmixerMutableVolume<SubsystemObjectBase>::toBlackboard(int volumeLevel)
+void AmixerMutableVolume<SubsystemObjectBase>::writeVolume(bool isMuted, int volumeLevel)
 {
     const size_t volumeSize = this->getScalarSize();
     assert(volumeSize <= sizeof(MutableVolume));
 
     // Be aware that this code does not work in big endian if volumeSize < sizeof(MutableVolume)
     const MutableVolume volume = {
-        false, volumeLevel
+        isMuted, volumeLevel
     };
     this->blackboardWrite(&volume, volumeSize);
 }
+
+template <class SubsystemObjectBase>
+int AmixerMutableVolume<SubsystemObjectBase>::fromBlackboard()
+{
+    bool isMuted;
+    int volumeLevel = readVolume(isMuted);
+
+    return isMuted ? muteLevelValue : volumeLevel;
+}
+
+template <class SubsystemObjectBase>
+void AmixerMutableVolume<SubsystemObjectBase>::toBlackboard(int volumeLevel)
+{
+    writeVolume(false, volumeLevel);
+}
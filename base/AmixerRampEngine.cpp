@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "AmixerRampEngine.hpp"
+#include <algorithm>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+
+AmixerRampEngine::AmixerRampEngine()
+    : _lock(), _ramps(), _worker(), _timerFd(-1), _eventFd(-1), _isTimerArmed(false),
+      _isStopRequested(false)
+{
+}
+
+AmixerRampEngine::~AmixerRampEngine()
+{
+    stop();
+}
+
+bool AmixerRampEngine::startRamp(const void *owner, int32_t cardIndex, AmixerRampWriter *writer,
+                                 const std::vector<long> &from, const std::vector<long> &to,
+                                 uint32_t durationMs, std::string &error)
+{
+    std::unique_ptr<AmixerRampWriter> newWriter(writer);
+    std::lock_guard<std::mutex> guard(_lock);
+
+    if (from.size() != to.size()) {
+
+        error = "Ramp start and target channel counts mismatch";
+        return false;
+    }
+    if (!startWorker(error)) {
+
+        return false;
+    }
+    Ramp &ramp = _ramps[RampKey(cardIndex, owner)];
+
+    // A running ramp is retargeted from where it stands
+    if (!ramp.writer || (ramp.current.size() != to.size())) {
+
+        ramp.current = from;
+    }
+    ramp.writer = std::move(newWriter);
+    ramp.from = ramp.current;
+    ramp.to = to;
+    ramp.next.resize(to.size());
+    ramp.start = Clock::now();
+    ramp.duration = std::chrono::milliseconds(durationMs);
+
+    setTimer(true);
+
+    return true;
+}
+
+void AmixerRampEngine::stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+
+        _isStopRequested = true;
+        _ramps.clear();
+    }
+    if (_worker.joinable()) {
+
+        wakeUp();
+        _worker.join();
+    }
+    if (_timerFd >= 0) {
+
+        close(_timerFd);
+        _timerFd = -1;
+    }
+    if (_eventFd >= 0) {
+
+        close(_eventFd);
+        _eventFd = -1;
+    }
+    _isTimerArmed = false;
+    _isStopRequested = false;
+}
+
+void AmixerRampEngine::stop(int32_t cardIndex)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    RampMap::iterator it = _ramps.begin();
+
+    while (it != _ramps.end()) {
+
+        if (it->first.first == cardIndex) {
+
+            it = _ramps.erase(it);
+        } else {
+
+            ++it;
+        }
+    }
+    // The timer is disarmed by the next tick if no ramp is left
+}
+
+bool AmixerRampEngine::startWorker(std::string &error)
+{
+    if (_worker.joinable()) {
+
+        return true;
+    }
+    if (_timerFd < 0) {
+
+        _timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    }
+    if (_eventFd < 0) {
+
+        _eventFd = eventfd(0, EFD_CLOEXEC);
+    }
+    if ((_timerFd < 0) || (_eventFd < 0)) {
+
+        error = std::string("Unable to create volume ramp timer: ") + strerror(errno);
+        return false;
+    }
+    _worker = std::thread(&AmixerRampEngine::run, this);
+
+    return true;
+}
+
+void AmixerRampEngine::run()
+{
+    struct pollfd pollFds[] = {
+        { _timerFd, POLLIN, 0 },
+        { _eventFd, POLLIN, 0 }
+    };
+
+    while (true) {
+
+        if (poll(pollFds, sizeof(pollFds) / sizeof(pollFds[0]), -1) < 0) {
+
+            if (errno == EINTR) {
+
+                continue;
+            }
+            break;
+        }
+        // Acknowledge timer expirations and wake up events
+        uint64_t counter;
+        for (size_t index = 0; index < sizeof(pollFds) / sizeof(pollFds[0]); index++) {
+
+            if ((pollFds[index].revents & POLLIN) &&
+                (read(pollFds[index].fd, &counter, sizeof(counter)) < 0)) {
+
+                counter = 0;
+            }
+        }
+
+        std::lock_guard<std::mutex> guard(_lock);
+
+        if (_isStopRequested) {
+
+            break;
+        }
+        tick();
+    }
+}
+
+void AmixerRampEngine::tick()
+{
+    Clock::time_point now = Clock::now();
+
+    RampMap::iterator it = _ramps.begin();
+    while (it != _ramps.end()) {
+
+        Ramp &ramp = it->second;
+        Clock::duration elapsed = now - ramp.start;
+        bool isDone = elapsed >= ramp.duration;
+        double progress = isDone ? 1. : static_cast<double>(elapsed.count()) /
+                                        ramp.duration.count();
+
+        for (size_t channel = 0; channel < ramp.to.size(); channel++) {
+
+            ramp.next[channel] = ramp.from[channel] + static_cast<long>(
+                (ramp.to[channel] - ramp.from[channel]) * progress);
+        }
+
+        // Only write when a level actually changes
+        bool isWritten = true;
+        if (ramp.next != ramp.current) {
+
+            isWritten = ramp.writer->writeLevels(ramp.next.data(), ramp.next.size());
+            std::copy(ramp.next.begin(), ramp.next.end(), ramp.current.begin());
+        }
+
+        // A failing control is not retried
+        if (isDone || !isWritten) {
+
+            it = _ramps.erase(it);
+        } else {
+
+            ++it;
+        }
+    }
+    if (_ramps.empty()) {
+
+        setTimer(false);
+    }
+}
+
+void AmixerRampEngine::setTimer(bool isEnabled)
+{
+    if (isEnabled == _isTimerArmed) {
+
+        return;
+    }
+    struct itimerspec timerSpec;
+    memset(&timerSpec, 0, sizeof(timerSpec));
+
+    if (isEnabled) {
+
+        timerSpec.it_value.tv_nsec = _tickPeriodMs * 1000000L;
+        timerSpec.it_interval = timerSpec.it_value;
+    }
+    _isTimerArmed = timerfd_settime(_timerFd, 0, &timerSpec, NULL) == 0 ? isEnabled
+                                                                          : _isTimerArmed;
+}
+
+void AmixerRampEngine::wakeUp()
+{
+    uint64_t event = 1;
+
+    if (write(_eventFd, &event, sizeof(event)) < 0) {
+
+        // Only happens on a closed descriptor, when there is no worker to wake up
+        return;
+    }
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <chrono>
+
+/**
+ * Backend specific writer of a ramped volume control.
+ * It is owned by the ramp engine and only used from its worker thread.
+ */
+class AmixerRampWriter
+{
+public:
+    virtual ~AmixerRampWriter() {}
+
+    /**
+     * Write the levels of all the channels of the control, in a single control write
+     *
+     * @param[in] levels one level per channel
+     * @param[in] count number of channels
+     *
+     * @return true if no error
+     */
+    virtual bool writeLevels(const long *levels, size_t count) = 0;
+};
+
+/**
+ * Volume ramp engine.
+ *
+ * Ramps are executed by a worker thread woken up by a periodic timerfd, which is only armed while
+ * ramps are running. All the ramps progress on the same tick, card by card, and a control is only
+ * written when one of its levels changes.
+ */
+class AmixerRampEngine
+{
+public:
+    AmixerRampEngine();
+    ~AmixerRampEngine();
+
+    /**
+     * Start a ramp, or retarget the running ramp of the same owner from its current levels
+     *
+     * @param[in] owner the object the ramp belongs to
+     * @param[in] cardIndex index of the card of the control, ramps are batched per card
+     * @param[in] writer writer of the control levels, ownership is transferred to the engine
+     * @param[in] from current levels of the control
+     * @param[in] to target levels of the control
+     * @param[in] durationMs ramp duration in milliseconds
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool startRamp(const void *owner, int32_t cardIndex, AmixerRampWriter *writer,
+                   const std::vector<long> &from, const std::vector<long> &to,
+                   uint32_t durationMs, std::string &error);
+
+    /** Stop the worker thread, dropping all the running ramps */
+    void stop();
+
+    /**
+     * Drop the running ramps of a card, before releasing the handles their writers rely on
+     *
+     * @param[in] cardIndex index of the card
+     */
+    void stop(int32_t cardIndex);
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    /** Ramp of a control */
+    struct Ramp
+    {
+        std::unique_ptr<AmixerRampWriter> writer;
+        std::vector<long> from;
+        std::vector<long> to;
+        /** Last written levels */
+        std::vector<long> current;
+        /** Levels of the ongoing step */
+        std::vector<long> next;
+        Clock::time_point start;
+        Clock::duration duration;
+    };
+
+    /** Ramps are sorted by card so that a tick programs each card in a row */
+    typedef std::pair<int32_t, const void *> RampKey;
+    typedef std::map<RampKey, Ramp> RampMap;
+
+    /**
+     * Create the timer and the worker thread if not done yet
+     *
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool startWorker(std::string &error);
+
+    /** Worker thread main loop */
+    void run();
+
+    /** Advance all the ramps, called with the lock held */
+    void tick();
+
+    /**
+     * Arm or disarm the tick timer
+     *
+     * @param[in] isEnabled true to arm the timer
+     */
+    void setTimer(bool isEnabled);
+
+    /** Wake up the worker thread */
+    void wakeUp();
+
+    /** Tick period */
+    static const uint32_t _tickPeriodMs = 5;
+
+    std::mutex _lock;
+    RampMap _ramps;
+    std::thread _worker;
+    /** Periodic tick timer */
+    int _timerFd;
+    /** Worker wake up event, for new ramps and stop requests */
+    int _eventFd;
+    bool _isTimerArmed;
+    bool _isStopRequested;
+};
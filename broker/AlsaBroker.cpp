@@ -0,0 +1,698 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "BrokerProtocol.hpp"
+#include "AmixerElementType.hpp"
+#include "AlsaDescriptorPool.hpp"
+#include <alsa/asoundlib.h>
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ctype.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/* from sound/asound.h, header is not compatible with alsa/asoundlib.h
+ */
+struct snd_ctl_tlv {
+    unsigned int numid;     /* control element numeric identification */
+    unsigned int length;    /* in bytes aligned to 4 */
+    unsigned char tlv[];    /* first TLV */
+};
+
+/** Set on SIGINT or SIGTERM */
+static volatile sig_atomic_t gIsStopping = 0;
+
+static void stop(int)
+{
+    gIsStopping = 1;
+}
+
+/**
+ * Serves the control operations of the clients.
+ * Each card is opened once, and its elements are looked up once by name: their info is kept
+ * until an access fails because the card or the element went away.
+ */
+class ControlBroker
+{
+public:
+    ControlBroker() : _cards() {}
+
+    ~ControlBroker()
+    {
+        while (!_cards.empty()) {
+
+            dropCard(_cards.begin());
+        }
+    }
+
+    /**
+     * Serve a batch of operations
+     *
+     * @param[in] request the request message
+     * @param[in] requestSize size of the request message
+     * @param[out] reply buffer of the reply message, of gBrokerMaxMessageSize bytes
+     *
+     * @return the size of the reply, 0 if the request is malformed
+     */
+    size_t serve(const uint8_t *request, size_t requestSize, uint8_t *reply)
+    {
+        BrokerMessage message;
+        size_t offset = sizeof(message);
+        size_t replySize = sizeof(message);
+
+        if (requestSize < sizeof(message)) {
+
+            return 0;
+        }
+        memcpy(&message, request, sizeof(message));
+
+        if (message.count > gBrokerMaxBatchSize) {
+
+            return 0;
+        }
+        memcpy(reply, &message, sizeof(message));
+
+        for (uint32_t index = 0; index < message.count; index++) {
+
+            BrokerRequest operation;
+
+            if (requestSize - offset < sizeof(operation)) {
+
+                return 0;
+            }
+            memcpy(&operation, request + offset, sizeof(operation));
+            offset += sizeof(operation);
+
+            if (requestSize - offset <
+                static_cast<size_t>(operation.cardSize) + operation.controlSize +
+                operation.payloadSize) {
+
+                return 0;
+            }
+            std::string card(reinterpret_cast<const char *>(request + offset),
+                             operation.cardSize);
+            offset += operation.cardSize;
+            std::string control(reinterpret_cast<const char *>(request + offset),
+                                operation.controlSize);
+            offset += operation.controlSize;
+            const uint8_t *payload = request + offset;
+            offset += operation.payloadSize;
+
+            if (gBrokerMaxMessageSize - replySize < sizeof(BrokerReply)) {
+
+                return 0;
+            }
+            BrokerReply result;
+            uint8_t *replyPayload = reply + replySize + sizeof(result);
+
+            memset(&result, 0, sizeof(result));
+            result.status = execute(operation, card, control, payload, result, replyPayload,
+                                    gBrokerMaxMessageSize - replySize - sizeof(result));
+            if (result.status < 0) {
+
+                result.payloadSize = 0;
+            }
+            memcpy(reply + replySize, &result, sizeof(result));
+            replySize += sizeof(result) + result.payloadSize;
+        }
+        return replySize;
+    }
+
+private:
+    /** Element of a card, looked up once */
+    struct Element
+    {
+        Element() : info(NULL), value(NULL) {}
+        ~Element()
+        {
+            if (value != NULL) {
+
+                snd_ctl_elem_value_free(value);
+            }
+            if (info != NULL) {
+
+                snd_ctl_elem_info_free(info);
+            }
+        }
+
+        snd_ctl_elem_info_t *info;
+        /** Bound to the element */
+        snd_ctl_elem_value_t *value;
+    };
+    typedef std::map<std::string, std::unique_ptr<Element> > ElementMap;
+
+    struct Card
+    {
+        snd_ctl_t *handle;
+        /** Elements, by control name or numid */
+        ElementMap elements;
+    };
+    typedef std::map<std::string, Card> CardMap;
+
+    void dropCard(CardMap::iterator card)
+    {
+        snd_ctl_close(card->second.handle);
+        _cards.erase(card);
+    }
+
+    /** @return 0 on success, a negative error code otherwise */
+    int getCard(const std::string &name, CardMap::iterator &card)
+    {
+        card = _cards.find(name);
+
+        if (card != _cards.end()) {
+
+            return 0;
+        }
+        int cardIndex = snd_card_get_index(name.c_str());
+        char deviceName[16];
+        snd_ctl_t *handle;
+        int ret;
+
+        if (cardIndex < 0) {
+
+            return cardIndex;
+        }
+        snprintf(deviceName, sizeof(deviceName), "hw:%d", cardIndex);
+
+        if ((ret = snd_ctl_open(&handle, deviceName, 0)) < 0) {
+
+            return ret;
+        }
+        Card newCard = { handle, ElementMap() };
+        card = _cards.insert(std::make_pair(name, std::move(newCard))).first;
+
+        return 0;
+    }
+
+    /** @return 0 on success, a negative error code otherwise */
+    int getElement(Card &card, const std::string &name, Element *&element)
+    {
+        ElementMap::iterator it = card.elements.find(name);
+
+        if (it != card.elements.end()) {
+
+            element = it->second.get();
+            return 0;
+        }
+        std::unique_ptr<Element> newElement(new Element);
+        snd_ctl_elem_id_t *id;
+        int ret;
+
+        if ((snd_ctl_elem_info_malloc(&newElement->info) < 0) ||
+            (snd_ctl_elem_value_malloc(&newElement->value) < 0)) {
+
+            return -ENOMEM;
+        }
+        snd_ctl_elem_id_alloca(&id);
+        snd_ctl_elem_id_set_interface(id, SND_CTL_ELEM_IFACE_MIXER);
+
+        // Controls are mapped by name or numid
+        if (isdigit(static_cast<unsigned char>(name[0]))) {
+
+            uint32_t numid;
+
+            if (!AlsaDescriptorPool::parseControlNumber(name, numid)) {
+
+                return -EINVAL;
+            }
+            snd_ctl_elem_id_set_numid(id, numid);
+        } else {
+
+            snd_ctl_elem_id_set_name(id, name.c_str());
+        }
+        snd_ctl_elem_info_set_id(newElement->info, id);
+
+        if ((ret = snd_ctl_elem_info(card.handle, newElement->info)) < 0) {
+
+            return ret;
+        }
+        // The info holds the complete identifier
+        snd_ctl_elem_info_get_id(newElement->info, id);
+        snd_ctl_elem_value_set_id(newElement->value, id);
+
+        element = newElement.get();
+        card.elements[name] = std::move(newElement);
+
+        return 0;
+    }
+
+    /**
+     * Execute an operation, looking the card and the element up again if they went away
+     *
+     * @return 0 on success, a negative error code otherwise
+     */
+    int execute(const BrokerRequest &request, const std::string &cardName,
+                const std::string &controlName, const uint8_t *payload, BrokerReply &reply,
+                uint8_t *replyPayload, size_t capacity)
+    {
+        int ret = 0;
+
+        for (int attempt = 0; attempt < 2; attempt++) {
+
+            CardMap::iterator card;
+            Element *element;
+
+            if ((ret = getCard(cardName, card)) < 0) {
+
+                return ret;
+            }
+            if ((ret = getElement(card->second, controlName, element)) == 0) {
+
+                ret = access(request, card->second.handle, *element, payload, reply,
+                             replyPayload, capacity);
+            }
+            if ((ret == -ENODEV) || (ret == -EBADFD)) {
+
+                // Card removed, or rebound
+                dropCard(card);
+            } else if (ret == -ENOENT) {
+
+                // Element removed: its numid may have changed
+                card->second.elements.erase(controlName);
+            } else {
+
+                return ret;
+            }
+        }
+        return ret;
+    }
+
+    static AmixerElementType getType(const snd_ctl_elem_info_t *info)
+    {
+        switch (snd_ctl_elem_info_get_type(info)) {
+        case SND_CTL_ELEM_TYPE_BOOLEAN:
+            return AmixerElementBoolean;
+        case SND_CTL_ELEM_TYPE_INTEGER:
+            return AmixerElementInteger;
+        case SND_CTL_ELEM_TYPE_INTEGER64:
+            return AmixerElementInteger64;
+        case SND_CTL_ELEM_TYPE_ENUMERATED:
+            return AmixerElementEnumerated;
+        case SND_CTL_ELEM_TYPE_BYTES:
+            return AmixerElementBytes;
+        default:
+            return AmixerElementUnknown;
+        }
+    }
+
+    /** @return 0 on success, a negative error code otherwise */
+    int access(const BrokerRequest &request, snd_ctl_t *handle, Element &element,
+               const uint8_t *payload, BrokerReply &reply, uint8_t *replyPayload,
+               size_t capacity)
+    {
+        snd_ctl_elem_info_t *info = element.info;
+        snd_ctl_elem_value_t *value = element.value;
+        snd_ctl_elem_type_t type = snd_ctl_elem_info_get_type(info);
+        uint32_t count = snd_ctl_elem_info_get_count(info);
+        int ret;
+
+        reply.type = getType(info);
+        reply.count = count;
+        reply.itemCount = type == SND_CTL_ELEM_TYPE_ENUMERATED ?
+                          snd_ctl_elem_info_get_items(info) : 0;
+        reply.numid = snd_ctl_elem_info_get_numid(info);
+
+        switch (request.operation) {
+        case BrokerResolve:
+            return 0;
+
+        case BrokerRead:
+            count = std::min(count, request.argument);
+
+            if (count * sizeof(int64_t) > capacity) {
+
+                return -ENOBUFS;
+            }
+            if ((ret = snd_ctl_elem_read(handle, value)) < 0) {
+
+                return ret;
+            }
+            for (uint32_t index = 0; index < count; index++) {
+
+                int64_t level;
+
+                switch (type) {
+                case SND_CTL_ELEM_TYPE_BOOLEAN:
+                    level = snd_ctl_elem_value_get_boolean(value, index);
+                    break;
+                case SND_CTL_ELEM_TYPE_INTEGER:
+                    level = snd_ctl_elem_value_get_integer(value, index);
+                    break;
+                case SND_CTL_ELEM_TYPE_INTEGER64:
+                    level = snd_ctl_elem_value_get_integer64(value, index);
+                    break;
+                default:
+                    level = snd_ctl_elem_value_get_enumerated(value, index);
+                    break;
+                }
+                memcpy(replyPayload + index * sizeof(level), &level, sizeof(level));
+            }
+            reply.payloadSize = count * sizeof(int64_t);
+            return 0;
+
+        case BrokerWrite:
+            count = std::min<uint32_t>(count, request.payloadSize / sizeof(int64_t));
+
+            for (uint32_t index = 0; index < count; index++) {
+
+                int64_t level;
+
+                memcpy(&level, payload + index * sizeof(level), sizeof(level));
+
+                switch (type) {
+                case SND_CTL_ELEM_TYPE_BOOLEAN:
+                    snd_ctl_elem_value_set_boolean(value, index, level);
+                    break;
+                case SND_CTL_ELEM_TYPE_INTEGER:
+                    snd_ctl_elem_value_set_integer(value, index, level);
+                    break;
+                case SND_CTL_ELEM_TYPE_INTEGER64:
+                    snd_ctl_elem_value_set_integer64(value, index, level);
+                    break;
+                default:
+                    snd_ctl_elem_value_set_enumerated(value, index, level);
+                    break;
+                }
+            }
+            return snd_ctl_elem_write(handle, value);
+
+        case BrokerReadBytes:
+            return readBytes(handle, element, request.argument, reply, replyPayload, capacity);
+
+        case BrokerWriteBytes:
+            return writeBytes(handle, element, payload, request.payloadSize);
+
+        case BrokerItemName: {
+            snd_ctl_elem_info_t *itemInfo;
+            snd_ctl_elem_id_t *id;
+
+            snd_ctl_elem_info_alloca(&itemInfo);
+            snd_ctl_elem_id_alloca(&id);
+
+            snd_ctl_elem_info_get_id(info, id);
+            snd_ctl_elem_info_set_id(itemInfo, id);
+            snd_ctl_elem_info_set_item(itemInfo, request.argument);
+
+            if ((ret = snd_ctl_elem_info(handle, itemInfo)) < 0) {
+
+                return ret;
+            }
+            const char *name = snd_ctl_elem_info_get_item_name(itemInfo);
+
+            reply.payloadSize = std::min(strlen(name), capacity);
+            memcpy(replyPayload, name, reply.payloadSize);
+            return 0;
+        }
+        case BrokerDbTlv: {
+            snd_ctl_elem_id_t *id;
+
+            if (!snd_ctl_elem_info_is_tlv_readable(info)) {
+
+                return -EOPNOTSUPP;
+            }
+            if (request.argument > capacity) {
+
+                return -ENOBUFS;
+            }
+            snd_ctl_elem_id_alloca(&id);
+            snd_ctl_elem_info_get_id(info, id);
+
+            // The TLV buffer is aligned by the reply layout only: read it aside
+            std::vector<unsigned int> tlv((request.argument + sizeof(unsigned int) - 1) /
+                                          sizeof(unsigned int));
+
+            if ((ret = snd_ctl_elem_tlv_read(handle, id, tlv.data(), request.argument)) < 0) {
+
+                return ret;
+            }
+            memcpy(replyPayload, tlv.data(), request.argument);
+            reply.payloadSize = request.argument;
+            reply.min = snd_ctl_elem_info_get_min(info);
+            reply.max = snd_ctl_elem_info_get_max(info);
+            return 0;
+        }
+        default:
+            return -EINVAL;
+        }
+    }
+
+    /** @return 0 on success, a negative error code otherwise */
+    int readBytes(snd_ctl_t *handle, Element &element, size_t size, BrokerReply &reply,
+                  uint8_t *replyPayload, size_t capacity)
+    {
+        int ret;
+
+        // The value only holds the bytes of the control
+        if (size > snd_ctl_elem_info_get_count(element.info)) {
+
+            return -EINVAL;
+        }
+        if (size > capacity) {
+
+            return -ENOBUFS;
+        }
+        // Special hook for TLV Bytes Control
+        if (snd_ctl_elem_info_is_tlv_readable(element.info)) {
+
+            std::vector<unsigned int> rawTlv((sizeof(struct snd_ctl_tlv) + size +
+                                              sizeof(unsigned int) - 1) / sizeof(unsigned int));
+            struct snd_ctl_tlv *tlv = reinterpret_cast<struct snd_ctl_tlv *>(rawTlv.data());
+            snd_ctl_elem_id_t *id;
+
+            snd_ctl_elem_id_alloca(&id);
+            snd_ctl_elem_info_get_id(element.info, id);
+
+            if ((ret = snd_ctl_elem_tlv_read(handle, id, rawTlv.data(),
+                                             rawTlv.size() * sizeof(unsigned int))) < 0) {
+
+                return ret;
+            }
+            memcpy(replyPayload, tlv->tlv, size);
+        } else {
+
+            if ((ret = snd_ctl_elem_read(handle, element.value)) < 0) {
+
+                return ret;
+            }
+            memcpy(replyPayload, snd_ctl_elem_value_get_bytes(element.value), size);
+        }
+        reply.payloadSize = size;
+
+        return 0;
+    }
+
+    /** @return 0 on success, a negative error code otherwise */
+    int writeBytes(snd_ctl_t *handle, Element &element, const uint8_t *data, size_t size)
+    {
+        // Larger contents are asserted against by alsa-lib
+        if (size > snd_ctl_elem_info_get_count(element.info)) {
+
+            return -EINVAL;
+        }
+        // Special hook for TLV Bytes Control
+        if (snd_ctl_elem_info_is_tlv_writable(element.info)) {
+
+            std::vector<unsigned int> rawTlv((sizeof(struct snd_ctl_tlv) + size +
+                                              sizeof(unsigned int) - 1) / sizeof(unsigned int));
+            struct snd_ctl_tlv *tlv = reinterpret_cast<struct snd_ctl_tlv *>(rawTlv.data());
+            snd_ctl_elem_id_t *id;
+
+            snd_ctl_elem_id_alloca(&id);
+            snd_ctl_elem_info_get_id(element.info, id);
+
+            tlv->numid = 0;
+            tlv->length = size;
+            memcpy(tlv->tlv, data, size);
+
+            return snd_ctl_elem_tlv_write(handle, id, rawTlv.data());
+        }
+        snd_ctl_elem_id_t *id;
+
+        // A shorter content is padded with zeros, as tinyalsa does, not with the previous bytes
+        snd_ctl_elem_id_alloca(&id);
+        snd_ctl_elem_info_get_id(element.info, id);
+        snd_ctl_elem_value_clear(element.value);
+        snd_ctl_elem_value_set_id(element.value, id);
+        snd_ctl_elem_set_bytes(element.value, const_cast<uint8_t *>(data), size);
+
+        return snd_ctl_elem_write(handle, element.value);
+    }
+
+    CardMap _cards;
+};
+
+/** @return the listening socket, -1 on error */
+static int listenOn(const std::string &path)
+{
+    struct sockaddr_un address;
+    int bufferSize = gBrokerMaxMessageSize;
+    int listener;
+
+    if (path.size() >= sizeof(address.sun_path)) {
+
+        std::cerr << "Socket path too long: " << path << std::endl;
+        return -1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path.c_str(), path.size());
+
+    // A socket left over by a previous instance is replaced
+    unlink(path.c_str());
+
+    if (((listener = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0)) < 0) ||
+        (setsockopt(listener, SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize)) < 0) ||
+        (bind(listener, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) < 0) ||
+        (listen(listener, SOMAXCONN) < 0)) {
+
+        std::cerr << "Unable to listen on " << path << ": " << strerror(errno) << std::endl;
+        if (listener >= 0) {
+
+            close(listener);
+        }
+        return -1;
+    }
+    return listener;
+}
+
+static void usage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [-s socket]\n"
+              << "  -s: socket to listen on, defaults to " << gBrokerDefaultSocket << "\n";
+}
+
+int main(int argc, char *argv[])
+{
+    std::string path = gBrokerDefaultSocket;
+    int option;
+
+    while ((option = getopt(argc, argv, "s:h")) != -1) {
+
+        switch (option) {
+        case 's':
+            path = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (optind != argc) {
+
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    // Signals interrupt poll instead of restarting it
+    struct sigaction action;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = stop;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    int listener = listenOn(path);
+
+    if (listener < 0) {
+
+        return EXIT_FAILURE;
+    }
+    ControlBroker broker;
+    std::vector<uint8_t> request(gBrokerMaxMessageSize);
+    std::vector<uint8_t> reply(gBrokerMaxMessageSize);
+    std::vector<struct pollfd> fds(1);
+
+    fds[0].fd = listener;
+    fds[0].events = POLLIN;
+
+    // Requests are served one at a time: the handles are not shared between threads
+    while (!gIsStopping) {
+
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+
+            if (errno == EINTR) {
+
+                continue;
+            }
+            std::cerr << "Unable to wait for the clients: " << strerror(errno) << std::endl;
+            break;
+        }
+        for (size_t index = fds.size() - 1; index > 0; index--) {
+
+            if (fds[index].revents == 0) {
+
+                continue;
+            }
+            ssize_t size = recv(fds[index].fd, request.data(), request.size(), MSG_TRUNC);
+            size_t replySize = 0;
+
+            // Malformed requests close the connection
+            if ((size > 0) && (static_cast<size_t>(size) <= request.size())) {
+
+                replySize = broker.serve(request.data(), size, reply.data());
+            }
+            if ((replySize == 0) ||
+                (send(fds[index].fd, reply.data(), replySize, MSG_NOSIGNAL) < 0)) {
+
+                close(fds[index].fd);
+                fds.erase(fds.begin() + index);
+            }
+        }
+        if (fds[0].revents & POLLIN) {
+
+            struct pollfd client = { accept4(listener, NULL, NULL, SOCK_CLOEXEC), POLLIN, 0 };
+
+            if (client.fd >= 0) {
+
+                int bufferSize = gBrokerMaxMessageSize;
+
+                setsockopt(client.fd, SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize));
+                fds.push_back(client);
+            }
+        }
+    }
+    for (size_t index = 0; index < fds.size(); index++) {
+
+        close(fds[index].fd);
+    }
+    unlink(path.c_str());
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "BrokerAlsaSubsystem.hpp"
+#include "BrokerAmixerControl.hpp"
+#include "AlsaSnapshotControl.hpp"
+#include "AmixerFanOutControl.hpp"
+#include "AmixerControlGroup.hpp"
+#include "AmixerByteFile.hpp"
+#include "SubsystemObjectFactory.h"
+#include "MappingContext.h"
+#include "AlsaMappingKeys.hpp"
+#include "AmixerMutableVolume.hpp"
+#include "AmixerMultiChannelVolume.hpp"
+#include "AmixerEnumControl.hpp"
+#include "AmixerDbVolume.hpp"
+#include <string>
+
+BrokerAlsaSubsystem::BrokerAlsaSubsystem(const std::string &name, core::log::Logger& logger) :
+    AlsaSubsystem(name, logger), _client()
+{
+    // Provide creators to upper layer
+    // Streams are opened by the process using them: there is no PortConfig
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<BrokerAmixerControl<> >("Control", 1 << AlsaCard)
+        );
+
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<BrokerAmixerControl<> >(
+            "ByteControl", 1 << AlsaCard)
+        );
+
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<AmixerByteFile<BrokerAmixerBackend> >(
+            "ByteFile", 1 << AlsaCard)
+        );
+
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<
+            BrokerAmixerControl<AmixerMutableVolume<AmixerControl> > >("Volume", 1 << AlsaCard)
+        );
+
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<
+            BrokerAmixerControl<AmixerMultiChannelVolume<AmixerControl> > >(
+            "MultiChannelVolume", 1 << AlsaCard)
+        );
+
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<
+            BrokerAmixerControl<AmixerDbVolume<AmixerControl> > >("DbVolume", 1 << AlsaCard)
+        );
+
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<
+            BrokerAmixerControl<AmixerEnumControl<AmixerControl> > >("EnumControl", 1 << AlsaCard)
+        );
+
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<AmixerFanOutControl<BrokerAmixerBackend> >(
+            "FanOutControl", 1 << AlsaCard)
+        );
+
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<AmixerControlGroup<BrokerAmixerBackend> >(
+            "ControlGroup", 1 << AlsaCard)
+        );
+
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<AlsaSnapshotControl<BrokerAmixerBackend> >(
+            "Snapshot", 1 << AlsaCard)
+        );
+}
+
+BrokerAlsaSubsystem::~BrokerAlsaSubsystem()
+{
+    // Ramp writers rely on the connection
+    stopRamps();
+
+    // Saved while the daemon is still connected
+    storeStartupState<BrokerAmixerBackend>();
+}
+
+void BrokerAlsaSubsystem::prepareCard(const AlsaCardDescriptor &/*card*/,
+                                      const CMappingContext &context)
+{
+    if (context.iSet(AlsaBrokerSocket)) {
+
+        _client.setPath(context.getItem(AlsaBrokerSocket));
+    }
+}
@@ -29,33 +29,37 @@
  */
 #pragma once
 
-#include "TinyAmixerControl.hpp"
+#include "AlsaSubsystem.hpp"
+#include "BrokerClient.hpp"
 #include <string>
 
 /**
- * Class to handle alsa mixer controls through tiny alsa.
+ * Alsa subsystem forwarding the control accesses to the alsa-broker daemon.
+ * The daemon holds the handles, element metadata and name lookups of the cards, shared
+ * by all the processes it serves.
  */
-class TinyAmixerControlValue : public TinyAmixerControl
+class BrokerAlsaSubsystem : public AlsaSubsystem
 {
 public:
+    BrokerAlsaSubsystem(const std::string &name, core::log::Logger& logger);
+    ~BrokerAlsaSubsystem();
+
     /**
-     * TinyAMixerIntegerControl Class constructor
+     * Take the socket of the daemon from the Broker key, if set
      *
-     * @param[in] mappingValue instantiation mapping value
-     * @param[in] instanceConfigurableElement pointer to configurable element instance
-     * @param[in] context contains the context mappings
+     * @param[in] card the card descriptor, unused
+     * @param[in] context contains the context mappings of the object
      */
-    TinyAmixerControlValue(const std::string &mappingValue,
-                           CInstanceConfigurableElement *instanceConfigurableElement,
-                           const CMappingContext &context,
-                           core::log::Logger& logger);
+    virtual void prepareCard(const AlsaCardDescriptor &card, const CMappingContext &context);
 
-protected:
-    virtual bool readControl(struct mixer_ctl *mixerControl,
-                             size_t elementCount,
-                             std::string &error);
+    /**
+     * Get the connection to the daemon
+     *
+     * @return the connection, shared by the objects of the subsystem
+     */
+    BrokerClient &getClient() { return _client; }
 
-    virtual bool writeControl(struct mixer_ctl *mixerControl,
-                              size_t elementCount,
-                              std::string &error);
+private:
+    /** Connection to the daemon, outlives the ramps */
+    BrokerClient _client;
 };
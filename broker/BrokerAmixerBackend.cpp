@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "BrokerAmixerBackend.hpp"
+#include "BrokerAmixerRampWriter.hpp"
+#include "BrokerAlsaSubsystem.hpp"
+#include <algorithm>
+#include <string.h>
+#include <string>
+
+BrokerAmixerBackend::BrokerAmixerBackend()
+    : _client(NULL), _card(NULL), _cardIndex(-1), _generation(0), _controlName(NULL),
+      _resolvedCard(NULL), _resolvedGeneration(0), _resolvedName(NULL),
+      _type(AmixerElementUnknown), _count(0), _itemCount(0), _numid(0), _values(),
+      _requestCount(0)
+{
+}
+
+bool BrokerAmixerBackend::open(const CSubsystem *subsystem, const AlsaCardDescriptor &card,
+                               std::string &/*error*/)
+{
+    // getClient is non-const; we need to forcefully remove the constness
+    // then, we need to cast the generic subsystem into a BrokerAlsaSubsystem.
+    _client = &static_cast<BrokerAlsaSubsystem *>(const_cast<CSubsystem *>(subsystem))
+        ->getClient();
+
+    // Generation first: the index is then at least as recent
+    _generation = card.generation;
+    _cardIndex = card.index;
+    _card = &card;
+    _requestCount = 0;
+
+    return true;
+}
+
+bool BrokerAmixerBackend::resolve(const std::string &controlName, std::string &error)
+{
+    _controlName = &controlName;
+
+    // Names are interned: the metadata is kept for a name on a binding of a card
+    if ((&controlName == _resolvedName) && (_card == _resolvedCard) &&
+        (_generation == _resolvedGeneration)) {
+
+        return true;
+    }
+    BrokerClient::Operation operation = {
+        BrokerResolve, 0, &_card->name, &controlName, NULL, 0, NULL, 0, BrokerReply()
+    };
+    if (!request(operation, error)) {
+
+        return false;
+    }
+    _type = static_cast<AmixerElementType>(operation.reply.type);
+    _count = operation.reply.count;
+    _itemCount = operation.reply.itemCount;
+    _numid = operation.reply.numid;
+    _values.resize(_count);
+
+    _resolvedName = &controlName;
+    _resolvedCard = _card;
+    _resolvedGeneration = _generation;
+
+    return true;
+}
+
+bool BrokerAmixerBackend::read(long *values, uint32_t count, std::string &error)
+{
+    if (count > _values.size()) {
+
+        _values.resize(count);
+    }
+    BrokerClient::Operation operation = {
+        BrokerRead, count, NULL, NULL, NULL, 0, _values.data(), count * sizeof(int64_t),
+        BrokerReply()
+    };
+    if (!request(operation, error)) {
+
+        return false;
+    }
+    for (uint32_t index = 0; index < count; index++) {
+
+        values[index] = _values[index];
+    }
+    return true;
+}
+
+bool BrokerAmixerBackend::write(const long *values, uint32_t count, std::string &error)
+{
+    if (count > _values.size()) {
+
+        _values.resize(count);
+    }
+    for (uint32_t index = 0; index < count; index++) {
+
+        _values[index] = values[index];
+    }
+    BrokerClient::Operation operation = {
+        BrokerWrite, count, NULL, NULL, _values.data(), count * sizeof(int64_t), NULL, 0,
+        BrokerReply()
+    };
+    return request(operation, error);
+}
+
+bool BrokerAmixerBackend::readBytes(void *data, size_t size, std::string &error)
+{
+    BrokerClient::Operation operation = {
+        BrokerReadBytes, static_cast<uint32_t>(size), NULL, NULL, NULL, 0, data, size,
+        BrokerReply()
+    };
+    return request(operation, error);
+}
+
+bool BrokerAmixerBackend::writeBytes(const void *data, size_t size, std::string &error)
+{
+    BrokerClient::Operation operation = {
+        BrokerWriteBytes, 0, NULL, NULL, data, size, NULL, 0, BrokerReply()
+    };
+    return request(operation, error);
+}
+
+bool BrokerAmixerBackend::getItemName(uint32_t item, std::string &name, std::string &error)
+{
+    // Item names are limited to 64 characters by the kernel
+    char itemName[64];
+    BrokerClient::Operation operation = {
+        BrokerItemName, item, NULL, NULL, NULL, 0, itemName, sizeof(itemName), BrokerReply()
+    };
+    if (!request(operation, error)) {
+
+        return false;
+    }
+    name.assign(itemName, std::min<size_t>(operation.reply.payloadSize, sizeof(itemName)));
+
+    return true;
+}
+
+bool BrokerAmixerBackend::readDbTlv(unsigned int *tlv, size_t &tlvSize,
+                                    long &min, long &max, std::string &error)
+{
+    BrokerClient::Operation operation = {
+        BrokerDbTlv, static_cast<uint32_t>(tlvSize), NULL, NULL, NULL, 0, tlv, tlvSize,
+        BrokerReply()
+    };
+    if (!request(operation, error)) {
+
+        return false;
+    }
+    min = operation.reply.min;
+    max = operation.reply.max;
+
+    return true;
+}
+
+AmixerRampWriter *BrokerAmixerBackend::createRampWriter()
+{
+    // The connection outlives the ramp: the subsystem stops the ramps before releasing it
+    return new BrokerAmixerRampWriter(*_client, _card->name, *_controlName);
+}
+
+bool BrokerAmixerBackend::request(BrokerClient::Operation &operation, std::string &error)
+{
+    operation.card = &_card->name;
+    operation.control = _controlName;
+    _requestCount++;
+
+    if (!_client->transact(&operation, 1, error)) {
+
+        _resolvedName = NULL;
+        return false;
+    }
+    if (operation.reply.status < 0) {
+
+        // The control may have changed or gone away: it is resolved again on the next access
+        _resolvedName = NULL;
+        error = strerror(-operation.reply.status);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AmixerBackendControl.hpp"
+#include "BrokerClient.hpp"
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+class CSubsystem;
+
+/**
+ * Backend policy of AmixerBackendControl over the alsa-broker daemon.
+ * The element metadata is fetched once per card binding, and again after a failed access: a
+ * steady state access is a single round trip to the daemon, which finds the control through
+ * its own name index.
+ * Accesses take the lock of the connection, and are not real-time safe.
+ */
+class BrokerAmixerBackend
+{
+public:
+    BrokerAmixerBackend();
+
+    bool open(const CSubsystem *subsystem, const AlsaCardDescriptor &card, std::string &error);
+    bool resolve(const std::string &controlName, std::string &error);
+    /** The connection is shared by the subsystem */
+    void close() {}
+    int32_t getCardIndex() const { return _cardIndex; }
+
+    AmixerElementType getType() const { return _type; }
+    uint32_t getCount() const { return _count; }
+    /** @return the numid of the control */
+    uintptr_t getKey() const { return _numid; }
+
+    bool read(long *values, uint32_t count, std::string &error);
+    bool write(const long *values, uint32_t count, std::string &error);
+
+    /** BYTES controls readable or writable as TLV go through the TLV interface */
+    bool readBytes(void *data, size_t size, std::string &error);
+    bool writeBytes(const void *data, size_t size, std::string &error);
+
+    uint32_t getItemCount() const { return _itemCount; }
+    bool getItemName(uint32_t item, std::string &name, std::string &error);
+
+    bool readDbTlv(unsigned int *tlv, size_t &tlvSize, long &min, long &max, std::string &error);
+
+    /** The writer shares the connection of the subsystem */
+    AmixerRampWriter *createRampWriter();
+
+    /** Round trips to the daemon, the ioctls being issued by the daemon */
+    uint32_t getIoctlCount() const { return _requestCount; }
+
+private:
+    BrokerAmixerBackend(const BrokerAmixerBackend &);
+    BrokerAmixerBackend &operator=(const BrokerAmixerBackend &);
+
+    /**
+     * Issue an operation on the resolved control
+     *
+     * @param[in] operation the operation, without card nor control
+     * @param[out] error string containing error description
+     *
+     * @return true if the daemon succeeded
+     */
+    bool request(BrokerClient::Operation &operation, std::string &error);
+
+    /** Connection of the subsystem, during an access */
+    BrokerClient *_client;
+    const AlsaCardDescriptor *_card;
+    int32_t _cardIndex;
+    /** Card binding of the current access */
+    uint32_t _generation;
+    /** Interned name of the control of the current access */
+    const std::string *_controlName;
+    /** Card, binding and interned control name the metadata was fetched for */
+    const AlsaCardDescriptor *_resolvedCard;
+    uint32_t _resolvedGeneration;
+    /** NULL if the metadata is not valid */
+    const std::string *_resolvedName;
+    AmixerElementType _type;
+    uint32_t _count;
+    uint32_t _itemCount;
+    uint32_t _numid;
+    /** Values as exchanged with the daemon, kept across accesses */
+    std::vector<int64_t> _values;
+    /** Number of round trips of the current access */
+    uint32_t _requestCount;
+};
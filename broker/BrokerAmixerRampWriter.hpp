@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AmixerRampEngine.hpp"
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+class BrokerClient;
+
+/**
+ * Ramp writer for controls served by the alsa-broker daemon.
+ * Each step is a single write request on the connection of the subsystem.
+ */
+class BrokerAmixerRampWriter : public AmixerRampWriter
+{
+public:
+    /**
+     * BrokerAmixerRampWriter Class constructor
+     *
+     * @param[in] client connection to the daemon, which outlives the writer
+     * @param[in] card interned name of the card
+     * @param[in] control interned name of the control
+     */
+    BrokerAmixerRampWriter(BrokerClient &client, const std::string &card,
+                           const std::string &control);
+
+    virtual bool writeLevels(const long *levels, size_t count);
+
+private:
+    BrokerAmixerRampWriter(const BrokerAmixerRampWriter &);
+    BrokerAmixerRampWriter &operator=(const BrokerAmixerRampWriter &);
+
+    BrokerClient &_client;
+    const std::string &_card;
+    const std::string &_control;
+    /** Levels as exchanged with the daemon, kept across steps */
+    std::vector<int64_t> _levels;
+};
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "BrokerClient.hpp"
+#include <algorithm>
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+BrokerClient::BrokerClient()
+    : _mutex(), _path(gBrokerDefaultSocket), _socket(-1), _buffer(gBrokerMaxMessageSize)
+{
+}
+
+BrokerClient::~BrokerClient()
+{
+    disconnect();
+}
+
+void BrokerClient::setPath(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _path = path;
+}
+
+bool BrokerClient::transact(Operation *operations, size_t count, std::string &error)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    size_t size = serialize(operations, count);
+
+    if (size == 0) {
+
+        error = "batch too large for a broker message";
+        return false;
+    }
+    // A connection closed by the daemon is opened again once: operations can be repeated
+    for (int attempt = 0; attempt < 2; attempt++) {
+
+        if ((_socket < 0) && !connect(error)) {
+
+            return false;
+        }
+        ssize_t ret = send(_socket, _buffer.data(), size, MSG_NOSIGNAL);
+
+        if ((ret < 0) && ((errno == EPIPE) || (errno == ECONNRESET) || (errno == ENOTCONN))) {
+
+            disconnect();
+            continue;
+        }
+        if (ret >= 0) {
+
+            ret = recv(_socket, _buffer.data(), _buffer.size(), MSG_TRUNC);
+
+            if (ret == 0) {
+
+                disconnect();
+                continue;
+            }
+        }
+        if (ret < 0) {
+
+            error = std::string("broker unreachable: ") + strerror(errno);
+            disconnect();
+            return false;
+        }
+        if ((static_cast<size_t>(ret) > _buffer.size()) ||
+            !deserialize(operations, count, ret)) {
+
+            error = "invalid broker reply";
+            disconnect();
+            return false;
+        }
+        return true;
+    }
+    error = "connection closed by the broker";
+    return false;
+}
+
+bool BrokerClient::connect(std::string &error)
+{
+    struct sockaddr_un address;
+
+    if (_path.size() >= sizeof(address.sun_path)) {
+
+        error = "broker socket path too long: " + _path;
+        return false;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, _path.c_str(), _path.size());
+
+    _socket = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+
+    if (_socket < 0) {
+
+        error = std::string("unable to create the broker socket: ") + strerror(errno);
+        return false;
+    }
+    // A stuck daemon must not block the parameter-framework forever
+    struct timeval timeout = { _timeoutMs / 1000, (_timeoutMs % 1000) * 1000 };
+    int bufferSize = gBrokerMaxMessageSize;
+
+    if ((setsockopt(_socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) < 0) ||
+        (setsockopt(_socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) < 0) ||
+        (setsockopt(_socket, SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize)) < 0) ||
+        (::connect(_socket, reinterpret_cast<struct sockaddr *>(&address),
+                   sizeof(address)) < 0)) {
+
+        error = "unable to connect to the broker on " + _path + ": " + strerror(errno);
+        disconnect();
+        return false;
+    }
+    return true;
+}
+
+void BrokerClient::disconnect()
+{
+    if (_socket >= 0) {
+
+        ::close(_socket);
+        _socket = -1;
+    }
+}
+
+size_t BrokerClient::serialize(const Operation *operations, size_t count)
+{
+    BrokerMessage message = { static_cast<uint32_t>(count) };
+    size_t size = sizeof(message);
+
+    if (count > gBrokerMaxBatchSize) {
+
+        return 0;
+    }
+    memcpy(_buffer.data(), &message, sizeof(message));
+
+    for (size_t index = 0; index < count; index++) {
+
+        const Operation &operation = operations[index];
+        BrokerRequest request = {
+            operation.operation, operation.argument,
+            static_cast<uint16_t>(operation.card->size()),
+            static_cast<uint16_t>(operation.control->size()),
+            static_cast<uint32_t>(operation.inputSize)
+        };
+        size_t operationSize = sizeof(request) + request.cardSize + request.controlSize +
+                               operation.inputSize;
+
+        if ((operation.card->size() > UINT16_MAX) || (operation.control->size() > UINT16_MAX) ||
+            (operationSize > _buffer.size() - size)) {
+
+            return 0;
+        }
+        uint8_t *data = _buffer.data() + size;
+
+        memcpy(data, &request, sizeof(request));
+        data += sizeof(request);
+        memcpy(data, operation.card->data(), request.cardSize);
+        data += request.cardSize;
+        memcpy(data, operation.control->data(), request.controlSize);
+        data += request.controlSize;
+        if (operation.inputSize != 0) {
+
+            memcpy(data, operation.input, operation.inputSize);
+        }
+        size += operationSize;
+    }
+    return size;
+}
+
+bool BrokerClient::deserialize(Operation *operations, size_t count, size_t size) const
+{
+    BrokerMessage message;
+    size_t offset = sizeof(message);
+
+    if (size < sizeof(message)) {
+
+        return false;
+    }
+    memcpy(&message, _buffer.data(), sizeof(message));
+
+    if (message.count != count) {
+
+        return false;
+    }
+    for (size_t index = 0; index < count; index++) {
+
+        Operation &operation = operations[index];
+
+        if (size - offset < sizeof(operation.reply)) {
+
+            return false;
+        }
+        memcpy(&operation.reply, _buffer.data() + offset, sizeof(operation.reply));
+        offset += sizeof(operation.reply);
+
+        if (size - offset < operation.reply.payloadSize) {
+
+            return false;
+        }
+        size_t outputSize = std::min<size_t>(operation.reply.payloadSize, operation.outputSize);
+
+        if (outputSize != 0) {
+
+            memcpy(operation.output, _buffer.data() + offset, outputSize);
+        }
+        offset += operation.reply.payloadSize;
+    }
+    return true;
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "BrokerProtocol.hpp"
+#include <stdint.h>
+#include <stddef.h>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Connection to the alsa-broker daemon, shared by the objects of a subsystem.
+ * Batches are serialized on the connection: it may be used from the ramp thread as well.
+ */
+class BrokerClient
+{
+public:
+    /** Operation of a batch, along with its outcome */
+    struct Operation
+    {
+        BrokerOperation operation;
+        uint32_t argument;
+        const std::string *card;
+        const std::string *control;
+        /** Request payload */
+        const void *input;
+        size_t inputSize;
+        /** Buffer of the reply payload, which is truncated to its size */
+        void *output;
+        size_t outputSize;
+        /** Reply, the payload size being the one sent by the daemon */
+        BrokerReply reply;
+    };
+
+    BrokerClient();
+    ~BrokerClient();
+
+    /**
+     * Set the socket of the daemon
+     * Taken into account on the next connection.
+     *
+     * @param[in] path path of the Unix socket the daemon listens on
+     */
+    void setPath(const std::string &path);
+
+    /**
+     * Issue a batch of operations, in a single round trip
+     * The daemon is connected on first use, and again if it closed the connection (restart).
+     * The failure of an operation is reported by the status of its reply.
+     *
+     * @param[in,out] operations the operations, their replies being filled on success
+     * @param[in] count number of operations
+     * @param[out] error string containing error description
+     *
+     * @return true if the replies were received
+     */
+    bool transact(Operation *operations, size_t count, std::string &error);
+
+private:
+    BrokerClient(const BrokerClient &);
+    BrokerClient &operator=(const BrokerClient &);
+
+    bool connect(std::string &error);
+    void disconnect();
+
+    /**
+     * Serialize a batch into the message buffer
+     *
+     * @return the size of the message, 0 if it does not fit
+     */
+    size_t serialize(const Operation *operations, size_t count);
+
+    /** Fill the replies of a batch from the reply message in the buffer */
+    bool deserialize(Operation *operations, size_t count, size_t size) const;
+
+    /** Timeout of a round trip, the daemon being local */
+    static const int _timeoutMs = 2000;
+
+    std::mutex _mutex;
+    std::string _path;
+    int _socket;
+    /** Message buffer, allocated once */
+    std::vector<uint8_t> _buffer;
+};
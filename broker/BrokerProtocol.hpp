@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Protocol between the broker subsystem and the alsa-broker daemon.
+ *
+ * Messages are exchanged over a SOCK_SEQPACKET Unix socket, a message being a batch of
+ * operations: a BrokerMessage header followed, for each operation, by a BrokerRequest, the
+ * card name, the control name and the request payload. The reply is a BrokerMessage header
+ * followed, for each operation in order, by a BrokerReply and the reply payload.
+ * Controls are addressed by card and control names (or numids): the daemon resolves them
+ * through its own cache, so that steady state accesses are a single round trip.
+ * Fields are in host order, the daemon being local.
+ */
+
+/** Operations on a control */
+enum BrokerOperation
+{
+    /** Reply: type, count, item count and numid of the control */
+    BrokerResolve = 0,
+    /** Argument: value count. Reply payload: the values, as int64_t */
+    BrokerRead,
+    /** Argument: value count. Request payload: the values, as int64_t */
+    BrokerWrite,
+    /** Argument: byte count. Reply payload: the bytes, through TLV if readable as such */
+    BrokerReadBytes,
+    /** Request payload: the bytes, through TLV if writable as such */
+    BrokerWriteBytes,
+    /** Argument: item index. Reply payload: the item name, not terminated */
+    BrokerItemName,
+    /** Argument: TLV buffer size. Reply: min and max. Reply payload: the dB TLV */
+    BrokerDbTlv,
+
+    NbBrokerOperations
+};
+
+struct BrokerMessage
+{
+    /** Number of operations of the batch */
+    uint32_t count;
+} __attribute__((packed));
+
+struct BrokerRequest
+{
+    uint32_t operation;
+    uint32_t argument;
+    uint16_t cardSize;
+    uint16_t controlSize;
+    uint32_t payloadSize;
+} __attribute__((packed));
+
+struct BrokerReply
+{
+    /** 0 on success, a negative errno otherwise */
+    int32_t status;
+    /** AmixerElementType of the control */
+    uint32_t type;
+    uint32_t count;
+    uint32_t itemCount;
+    uint32_t numid;
+    int64_t min;
+    int64_t max;
+    uint32_t payloadSize;
+} __attribute__((packed));
+
+/** Socket the daemon listens on, unless given otherwise */
+static const char *const gBrokerDefaultSocket = "/run/alsa-broker.sock";
+
+/** Maximum size of a message, within the default socket buffers */
+static const size_t gBrokerMaxMessageSize = 128 * 1024;
+
+/** Maximum number of operations in a message */
+static const uint32_t gBrokerMaxBatchSize = 256;
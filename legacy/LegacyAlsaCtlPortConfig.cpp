@@ -33,7 +33,7 @@
 #include <string.h>
 #include <string>
 #include <alsa/asoundlib.h>
-#include <sstream>
+#include <stdio.h>
 
 #define base AlsaCtlPortConfig
 
@@ -56,18 +56,6 @@ LegacyAlsaCtlPortConfig::LegacyAlsaCtlPortConfig(
     // Init stream handle array
     _streamHandle[Playback] = NULL;
     _streamHandle[Capture] = NULL;
-
-    // Retrieve card index
-    std::string cardIndex = context.getItem(AlsaCard);
-
-    // Create device name
-    std::ostringstream streamName;
-
-    streamName << "hw:" << snd_card_get_index(cardIndex.c_str())
-               << "," << context.getItem(AlsaCtlDevice);
-
-    _streamName = streamName.str();
-
 }
 
 bool LegacyAlsaCtlPortConfig::doOpenStream(StreamDirection streamDirection, std::string &error)
@@ -75,9 +63,13 @@ bool LegacyAlsaCtlPortConfig::doOpenStream(StreamDirection streamDirection, std:
     snd_pcm_t *&streamHandle = _streamHandle[streamDirection];
     int32_t errorId;
 
+    // Create device name
+    char streamName[32];
+    snprintf(streamName, sizeof(streamName), "hw:%d,%u", getCardNumber(), getDeviceNumber());
+
     if ((errorId = snd_pcm_open(
              &streamHandle,
-             _streamName.c_str(),
+             streamName,
              streamDirection == Capture ? SND_PCM_STREAM_CAPTURE : SND_PCM_STREAM_PLAYBACK,
              0)) < 0) {
 
@@ -85,12 +77,15 @@ bool LegacyAlsaCtlPortConfig::doOpenStream(StreamDirection streamDirection, std:
 
         return false;
     }
+    getAccessTimer().lap(PhaseOpen);
 
     const AlsaCtlPortConfig::PortConfig &portConfig = getPortConfig();
 
+    // Kept alive streams are fed in place
     if ((errorId = snd_pcm_set_params(streamHandle,
                                       static_cast<_snd_pcm_format>(portConfig.format),
-                                      SND_PCM_ACCESS_RW_INTERLEAVED,
+                                      isKeepAliveEnabled() ? SND_PCM_ACCESS_MMAP_INTERLEAVED
+                                                           : SND_PCM_ACCESS_RW_INTERLEAVED,
                                       portConfig.channelNumber,
                                       portConfig.sampleRate,
                                       0,
@@ -103,6 +98,92 @@ bool LegacyAlsaCtlPortConfig::doOpenStream(StreamDirection streamDirection, std:
         return false;
     }
 
+    getAccessTimer().lap(PhaseConfigure);
+
+    if (isKeepAliveEnabled() && !startKeepAlive(streamDirection, error)) {
+
+        doCloseStream(streamDirection);
+
+        return false;
+    }
+    getAccessTimer().lap(PhaseStart);
+
+    return true;
+}
+
+bool LegacyAlsaCtlPortConfig::startKeepAlive(StreamDirection streamDirection, std::string &error)
+{
+    snd_pcm_t *streamHandle = _streamHandle[streamDirection];
+    const AlsaCtlPortConfig::PortConfig &portConfig = getPortConfig();
+    snd_pcm_sw_params_t *swParams;
+    snd_pcm_uframes_t bufferSize;
+    snd_pcm_uframes_t periodSize;
+    snd_pcm_uframes_t boundary;
+    int32_t errorId;
+
+    snd_pcm_sw_params_alloca(&swParams);
+
+    // Never stop on xrun, and never wake up: nothing waits on the stream
+    if (((errorId = snd_pcm_get_params(streamHandle, &bufferSize, &periodSize)) < 0) ||
+        ((errorId = snd_pcm_sw_params_current(streamHandle, swParams)) < 0) ||
+        ((errorId = snd_pcm_sw_params_get_boundary(swParams, &boundary)) < 0) ||
+        ((errorId = snd_pcm_sw_params_set_stop_threshold(streamHandle, swParams, boundary)) < 0) ||
+        ((errorId = snd_pcm_sw_params_set_avail_min(streamHandle, swParams, bufferSize)) < 0)) {
+
+        error = formatAlsaError(streamDirection, "set keep-alive params", snd_strerror(errorId));
+        return false;
+    }
+
+    // The driver fills the whole buffer with silence as it is played
+    if ((streamDirection == Playback) &&
+        (((errorId = snd_pcm_sw_params_set_silence_threshold(streamHandle, swParams, 0)) < 0) ||
+         ((errorId = snd_pcm_sw_params_set_silence_size(streamHandle, swParams, boundary)) < 0))) {
+
+        error = formatAlsaError(streamDirection, "set silence params", snd_strerror(errorId));
+        return false;
+    }
+
+    if ((errorId = snd_pcm_sw_params(streamHandle, swParams)) < 0) {
+
+        error = formatAlsaError(streamDirection, "set keep-alive params", snd_strerror(errorId));
+        return false;
+    }
+
+    // Playback starts on a buffer of silence, committed in place
+    if (streamDirection == Playback) {
+
+        const snd_pcm_channel_area_t *areas;
+        snd_pcm_uframes_t offset;
+        snd_pcm_uframes_t frames = bufferSize;
+        snd_pcm_format_t format = static_cast<snd_pcm_format_t>(portConfig.format);
+        snd_pcm_sframes_t result = snd_pcm_avail_update(streamHandle);
+
+        if (result >= 0) {
+
+            result = snd_pcm_mmap_begin(streamHandle, &areas, &offset, &frames);
+        }
+        if (result >= 0) {
+
+            result = snd_pcm_areas_silence(areas, offset, portConfig.channelNumber, frames,
+                                           format);
+        }
+        if (result >= 0) {
+
+            result = snd_pcm_mmap_commit(streamHandle, offset, frames);
+        }
+        if (result < 0) {
+
+            error = formatAlsaError(streamDirection, "fill silence", snd_strerror(result));
+            return false;
+        }
+    }
+
+    if ((errorId = snd_pcm_start(streamHandle)) < 0) {
+
+        error = formatAlsaError(streamDirection, "start", snd_strerror(errorId));
+        return false;
+    }
+
     return true;
 }
 
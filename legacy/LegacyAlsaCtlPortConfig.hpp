@@ -56,12 +56,21 @@ protected:
     virtual void doCloseStream(StreamDirection streamDirection);
 
 private:
+    /**
+     * Keep an opened stream running: it never stops on xrun, and playback is fed with silence
+     * by the driver, starting from a buffer of silence committed in place
+     *
+     * @param[in] streamDirection Either Capture or Playback
+     * @param[out] error string containing the alsa error in case of failure
+     *
+     * @return true or false in case of failure
+     */
+    bool startKeepAlive(StreamDirection streamDirection, std::string &error);
+
     /** Default port configuration */
     static const PortConfig _defaultPortConfig;
     /** Latency */
     static const uint32_t _latencyMicroSeconds;
-    /** Stream Name */
-    std::string _streamName;
 
     /**
      * Stream handles.
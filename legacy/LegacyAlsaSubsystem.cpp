@@ -30,33 +30,132 @@
 
 #include "LegacyAlsaSubsystem.hpp"
 #include "LegacyAmixerControl.hpp"
+#include "AlsaSnapshotControl.hpp"
+#include "AmixerFanOutControl.hpp"
+#include "AmixerControlGroup.hpp"
+#include "AmixerByteFile.hpp"
 #include "LegacyAlsaCtlPortConfig.hpp"
 #include "SubsystemObjectFactory.h"
 #include "AlsaMappingKeys.hpp"
 #include "AmixerMutableVolume.hpp"
+#include "AmixerMultiChannelVolume.hpp"
+#include "AmixerEnumControl.hpp"
+#include "AmixerDbVolume.hpp"
+#include <alsa/asoundlib.h>
+#include <stdio.h>
 #include <string>
 
 LegacyAlsaSubsystem::LegacyAlsaSubsystem(const std::string &name, core::log::Logger& logger) :
-    AlsaSubsystem(name, logger)
+    AlsaSubsystem(name, logger), _controls()
 {
     // Provide creators to upper layer
     addSubsystemObjectFactory(
-        new TSubsystemObjectFactory<LegacyAmixerControl>("Control", 1 << AlsaCard)
+        new TSubsystemObjectFactory<LegacyAmixerControl<> >("Control", 1 << AlsaCard)
         );
 
     addSubsystemObjectFactory(
-        new TSubsystemObjectFactory<LegacyAmixerControl>(
+        new TSubsystemObjectFactory<LegacyAmixerControl<> >(
             "ByteControl", 1 << AlsaCard)
         );
 
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<AmixerByteFile<LegacyAmixerBackend> >(
+            "ByteFile", 1 << AlsaCard)
+        );
+
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<
+            LegacyAmixerControl<AmixerMutableVolume<AmixerControl> > >("Volume", 1 << AlsaCard)
+        );
+
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<
+            LegacyAmixerControl<AmixerMultiChannelVolume<AmixerControl> > >(
+            "MultiChannelVolume", 1 << AlsaCard)
+        );
+
     addSubsystemObjectFactory(
         new TSubsystemObjectFactory<
-            AmixerMutableVolume<LegacyAmixerControl> >("Volume", 1 << AlsaCard)
+            LegacyAmixerControl<AmixerDbVolume<AmixerControl> > >("DbVolume", 1 << AlsaCard)
+        );
+
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<
+            LegacyAmixerControl<AmixerEnumControl<AmixerControl> > >("EnumControl", 1 << AlsaCard)
+        );
+
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<AmixerFanOutControl<LegacyAmixerBackend> >(
+            "FanOutControl", 1 << AlsaCard)
+        );
+
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<AmixerControlGroup<LegacyAmixerBackend> >(
+            "ControlGroup", 1 << AlsaCard)
         );
 
 
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<AlsaSnapshotControl<LegacyAmixerBackend> >(
+            "Snapshot", 1 << AlsaCard)
+        );
+
     addSubsystemObjectFactory(
         new TSubsystemObjectFactory<LegacyAlsaCtlPortConfig>(
             "PortConfig", (1 << AlsaCard) | (1 << AlsaCtlDevice))
         );
 }
+
+LegacyAlsaSubsystem::~LegacyAlsaSubsystem()
+{
+    ControlMap::const_iterator it;
+
+    // Ramp writers rely on the sound controls
+    stopRamps();
+
+    // Saved while the sound controls are still opened
+    storeStartupState<LegacyAmixerBackend>();
+
+    for (it = _controls.begin(); it != _controls.end(); ++it) {
+
+        snd_ctl_close(it->second.handle);
+    }
+}
+
+int LegacyAlsaSubsystem::getControlHandle(const AlsaCardDescriptor &card, snd_ctl_t *&sndCtrl,
+                                          int32_t &cardNumber)
+{
+    // Generation first: the index is then at least as recent
+    uint32_t generation = card.generation;
+    cardNumber = card.index;
+
+    ControlMap::iterator it = _controls.find(&card);
+
+    if (it != _controls.end()) {
+
+        if (it->second.generation == generation) {
+
+            sndCtrl = it->second.handle;
+            cardNumber = it->second.cardNumber;
+            return 0;
+        }
+        // The card was rebound: ramp writers of the old sound control have to go first
+        stopRamps(it->second.cardNumber);
+        snd_ctl_close(it->second.handle);
+        _controls.erase(it);
+    }
+
+    // Create device name
+    char deviceName[16];
+    snprintf(deviceName, sizeof(deviceName), "hw:%d", cardNumber);
+
+    int ret;
+    if ((ret = snd_ctl_open(&sndCtrl, deviceName, 0)) < 0) {
+
+        return ret;
+    }
+    CachedControl cachedControl = { sndCtrl, cardNumber, generation };
+    _controls.insert(std::make_pair(&card, cachedControl));
+
+    return 0;
+}
@@ -31,10 +31,40 @@
 #pragma once
 
 #include "AlsaSubsystem.hpp"
+#include <stdint.h>
 #include <string>
+#include <map>
+
+struct _snd_ctl;
 
 class LegacyAlsaSubsystem : public AlsaSubsystem
 {
 public:
     LegacyAlsaSubsystem(const std::string &name, core::log::Logger& logger);
+    ~LegacyAlsaSubsystem();
+
+    /**
+     * Get the sound control of a card, opened once and cached
+     * The cached sound control of a card rebound on hotplug is closed, and the card opened again.
+     *
+     * @param[in] card the card descriptor
+     * @param[out] sndCtrl the sound control
+     * @param[out] cardNumber index of the card the sound control is opened on
+     *
+     * @return 0 on success, a negative alsa error code otherwise
+     */
+    int getControlHandle(const AlsaCardDescriptor &card, _snd_ctl *&sndCtrl, int32_t &cardNumber);
+
+private:
+    /** Sound control, along with the card binding it was opened for */
+    struct CachedControl
+    {
+        _snd_ctl *handle;
+        int32_t cardNumber;
+        uint32_t generation;
+    };
+    typedef std::map<const AlsaCardDescriptor *, CachedControl> ControlMap;
+
+    /** Sound controls of the cards */
+    ControlMap _controls;
 };
@@ -0,0 +1,410 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "LegacyAmixerBackend.hpp"
+#include "LegacyAmixerRampWriter.hpp"
+#include "LegacyAlsaSubsystem.hpp"
+#include <alsa/asoundlib.h>
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/* from sound/asound.h, header is not compatible with alsa/asoundlib.h
+ */
+struct snd_ctl_tlv {
+    unsigned int numid;     /* control element numeric identification */
+    unsigned int length;    /* in bytes aligned to 4 */
+    unsigned char tlv[];    /* first TLV */
+};
+
+static AmixerElementType getElementType(const snd_ctl_elem_info_t *info)
+{
+    switch (snd_ctl_elem_info_get_type(info)) {
+    case SND_CTL_ELEM_TYPE_BOOLEAN:
+        return AmixerElementBoolean;
+    case SND_CTL_ELEM_TYPE_INTEGER:
+        return AmixerElementInteger;
+    case SND_CTL_ELEM_TYPE_INTEGER64:
+        return AmixerElementInteger64;
+    case SND_CTL_ELEM_TYPE_ENUMERATED:
+        return AmixerElementEnumerated;
+    case SND_CTL_ELEM_TYPE_BYTES:
+        return AmixerElementBytes;
+    default:
+        return AmixerElementUnknown;
+    }
+}
+
+LegacyAmixerBackend::LegacyAmixerBackend()
+    : _cardIndex(-1), _card(NULL), _resolutionCache(NULL), _sndCtrl(NULL), _id(NULL),
+      _info(NULL), _value(NULL), _controlName(NULL),
+      _resolution(), _isCachedResolution(false), _isInfoValid(false), _rawTlv(),
+      _ioctlCount(0)
+{
+    snd_ctl_elem_id_malloc(&_id);
+    snd_ctl_elem_info_malloc(&_info);
+    snd_ctl_elem_value_malloc(&_value);
+}
+
+LegacyAmixerBackend::~LegacyAmixerBackend()
+{
+    close();
+
+    if (_value != NULL) {
+
+        snd_ctl_elem_value_free(_value);
+    }
+    if (_info != NULL) {
+
+        snd_ctl_elem_info_free(_info);
+    }
+    if (_id != NULL) {
+
+        snd_ctl_elem_id_free(_id);
+    }
+}
+
+bool LegacyAmixerBackend::open(const CSubsystem *subsystem, const AlsaCardDescriptor &card,
+                               std::string &error)
+{
+    if ((_id == NULL) || (_info == NULL) || (_value == NULL)) {
+
+        error = "unable to allocate the element descriptors";
+        return false;
+    }
+    // getControlHandle is non-const; we need to forcefully remove the constness
+    // then, we need to cast the generic subsystem into a LegacyAlsaSubsystem.
+    LegacyAlsaSubsystem *legacySubsystem =
+        static_cast<LegacyAlsaSubsystem *>(const_cast<CSubsystem *>(subsystem));
+    int ret = legacySubsystem->getControlHandle(card, _sndCtrl, _cardIndex);
+
+    if (ret < 0) {
+
+        _sndCtrl = NULL;
+        error = snd_strerror(ret);
+        return false;
+    }
+    _card = &card;
+    _resolutionCache = &legacySubsystem->getResolutionCache();
+    _ioctlCount = 0;
+
+    return true;
+}
+
+bool LegacyAmixerBackend::resolve(const std::string &controlName, std::string &error)
+{
+    snd_ctl_elem_id_clear(_id);
+    snd_ctl_elem_info_clear(_info);
+    snd_ctl_elem_value_clear(_value);
+
+    // Set interface
+    snd_ctl_elem_id_set_interface(_id, SND_CTL_ELEM_IFACE_MIXER);
+
+    _controlName = &controlName;
+    _isInfoValid = false;
+
+    const AlsaResolutionCache::Resolution *resolution =
+        _resolutionCache->find(*_card, controlName);
+
+    // Known controls are addressed by numid, without looking them up
+    if (resolution != NULL) {
+
+        _resolution = *resolution;
+        _isCachedResolution = true;
+
+        snd_ctl_elem_id_set_numid(_id, _resolution.numid);
+        snd_ctl_elem_value_set_id(_value, _id);
+
+        return true;
+    }
+    _isCachedResolution = false;
+
+    // Set name or id
+    if (isdigit(controlName[0])) {
+
+        uint32_t numid;
+
+        if (!AlsaDescriptorPool::parseControlNumber(controlName, numid)) {
+
+            error = "invalid numid";
+            return false;
+        }
+        snd_ctl_elem_id_set_numid(_id, numid);
+    } else {
+
+        snd_ctl_elem_id_set_name(_id, controlName.c_str());
+    }
+    // Init info id
+    snd_ctl_elem_info_set_id(_info, _id);
+
+    // Get info
+    int ret;
+    _ioctlCount++;
+    if ((ret = snd_ctl_elem_info(_sndCtrl, _info)) < 0) {
+
+        error = snd_strerror(ret);
+        return false;
+    }
+    // Set value id
+    snd_ctl_elem_value_set_id(_value, _id);
+
+    _isInfoValid = true;
+    _resolution.numid = snd_ctl_elem_info_get_numid(_info);
+    _resolution.type = getElementType(_info);
+    _resolution.count = snd_ctl_elem_info_get_count(_info);
+    _resolution.itemCount = snd_ctl_elem_info_get_items(_info);
+    _resolution.isTlvReadable = snd_ctl_elem_info_is_tlv_readable(_info);
+    _resolution.isTlvWritable = snd_ctl_elem_info_is_tlv_writable(_info);
+
+    _resolutionCache->add(*_card, controlName, _resolution);
+
+    return true;
+}
+
+bool LegacyAmixerBackend::readInfo(std::string &error)
+{
+    int ret;
+
+    if (_isInfoValid) {
+
+        return true;
+    }
+    snd_ctl_elem_info_set_id(_info, _id);
+
+    _ioctlCount++;
+    if ((ret = snd_ctl_elem_info(_sndCtrl, _info)) < 0) {
+
+        return fail(ret, error);
+    }
+    _isInfoValid = true;
+
+    return true;
+}
+
+bool LegacyAmixerBackend::fail(int ret, std::string &error)
+{
+    // The numid of a control added again changed: it is looked up on the next access
+    if ((ret == -ENOENT) && _isCachedResolution) {
+
+        _resolutionCache->drop(*_card, *_controlName);
+        _isCachedResolution = false;
+    }
+    error = snd_strerror(ret);
+
+    return false;
+}
+
+bool LegacyAmixerBackend::read(long *values, uint32_t count, std::string &error)
+{
+    int ret;
+
+    _ioctlCount++;
+
+    if ((ret = snd_ctl_elem_read(_sndCtrl, _value)) < 0) {
+
+        return fail(ret, error);
+    }
+    for (uint32_t index = 0; index < count; index++) {
+
+        switch (_resolution.type) {
+        case AmixerElementBoolean:
+            values[index] = snd_ctl_elem_value_get_boolean(_value, index);
+            break;
+        case AmixerElementInteger:
+            values[index] = snd_ctl_elem_value_get_integer(_value, index);
+            break;
+        case AmixerElementInteger64:
+            values[index] = snd_ctl_elem_value_get_integer64(_value, index);
+            break;
+        default:
+            values[index] = snd_ctl_elem_value_get_enumerated(_value, index);
+            break;
+        }
+    }
+    return true;
+}
+
+bool LegacyAmixerBackend::write(const long *values, uint32_t count, std::string &error)
+{
+    for (uint32_t index = 0; index < count; index++) {
+
+        switch (_resolution.type) {
+        case AmixerElementBoolean:
+            snd_ctl_elem_value_set_boolean(_value, index, values[index]);
+            break;
+        case AmixerElementInteger:
+            snd_ctl_elem_value_set_integer(_value, index, values[index]);
+            break;
+        case AmixerElementInteger64:
+            snd_ctl_elem_value_set_integer64(_value, index, values[index]);
+            break;
+        default:
+            snd_ctl_elem_value_set_enumerated(_value, index, values[index]);
+            break;
+        }
+    }
+    int ret;
+
+    _ioctlCount++;
+
+    if ((ret = snd_ctl_elem_write(_sndCtrl, _value)) < 0) {
+
+        return fail(ret, error);
+    }
+    return true;
+}
+
+bool LegacyAmixerBackend::readBytes(void *data, size_t size, std::string &error)
+{
+    int ret;
+
+    // Special hook for TLV Bytes Control
+    if (_resolution.isTlvReadable) {
+
+        // The buffer is kept across accesses
+        _rawTlv.resize(sizeof(struct snd_ctl_tlv) + size);
+
+        struct snd_ctl_tlv *tlv = reinterpret_cast<struct snd_ctl_tlv *>(_rawTlv.data());
+
+        _ioctlCount++;
+
+        if ((ret = snd_ctl_elem_tlv_read(_sndCtrl, _id, reinterpret_cast<unsigned int *>(tlv),
+                                         _rawTlv.size())) < 0) {
+
+            return fail(ret, error);
+        }
+        memcpy(data, tlv->tlv, size);
+
+        return true;
+    }
+    _ioctlCount++;
+    if ((ret = snd_ctl_elem_read(_sndCtrl, _value)) < 0) {
+
+        return fail(ret, error);
+    }
+    memcpy(data, snd_ctl_elem_value_get_bytes(_value), size);
+
+    return true;
+}
+
+bool LegacyAmixerBackend::writeBytes(const void *data, size_t size, std::string &error)
+{
+    int ret;
+
+    // Special hook for TLV Bytes Control
+    if (_resolution.isTlvWritable) {
+
+        // The buffer is kept across accesses
+        _rawTlv.resize(sizeof(struct snd_ctl_tlv) + size);
+
+        struct snd_ctl_tlv *tlv = reinterpret_cast<struct snd_ctl_tlv *>(_rawTlv.data());
+
+        tlv->numid = 0;
+        tlv->length = size;
+        memcpy(tlv->tlv, data, size);
+
+        _ioctlCount++;
+
+        if ((ret = snd_ctl_elem_tlv_write(_sndCtrl, _id,
+                                          reinterpret_cast<unsigned int *>(tlv))) < 0) {
+
+            return fail(ret, error);
+        }
+        return true;
+    }
+    // A shorter content is padded with zeros, as tinyalsa does, not with the previous bytes
+    snd_ctl_elem_value_clear(_value);
+    snd_ctl_elem_value_set_id(_value, _id);
+    snd_ctl_elem_set_bytes(_value, const_cast<void *>(data), size);
+
+    _ioctlCount++;
+
+    if ((ret = snd_ctl_elem_write(_sndCtrl, _value)) < 0) {
+
+        return fail(ret, error);
+    }
+    return true;
+}
+
+bool LegacyAmixerBackend::getItemName(uint32_t item, std::string &name, std::string &error)
+{
+    snd_ctl_elem_info_t *itemInfo;
+    int ret;
+
+    snd_ctl_elem_info_alloca(&itemInfo);
+
+    snd_ctl_elem_info_set_id(itemInfo, _id);
+    snd_ctl_elem_info_set_item(itemInfo, item);
+
+    _ioctlCount++;
+
+    if ((ret = snd_ctl_elem_info(_sndCtrl, itemInfo)) < 0) {
+
+        return fail(ret, error);
+    }
+    name = snd_ctl_elem_info_get_item_name(itemInfo);
+
+    return true;
+}
+
+bool LegacyAmixerBackend::readDbTlv(unsigned int *tlv, size_t &tlvSize,
+                                    long &min, long &max, std::string &error)
+{
+    if (!_resolution.isTlvReadable) {
+
+        error = "no TLV available";
+        return false;
+    }
+    // The range is not cached
+    if (!readInfo(error)) {
+
+        return false;
+    }
+    int ret;
+
+    _ioctlCount++;
+
+    if ((ret = snd_ctl_elem_tlv_read(_sndCtrl, _id, tlv, tlvSize)) < 0) {
+
+        return fail(ret, error);
+    }
+    min = snd_ctl_elem_info_get_min(_info);
+    max = snd_ctl_elem_info_get_max(_info);
+
+    return true;
+}
+
+AmixerRampWriter *LegacyAmixerBackend::createRampWriter()
+{
+    // The sound control outlives the ramp: the subsystem stops the ramps before closing it
+    return new LegacyAmixerRampWriter(_sndCtrl, _id);
+}
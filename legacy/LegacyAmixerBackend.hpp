@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AmixerBackendControl.hpp"
+#include "AlsaResolutionCache.hpp"
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+class CSubsystem;
+struct _snd_ctl;
+struct _snd_ctl_elem_id;
+struct _snd_ctl_elem_info;
+struct _snd_ctl_elem_value;
+
+/**
+ * Backend policy of AmixerBackendControl over alsa-lib.
+ * The sound control of the card is opened once and cached by the subsystem, the element
+ * descriptors are allocated once per mapped control: a successful access does not allocate,
+ * but for TLV bytes controls on their first access.
+ * Controls found in the resolution cache are addressed by numid, without element info.
+ */
+class LegacyAmixerBackend
+{
+public:
+    LegacyAmixerBackend();
+    ~LegacyAmixerBackend();
+
+    bool open(const CSubsystem *subsystem, const AlsaCardDescriptor &card, std::string &error);
+    bool resolve(const std::string &controlName, std::string &error);
+    /** The sound control stays cached by the subsystem */
+    void close() { _sndCtrl = NULL; }
+    int32_t getCardIndex() const { return _cardIndex; }
+
+    AmixerElementType getType() const { return _resolution.type; }
+    uint32_t getCount() const { return _resolution.count; }
+    /** @return the numid of the control */
+    uintptr_t getKey() const { return _resolution.numid; }
+
+    bool read(long *values, uint32_t count, std::string &error);
+    bool write(const long *values, uint32_t count, std::string &error);
+
+    /**
+     * BYTES controls readable or writable as TLV go through the TLV interface.
+     * Other controls written with fewer bytes than their count are padded with zeros.
+     */
+    bool readBytes(void *data, size_t size, std::string &error);
+    bool writeBytes(const void *data, size_t size, std::string &error);
+
+    uint32_t getItemCount() const { return _resolution.itemCount; }
+    bool getItemName(uint32_t item, std::string &name, std::string &error);
+
+    bool readDbTlv(unsigned int *tlv, size_t &tlvSize, long &min, long &max, std::string &error);
+
+    /** The writer shares the sound control cached by the subsystem */
+    AmixerRampWriter *createRampWriter();
+
+    /** Element info, read, write and TLV calls, one ioctl each */
+    uint32_t getIoctlCount() const { return _ioctlCount; }
+
+private:
+    LegacyAmixerBackend(const LegacyAmixerBackend &);
+    LegacyAmixerBackend &operator=(const LegacyAmixerBackend &);
+
+    /**
+     * Read the element info of a control resolved from the cache
+     *
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool readInfo(std::string &error);
+
+    /**
+     * Report a failed access, forgetting the cached resolution if the control went away
+     *
+     * @param[in] ret the negative alsa error code
+     * @param[out] error string containing error description
+     *
+     * @return false
+     */
+    bool fail(int ret, std::string &error);
+
+    int32_t _cardIndex;
+    const AlsaCardDescriptor *_card;
+    /** Resolution cache of the subsystem */
+    AlsaResolutionCache *_resolutionCache;
+    /** Sound control of the card, during an access */
+    _snd_ctl *_sndCtrl;
+    _snd_ctl_elem_id *_id;
+    _snd_ctl_elem_info *_info;
+    _snd_ctl_elem_value *_value;
+    /** Interned name of the resolved control */
+    const std::string *_controlName;
+    AlsaResolutionCache::Resolution _resolution;
+    /** The control was resolved from the cache */
+    bool _isCachedResolution;
+    /** The element info was read */
+    bool _isInfoValid;
+    /** TLV bytes buffer, kept across accesses */
+    std::vector<unsigned char> _rawTlv;
+    /** Number of ioctls of the current access */
+    uint32_t _ioctlCount;
+};
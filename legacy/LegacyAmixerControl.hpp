@@ -29,25 +29,13 @@
  */
 #pragma once
 
-#include "AmixerControl.hpp"
-#include <stdint.h>
-#include <string>
+#include "AmixerBackendControl.hpp"
+#include "LegacyAmixerBackend.hpp"
 
-class LegacyAmixerControl : public AmixerControl
-{
-public:
-    /**
-     * LegacyAmixerControl Class constructor
-     *
-     * @param[in] mappingValue instantiation mapping value
-     * @param[in] instanceConfigurableElement pointer to configurable element instance
-     * @param[in] context contains the context mappings
-     */
-    LegacyAmixerControl(const std::string &mappingValue,
-                        CInstanceConfigurableElement *instanceConfigurableElement,
-                        const CMappingContext &context,
-                        core::log::Logger& logger);
-
-protected:
-    virtual bool accessHW(bool receive, std::string &error);
-};
+/**
+ * Alsa mixer control accessed through alsa-lib.
+ *
+ * The template parameter is the value codec of the mapping type, AmixerControl for plain values.
+ */
+template <class Codec = AmixerControl>
+using LegacyAmixerControl = AmixerBackendControl<LegacyAmixerBackend, Codec>;
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "LegacyAmixerRampWriter.hpp"
+#include <alsa/asoundlib.h>
+
+LegacyAmixerRampWriter::LegacyAmixerRampWriter(snd_ctl_t *sndCtrl, const snd_ctl_elem_id_t *id)
+    : _sndCtrl(sndCtrl), _value(NULL)
+{
+    if (snd_ctl_elem_value_malloc(&_value) == 0) {
+
+        snd_ctl_elem_value_set_id(_value, id);
+    }
+}
+
+LegacyAmixerRampWriter::~LegacyAmixerRampWriter()
+{
+    if (_value != NULL) {
+
+        snd_ctl_elem_value_free(_value);
+    }
+}
+
+bool LegacyAmixerRampWriter::writeLevels(const long *levels, size_t count)
+{
+    if (_value == NULL) {
+
+        return false;
+    }
+    for (size_t index = 0; index < count; index++) {
+
+        snd_ctl_elem_value_set_integer(_value, index, levels[index]);
+    }
+    return snd_ctl_elem_write(_sndCtrl, _value) >= 0;
+}
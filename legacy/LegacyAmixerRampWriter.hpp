@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AmixerRampEngine.hpp"
+#include <stddef.h>
+
+struct _snd_ctl;
+struct _snd_ctl_elem_id;
+struct _snd_ctl_elem_value;
+
+/**
+ * Ramp writer for alsa-lib controls.
+ * Each step is a single element write on the sound control cached by the subsystem.
+ */
+class LegacyAmixerRampWriter : public AmixerRampWriter
+{
+public:
+    /**
+     * LegacyAmixerRampWriter Class constructor
+     *
+     * @param[in] sndCtrl opened sound control, which outlives the writer
+     * @param[in] id identifier of the control element
+     */
+    LegacyAmixerRampWriter(_snd_ctl *sndCtrl, const _snd_ctl_elem_id *id);
+    virtual ~LegacyAmixerRampWriter();
+
+    virtual bool writeLevels(const long *levels, size_t count);
+
+private:
+    LegacyAmixerRampWriter(const LegacyAmixerRampWriter &);
+    LegacyAmixerRampWriter &operator=(const LegacyAmixerRampWriter &);
+
+    /** Sound control of the card */
+    _snd_ctl *_sndCtrl;
+    /** Element value, bound to the control element */
+    _snd_ctl_elem_value *_value;
+};
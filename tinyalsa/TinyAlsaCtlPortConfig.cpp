@@ -32,8 +32,15 @@
 #include "AlsaMappingKeys.hpp"
 
 #include <tinyalsa/asoundlib.h>
+#include <sys/ioctl.h>
+#include <sound/asound.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
 #include <string>
 #include <sstream>
+#include <limits>
 
 #define base AlsaCtlPortConfig
 
@@ -117,12 +124,16 @@ bool TinyAlsaCtlPortConfig::doOpenStream(StreamDirection streamDirection, std::s
     pcmConfig.silence_size      = 0;
     pcmConfig.avail_min         = 0;
 
-    // Open and configure
+    // Open and configure, kept alive streams being fed in place
     streamHandle = pcm_open(getCardNumber(),
                             getDeviceNumber(),
-                            streamDirection == Capture ? PCM_IN : PCM_OUT,
+                            (streamDirection == Capture ? PCM_IN : PCM_OUT) |
+                                (isKeepAliveEnabled() ? PCM_MMAP : 0),
                             &pcmConfig);
 
+    // tinyalsa sets the parameters on opening: only the prepare is timed as configuration
+    getAccessTimer().lap(PhaseOpen);
+
     // Prepare the stream
     if (!pcm_is_ready(streamHandle) || (pcm_prepare(streamHandle) != 0)) {
 
@@ -132,6 +143,68 @@ bool TinyAlsaCtlPortConfig::doOpenStream(StreamDirection streamDirection, std::s
         doCloseStream(streamDirection);
         return false;
     }
+    getAccessTimer().lap(PhaseConfigure);
+
+    if (isKeepAliveEnabled() && !startKeepAlive(streamDirection, error)) {
+
+        doCloseStream(streamDirection);
+        return false;
+    }
+    getAccessTimer().lap(PhaseStart);
+
+    return true;
+}
+
+bool TinyAlsaCtlPortConfig::startKeepAlive(StreamDirection streamDirection, std::string &error)
+{
+    struct pcm *streamHandle = _streamHandle[streamDirection];
+    unsigned int bufferSize = pcm_get_buffer_size(streamHandle);
+    struct snd_pcm_sw_params swParams;
+
+    // pcm_config thresholds are 32 bits, and tinyalsa does not give the boundary: past any
+    // boundary, LONG_MAX never stops on xrun and silences the whole buffer as it is played
+    memset(&swParams, 0, sizeof(swParams));
+    swParams.tstamp_mode = SNDRV_PCM_TSTAMP_NONE;
+    swParams.period_step = 1;
+    swParams.avail_min = bufferSize;
+    swParams.start_threshold = bufferSize;
+    swParams.stop_threshold = LONG_MAX;
+    swParams.silence_threshold = 0;
+    swParams.silence_size = (streamDirection == Playback) ? LONG_MAX : 0;
+
+    if (pcm_ioctl(streamHandle, SNDRV_PCM_IOCTL_SW_PARAMS, &swParams) != 0) {
+
+        error = formatAlsaError(streamDirection, "set keep-alive params", strerror(errno));
+        return false;
+    }
+
+    // Playback starts on a buffer of silence, committed in place: formats are all signed
+    if (streamDirection == Playback) {
+
+        void *areas;
+        unsigned int offset;
+        unsigned int frames = bufferSize;
+
+        if (pcm_mmap_begin(streamHandle, &areas, &offset, &frames) != 0) {
+
+            error = formatAlsaError(streamDirection, "fill silence", pcm_get_error(streamHandle));
+            return false;
+        }
+        memset(static_cast<uint8_t *>(areas) + pcm_frames_to_bytes(streamHandle, offset), 0,
+               pcm_frames_to_bytes(streamHandle, frames));
+
+        if (pcm_mmap_commit(streamHandle, offset, frames) < 0) {
+
+            error = formatAlsaError(streamDirection, "fill silence", pcm_get_error(streamHandle));
+            return false;
+        }
+    }
+
+    if (pcm_start(streamHandle) != 0) {
+
+        error = formatAlsaError(streamDirection, "start", pcm_get_error(streamHandle));
+        return false;
+    }
 
     return true;
 }
@@ -56,6 +56,17 @@ protected:
     virtual void doCloseStream(StreamDirection streamDirection);
 
 private:
+    /**
+     * Keep an opened stream running: it never stops on xrun, and playback is fed with silence
+     * by the driver, starting from a buffer of silence committed in place
+     *
+     * @param[in] streamDirection Either Capture or Playback
+     * @param[out] error string containing the alsa error in case of failure
+     *
+     * @return true or false in case of failure
+     */
+    bool startKeepAlive(StreamDirection streamDirection, std::string &error);
+
     /** Number of ring buffer for device configuration */
     static const int _nbRingBuffer;
     /** Default port configuration */
@@ -29,33 +29,77 @@
  */
 
 #include "TinyAlsaSubsystem.hpp"
-#include "TinyAmixerControlArray.hpp"
-#include "TinyAmixerControlValue.hpp"
+#include "TinyAmixerControl.hpp"
+#include "AlsaSnapshotControl.hpp"
+#include "AmixerFanOutControl.hpp"
+#include "AmixerControlGroup.hpp"
+#include "AmixerByteFile.hpp"
 #include "TinyAlsaCtlPortConfig.hpp"
 #include "SubsystemObjectFactory.h"
 #include "AlsaMappingKeys.hpp"
 #include "AmixerMutableVolume.hpp"
+#include "AmixerMultiChannelVolume.hpp"
+#include "AmixerEnumControl.hpp"
+#include "AmixerDbVolume.hpp"
+#include "AmixerByteArray.hpp"
 #include <string>
+#include <system_error>
 
 TinyAlsaSubsystem::TinyAlsaSubsystem(const std::string &name, core::log::Logger& logger) :
-    AlsaSubsystem(name, logger), mMixers()
+    AlsaSubsystem(name, logger), mMixers(), mPrewarmedMixers()
 {
     // Provide creators to upper layer
     addSubsystemObjectFactory(
-        new TSubsystemObjectFactory<TinyAmixerControlValue>("Control", 1 << AlsaCard)
+        new TSubsystemObjectFactory<TinyAmixerControl<> >("Control", 1 << AlsaCard)
         );
 
     addSubsystemObjectFactory(
-        new TSubsystemObjectFactory<TinyAmixerControlArray>(
+        new TSubsystemObjectFactory<TinyAmixerControl<AmixerByteArray<AmixerControl> > >(
             "ByteControl", 1 << AlsaCard)
         );
 
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<AmixerByteFile<TinyAmixerBackend> >(
+            "ByteFile", 1 << AlsaCard)
+        );
+
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<
+            TinyAmixerControl<AmixerMutableVolume<AmixerControl> > >("Volume", 1 << AlsaCard)
+        );
+
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<
+            TinyAmixerControl<AmixerMultiChannelVolume<AmixerControl> > >(
+            "MultiChannelVolume", 1 << AlsaCard)
+        );
+
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<
+            TinyAmixerControl<AmixerDbVolume<AmixerControl> > >("DbVolume", 1 << AlsaCard)
+        );
+
     addSubsystemObjectFactory(
         new TSubsystemObjectFactory<
-            AmixerMutableVolume<TinyAmixerControlValue> >("Volume", 1 << AlsaCard)
+            TinyAmixerControl<AmixerEnumControl<AmixerControl> > >("EnumControl", 1 << AlsaCard)
+        );
+
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<AmixerFanOutControl<TinyAmixerBackend> >(
+            "FanOutControl", 1 << AlsaCard)
+        );
+
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<AmixerControlGroup<TinyAmixerBackend> >(
+            "ControlGroup", 1 << AlsaCard)
         );
 
 
+    addSubsystemObjectFactory(
+        new TSubsystemObjectFactory<AlsaSnapshotControl<TinyAmixerBackend> >(
+            "Snapshot", 1 << AlsaCard)
+        );
+
     addSubsystemObjectFactory(
         new TSubsystemObjectFactory<TinyAlsaCtlPortConfig>(
             "PortConfig", (1 << AlsaCard) | (1 << AlsaCtlDevice))
@@ -66,16 +110,42 @@ TinyAlsaSubsystem::~TinyAlsaSubsystem()
 {
     MixerMap::const_iterator it;
 
+    // Mixers never accessed are cached along with the others
+    while (!mPrewarmedMixers.empty()) {
+
+        adoptPrewarmedMixer(*mPrewarmedMixers.begin()->first);
+    }
+
+    // Ramp writers rely on the mixer handles
+    stopRamps();
+
+    // Saved while the mixers are still opened
+    storeStartupState<TinyAmixerBackend>();
+
     for (it = mMixers.begin(); it != mMixers.end(); ++it) {
-        mixer_close(it->second);
+        mixer_close(it->second.handle);
     }
 }
 
-struct mixer *TinyAlsaSubsystem::getMixerHandle(int32_t cardNumber)
+struct mixer *TinyAlsaSubsystem::getMixerHandle(const AlsaCardDescriptor &card,
+                                                int32_t &cardNumber)
 {
-    MixerMap::const_iterator it = mMixers.find(cardNumber);
+    adoptPrewarmedMixer(card);
+
+    // Generation first: the index is then at least as recent
+    uint32_t generation = card.generation;
+    cardNumber = card.index;
+
+    MixerMap::iterator it = mMixers.find(&card);
     if (it != mMixers.end()) {
-        return it->second;
+        if (it->second.generation == generation) {
+            cardNumber = it->second.cardNumber;
+            return it->second.handle;
+        }
+        // The card was rebound: ramp writers of the old mixer have to go first
+        stopRamps(it->second.cardNumber);
+        mixer_close(it->second.handle);
+        mMixers.erase(it);
     }
 
     // create handle
@@ -83,7 +153,61 @@ struct mixer *TinyAlsaSubsystem::getMixerHandle(int32_t cardNumber)
     if (newMixer == NULL) {
         return NULL;
     }
-    mMixers.insert(std::make_pair(cardNumber, newMixer));
+    CachedMixer cachedMixer = { newMixer, cardNumber, generation };
+    mMixers.insert(std::make_pair(&card, cachedMixer));
 
     return newMixer;
 }
+
+void TinyAlsaSubsystem::prepareCard(const AlsaCardDescriptor &card,
+                                    const CMappingContext &/*context*/)
+{
+    // Generation first: the index is then at least as recent
+    uint32_t generation = card.generation;
+    int32_t cardNumber = card.index;
+
+    if ((cardNumber < 0) || (mMixers.find(&card) != mMixers.end()) ||
+        (mPrewarmedMixers.find(&card) != mPrewarmedMixers.end())) {
+
+        return;
+    }
+    // Map nodes are stable: the worker fills its own node
+    PrewarmedMixer &prewarmed = mPrewarmedMixers[&card];
+    CachedMixer mixer = { NULL, cardNumber, generation };
+
+    prewarmed.mixer = mixer;
+
+    try {
+
+        prewarmed.worker = std::thread(&TinyAlsaSubsystem::openMixer, &prewarmed.mixer);
+    } catch (const std::system_error &) {
+
+        // No worker: the mixer is opened on the first access to the card
+        mPrewarmedMixers.erase(&card);
+    }
+}
+
+void TinyAlsaSubsystem::openMixer(CachedMixer *mixer)
+{
+    mixer->handle = mixer_open(mixer->cardNumber);
+}
+
+void TinyAlsaSubsystem::adoptPrewarmedMixer(const AlsaCardDescriptor &card)
+{
+    PrewarmedMixerMap::iterator it = mPrewarmedMixers.find(&card);
+
+    if (it == mPrewarmedMixers.end()) {
+
+        return;
+    }
+    it->second.worker.join();
+
+    const CachedMixer &mixer = it->second.mixer;
+
+    // A mixer of an outdated generation is closed on the first access, as cached ones
+    if ((mixer.handle != NULL) && !mMixers.insert(std::make_pair(&card, mixer)).second) {
+
+        mixer_close(mixer.handle);
+    }
+    mPrewarmedMixers.erase(it);
+}
@@ -33,6 +33,7 @@
 #include "AlsaSubsystem.hpp"
 #include <string>
 #include <map>
+#include <thread>
 #include <tinyalsa/asoundlib.h>
 
 class TinyAlsaSubsystem : public AlsaSubsystem
@@ -41,15 +42,65 @@ public:
     TinyAlsaSubsystem(const std::string &name, core::log::Logger& logger);
     ~TinyAlsaSubsystem();
 
+    /**
+     * Start opening the mixer of a card in the background
+     * Opening a mixer costs an ioctl per control: cards are opened in parallel while the
+     * structure is being loaded, instead of on their first access. If no thread can be
+     * started, the mixer is opened on the first access as before.
+     *
+     * @param[in] card the card descriptor
+     * @param[in] context contains the context mappings of the object, unused
+     */
+    virtual void prepareCard(const AlsaCardDescriptor &card, const CMappingContext &context);
+
     /**
      * Return a handle to the card's mixer.
+     * The cached handle of a card rebound on hotplug is closed, and the mixer opened again.
+     * The first access to a card waits for its mixer to be opened in the background, if needed.
+     *
+     * @param[in] card the card descriptor
+     * @param[out] cardNumber index of the card the mixer is opened on
      */
-    struct mixer *getMixerHandle(int32_t cardNumber);
+    struct mixer *getMixerHandle(const AlsaCardDescriptor &card, int32_t &cardNumber);
 
 private:
-    typedef std::map<int32_t, struct mixer *> MixerMap;
+    /** Mixer handle, along with the card binding it was opened for */
+    struct CachedMixer
+    {
+        struct mixer *handle;
+        int32_t cardNumber;
+        uint32_t generation;
+    };
+    typedef std::map<const AlsaCardDescriptor *, CachedMixer> MixerMap;
+
+    /** Mixer being opened in the background, until the first access to its card */
+    struct PrewarmedMixer
+    {
+        /** Opens the mixer, filling the handle below */
+        std::thread worker;
+        CachedMixer mixer;
+    };
+    typedef std::map<const AlsaCardDescriptor *, PrewarmedMixer> PrewarmedMixerMap;
+
+    /**
+     * Open a mixer, from a background thread
+     *
+     * @param[in,out] mixer the card binding to open the mixer for, receiving its handle
+     */
+    static void openMixer(CachedMixer *mixer);
+
+    /**
+     * Move the mixer opened in the background for a card to the cache, if any
+     * It waits for the mixer to be opened, if needed.
+     *
+     * @param[in] card the card descriptor
+     */
+    void adoptPrewarmedMixer(const AlsaCardDescriptor &card);
+
     /**
      * Cache to each card's mixer handle.
      */
     MixerMap mMixers;
+    /** Mixers opened in the background, not cached yet */
+    PrewarmedMixerMap mPrewarmedMixers;
 };
@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "TinyAmixerBackend.hpp"
+#include "TinyAlsaSubsystem.hpp"
+#include "TinyAmixerRampWriter.hpp"
+#include <tinyalsa/asoundlib.h>
+#include <sound/asound.h>
+#include <string>
+#include <string.h>
+#include <vector>
+#include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#ifdef __USE_GCOV__
+extern "C" void __gcov_flush();
+#endif // __USE_GCOV__
+
+TinyAmixerBackend::TinyAmixerBackend()
+    : _cardIndex(-1), _mixer(NULL), _mixerControl(NULL), _ioctlCount(0)
+{
+#ifdef __USE_GCOV__
+    atexit(__gcov_flush);
+#endif // __USE_GCOV__
+}
+
+bool TinyAmixerBackend::open(const CSubsystem *subsystem, const AlsaCardDescriptor &card,
+                             std::string &error)
+{
+    // getMixerHandle is non-const; we need to forcefully remove the constness
+    // then, we need to cast the generic subsystem into a TinyAlsaSubsystem.
+    _mixer = static_cast<TinyAlsaSubsystem *>(
+        const_cast<CSubsystem *>(subsystem))->getMixerHandle(card, _cardIndex);
+
+    if (_mixer == NULL) {
+
+        error = "failed to open mixer";
+        return false;
+    }
+    _ioctlCount = 0;
+
+    return true;
+}
+
+bool TinyAmixerBackend::resolve(const std::string &controlName, std::string &error)
+{
+    if (isdigit(controlName[0])) {
+
+        uint32_t controlNumber;
+
+        if (!AlsaDescriptorPool::parseControlNumber(controlName, controlNumber)) {
+
+            error = "invalid control number";
+            return false;
+        }
+        _mixerControl = mixer_get_ctl(_mixer, controlNumber);
+    } else {
+
+        _mixerControl = mixer_get_ctl_by_name(_mixer, controlName.c_str());
+    }
+
+    if (_mixerControl == NULL) {
+
+        error = "no such control";
+        return false;
+    }
+    return true;
+}
+
+AmixerElementType TinyAmixerBackend::getType() const
+{
+    switch (mixer_ctl_get_type(_mixerControl)) {
+    case MIXER_CTL_TYPE_BOOL:
+        return AmixerElementBoolean;
+    case MIXER_CTL_TYPE_INT:
+        return AmixerElementInteger;
+    case MIXER_CTL_TYPE_INT64:
+        return AmixerElementInteger64;
+    case MIXER_CTL_TYPE_ENUM:
+        return AmixerElementEnumerated;
+    case MIXER_CTL_TYPE_BYTE:
+        return AmixerElementBytes;
+    default:
+        return AmixerElementUnknown;
+    }
+}
+
+uint32_t TinyAmixerBackend::getCount() const
+{
+    return mixer_ctl_get_num_values(_mixerControl);
+}
+
+bool TinyAmixerBackend::isArrayAccessible() const
+{
+    enum mixer_ctl_type type = mixer_ctl_get_type(_mixerControl);
+
+    return (type == MIXER_CTL_TYPE_BOOL) || (type == MIXER_CTL_TYPE_INT);
+}
+
+bool TinyAmixerBackend::read(long *values, uint32_t count, std::string &error)
+{
+    int err;
+
+    // Integer arrays are handled by tinyalsa as arrays of long
+    if (isArrayAccessible()) {
+
+        _ioctlCount++;
+
+        if ((err = mixer_ctl_get_array(_mixerControl, values, count)) < 0) {
+
+            error = strerror(-err);
+            return false;
+        }
+        return true;
+    }
+
+    // Each value is read from the whole control
+    for (uint32_t index = 0; index < count; index++) {
+
+        _ioctlCount++;
+
+        if ((err = mixer_ctl_get_value(_mixerControl, index)) < 0) {
+
+            error = strerror(-err);
+            return false;
+        }
+        values[index] = err;
+    }
+    return true;
+}
+
+bool TinyAmixerBackend::write(const long *values, uint32_t count, std::string &error)
+{
+    int err;
+
+    if (isArrayAccessible()) {
+
+        _ioctlCount++;
+
+        if ((err = mixer_ctl_set_array(_mixerControl, values, count)) < 0) {
+
+            error = strerror(-err);
+            return false;
+        }
+        return true;
+    }
+
+    // Each value is written by reading and writing back the whole control
+    for (uint32_t index = 0; index < count; index++) {
+
+        _ioctlCount += 2;
+
+        if ((err = mixer_ctl_set_value(_mixerControl, index, values[index])) < 0) {
+
+            error = strerror(-err);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TinyAmixerBackend::readBytes(void *data, size_t size, std::string &error)
+{
+    int err;
+
+    _ioctlCount++;
+
+    if ((err = mixer_ctl_get_array(_mixerControl, data, size)) < 0) {
+
+        error = strerror(-err);
+        return false;
+    }
+    return true;
+}
+
+bool TinyAmixerBackend::writeBytes(const void *data, size_t size, std::string &error)
+{
+    int err;
+
+    _ioctlCount++;
+
+    if ((err = mixer_ctl_set_array(_mixerControl, data, size)) < 0) {
+
+        error = strerror(-err);
+        return false;
+    }
+    return true;
+}
+
+uint32_t TinyAmixerBackend::getItemCount() const
+{
+    return mixer_ctl_get_num_enums(_mixerControl);
+}
+
+bool TinyAmixerBackend::getItemName(uint32_t item, std::string &name, std::string &)
+{
+    const char *itemName = mixer_ctl_get_enum_string(_mixerControl, item);
+
+    name = (itemName != NULL) ? itemName : "";
+
+    return true;
+}
+
+bool TinyAmixerBackend::readDbTlv(unsigned int *tlv, size_t &tlvSize,
+                                  long &min, long &max, std::string &error)
+{
+    char devicePath[32];
+    snprintf(devicePath, sizeof(devicePath), "/dev/snd/controlC%d", _cardIndex);
+
+    int fd = ::open(devicePath, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+
+        error = "failed to open " + std::string(devicePath) + ": " + strerror(errno);
+        return false;
+    }
+
+    struct snd_ctl_elem_info info;
+    memset(&info, 0, sizeof(info));
+    info.id.iface = SNDRV_CTL_ELEM_IFACE_MIXER;
+    strncpy(reinterpret_cast<char *>(info.id.name), mixer_ctl_get_name(_mixerControl),
+            sizeof(info.id.name) - 1);
+
+    // TLV read buffer: numid and length words followed by the TLV itself
+    std::vector<unsigned int> tlvBuffer(2 + tlvSize / sizeof(unsigned int));
+    struct snd_ctl_tlv *tlvRead = reinterpret_cast<struct snd_ctl_tlv *>(tlvBuffer.data());
+
+    bool success = false;
+    _ioctlCount++;
+    if (ioctl(fd, SNDRV_CTL_IOCTL_ELEM_INFO, &info) < 0) {
+
+        error = strerror(errno);
+
+    } else if (!(info.access & SNDRV_CTL_ELEM_ACCESS_TLV_READ)) {
+
+        error = "no TLV available";
+
+    } else {
+
+        tlvRead->numid = info.id.numid;
+        tlvRead->length = tlvSize;
+        _ioctlCount++;
+
+        if (ioctl(fd, SNDRV_CTL_IOCTL_TLV_READ, tlvRead) < 0) {
+
+            error = strerror(errno);
+
+        } else {
+
+            tlvSize = tlvRead->length;
+            memcpy(tlv, tlvRead->tlv, tlvSize);
+            min = info.value.integer.min;
+            max = info.value.integer.max;
+            success = true;
+        }
+    }
+    ::close(fd);
+
+    return success;
+}
+
+AmixerRampWriter *TinyAmixerBackend::createRampWriter()
+{
+    return new TinyAmixerRampWriter(_mixerControl);
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "AmixerBackendControl.hpp"
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+class CSubsystem;
+struct mixer;
+struct mixer_ctl;
+
+/**
+ * Backend policy of AmixerBackendControl over tinyalsa.
+ * The mixers are opened once per card and cached by the subsystem, until the card is rebound.
+ */
+class TinyAmixerBackend
+{
+public:
+    TinyAmixerBackend();
+
+    bool open(const CSubsystem *subsystem, const AlsaCardDescriptor &card, std::string &error);
+    bool resolve(const std::string &controlName, std::string &error);
+    /** The control lives as long as the cached mixer, until the card is rebound */
+    void close() {}
+    int32_t getCardIndex() const { return _cardIndex; }
+
+    AmixerElementType getType() const;
+    uint32_t getCount() const;
+    /** @return the handle on the control, which lives as long as the cached mixer */
+    uintptr_t getKey() const { return reinterpret_cast<uintptr_t>(_mixerControl); }
+
+    /** Integer and boolean controls are accessed in a single array access */
+    bool read(long *values, uint32_t count, std::string &error);
+    bool write(const long *values, uint32_t count, std::string &error);
+
+    bool readBytes(void *data, size_t size, std::string &error);
+    bool writeBytes(const void *data, size_t size, std::string &error);
+
+    uint32_t getItemCount() const;
+    bool getItemName(uint32_t item, std::string &name, std::string &error);
+
+    /**
+     * tinyalsa does not give access to TLVs: they are read from the control device.
+     */
+    bool readDbTlv(unsigned int *tlv, size_t &tlvSize, long &min, long &max, std::string &error);
+
+    AmixerRampWriter *createRampWriter();
+
+    /**
+     * Element accesses issued through tinyalsa, as counted from its implementation: the names
+     * and item names are read once, when the mixer is opened.
+     */
+    uint32_t getIoctlCount() const { return _ioctlCount; }
+
+private:
+    /** @return true if the control values are accessed as an array of long */
+    bool isArrayAccessible() const;
+
+    int32_t _cardIndex;
+    struct mixer *_mixer;
+    struct mixer_ctl *_mixerControl;
+    /** Number of ioctls of the current access */
+    uint32_t _ioctlCount;
+};
@@ -29,77 +29,13 @@
  */
 #pragma once
 
-#include "AmixerControl.hpp"
-#include <string>
+#include "AmixerBackendControl.hpp"
+#include "TinyAmixerBackend.hpp"
 
 /**
- * Base class for alsa mixer controls through tiny alsa.
- * Handles the operations that are common to all mixers.
+ * Alsa mixer control accessed through tinyalsa.
+ *
+ * The template parameter is the value codec of the mapping type, AmixerControl for plain values.
  */
-class TinyAmixerControl : public AmixerControl
-{
-public:
-    /**
-     * TinyAmixerControl Class constructor
-     *
-     * @param[in] mappingValue instantiation mapping value
-     * @param[in] instanceConfigurableElement pointer to configurable element instance
-     * @param[in] context contains the context mappings
-     */
-    TinyAmixerControl(const std::string &mappingValue,
-                      CInstanceConfigurableElement *instanceConfigurableElement,
-                      const CMappingContext &context,
-                      core::log::Logger& logger);
-
-    /**
-     * TinyAMixerControl Class constructor
-     *
-     * @param[in] mappingValue instantiation mapping value
-     * @param[in] instanceConfigurableElement pointer to configurable element instance
-     * @param[in] context contains the context mappings
-     * @param[in] scalarSize used to force scalarSize value
-     */
-    TinyAmixerControl(const std::string &mappingValue,
-                      CInstanceConfigurableElement *instanceConfigurableElement,
-                      const CMappingContext &context,
-                      core::log::Logger& logger,
-                      uint32_t scalarSize);
-
-protected:
-    virtual bool accessHW(bool receive, std::string &error);
-
-    /**
-     * Get the number of values in a mixer control
-     *
-     * @param[in] mixerControl handle on the mixer control
-     *
-     * @return the number of values
-     */
-    virtual uint32_t getNumValues(struct mixer_ctl *mixerControl);
-
-    /**
-     * Reads the value(s) of an alsa mixer
-     *
-     * @param[in] mixerControl handle on the mixer control
-     * @param[in] elementCount number of elements to write
-     * @param[out] error string containing error description
-     *
-     * @return true if no error
-     */
-    virtual bool readControl(struct mixer_ctl *mixerControl,
-                             size_t elementCount,
-                             std::string &error) = 0;
-
-    /**
-     * Writes the value(s) of an alsa mixer
-     *
-     * @param[in] mixerControl handle on the mixer control
-     * @param[in] elementCount number of elements to write
-     * @param[out] error string containing error description
-     *
-     * @return true if no error
-     */
-    virtual bool writeControl(struct mixer_ctl *mixerControl,
-                              size_t elementCount,
-                              std::string &error) = 0;
-};
+template <class Codec = AmixerControl>
+using TinyAmixerControl = AmixerBackendControl<TinyAmixerBackend, Codec>;
@@ -0,0 +1,470 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "BenchmarkPlatform.hpp"
+#include "CallCounters.hpp"
+#include <alsa/asoundlib.h>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** Exit status of a check skipped for lack of the card, as expected by ctest */
+static const int gSkippedStatus = 77;
+
+/** Integer control written by the check */
+struct CheckedControl
+{
+    std::string name;
+    int count;
+    int min;
+    int max;
+};
+
+/** Backend under check */
+struct CheckedBackend
+{
+    const char *name;
+    const char *pluginPath;
+};
+
+static const CheckedBackend gBackends[] = {
+    {"alsa", LEGACY_PLUGIN_PATH},
+#ifdef TINYALSA_PLUGIN_PATH
+    {"tinyalsa", TINYALSA_PLUGIN_PATH},
+#endif
+};
+
+/** Volumes of the snd-dummy card */
+static const CheckedControl gDefaultControls[] = {
+    {"Master Volume", 2, -50, 100}, {"Synth Volume", 2, -50, 100}, {"Line Volume", 2, -50, 100},
+    {"Mic Volume", 2, -50, 100},    {"CD Volume", 2, -50, 100},
+};
+
+/** snd-dummy volumes mapped as Volume and DbVolume, their dB range being -45dB to 0dB */
+static const char *const gVolumeControl = "Mic Volume";
+static const char *const gDbVolumeControl = "CD Volume";
+
+/** Controls added to the card for the mapping types snd-dummy has no control for */
+static const char *const gEnumControl = "Allocation Check Enum";
+static const char *const gEnumItems[] = {"Off", "On"};
+static const char *const gBytesControl = "Allocation Check Bytes";
+static const unsigned int gBytesCount = 16;
+
+/** Parameter written by the check, alternating between two values */
+struct CheckedParameter
+{
+    /** Mapping type, the allocations being reported per type */
+    std::string mappingType;
+    /** XML declaration of the parameter */
+    std::string declaration;
+    /** Parameter, or child of a parameter block, written */
+    std::string parameterName;
+    std::string values[2];
+};
+
+static void usage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [-c card] [-n iterations] [-s] [control...]\n"
+              << "  control: name:count:min:max, defaults to the snd-dummy volumes\n"
+              << "  -s: skip the check, with status " << gSkippedStatus
+              << ", if the card is not loaded\n";
+}
+
+static bool parseControl(const std::string &description, CheckedControl &control)
+{
+    std::istringstream stream(description);
+    std::string field;
+    std::vector<std::string> fields;
+
+    while (std::getline(stream, field, ':')) {
+
+        fields.push_back(field);
+    }
+    if (fields.size() != 4) {
+
+        return false;
+    }
+    control.name = fields[0];
+    control.count = atoi(fields[1].c_str());
+    control.min = atoi(fields[2].c_str());
+    control.max = atoi(fields[3].c_str());
+
+    return control.count > 0 && control.min <= control.max;
+}
+
+/** @return the values of all the elements of a control, separated by spaces */
+static std::string repeatValue(int value, int count)
+{
+    std::ostringstream values;
+
+    for (int element = 0; element < count; element++) {
+
+        values << (element ? " " : "") << value;
+    }
+    return values.str();
+}
+
+/**
+ * Build the parameters of each mapping type under check
+ *
+ * @param[in] controls the integer controls mapped as Control
+ *
+ * @return the parameters
+ */
+static std::vector<CheckedParameter> createParameters(const std::vector<CheckedControl> &controls)
+{
+    std::vector<CheckedParameter> parameters;
+
+    for (size_t index = 0; index < controls.size(); index++) {
+
+        const CheckedControl &control = controls[index];
+        std::ostringstream declaration;
+        CheckedParameter parameter;
+
+        parameter.mappingType = "Control";
+        parameter.parameterName = BenchmarkPlatform::toParameterName(control.name);
+        declaration << "<IntegerParameter Name=\"" << parameter.parameterName
+                    << "\" Size=\"32\" Signed=\"true\" Min=\"" << control.min << "\" Max=\""
+                    << control.max << "\" ArrayLength=\"" << control.count
+                    << "\" Mapping=\"Control:'" << control.name << "'\"/>";
+        parameter.declaration = declaration.str();
+        parameter.values[0] = repeatValue(control.min, control.count);
+        parameter.values[1] = repeatValue(control.max, control.count);
+        parameters.push_back(parameter);
+    }
+
+    // Levels of Volume, gains in hundredths of dB of DbVolume
+    const char *const volumeTypes[] = {"Volume", "DbVolume"};
+    const char *const volumeControls[] = {gVolumeControl, gDbVolumeControl};
+    const char *const volumeRanges[][2] = {{"-50", "100"}, {"-4500", "0"}};
+    const char *const volumeValues[][2] = {{"-50", "100"}, {"-3000", "0"}};
+
+    for (size_t index = 0; index < 2; index++) {
+
+        CheckedParameter parameter;
+        std::string name = std::string(volumeTypes[index]) + "_" +
+                           BenchmarkPlatform::toParameterName(volumeControls[index]);
+
+        parameter.mappingType = volumeTypes[index];
+        parameter.parameterName = name + "/level";
+        parameter.declaration = "<ParameterBlock Name=\"" + name + "\" Mapping=\"" +
+                                volumeTypes[index] + ":'" + volumeControls[index] + "'\">"
+                                "<BooleanParameter Name=\"muted\"/>"
+                                "<IntegerParameter Name=\"level\" Size=\"32\" Signed=\"true\" "
+                                "Min=\"" + volumeRanges[index][0] + "\" Max=\"" +
+                                volumeRanges[index][1] + "\"/></ParameterBlock>";
+        parameter.values[0] = volumeValues[index][0];
+        parameter.values[1] = volumeValues[index][1];
+        parameters.push_back(parameter);
+    }
+
+    CheckedParameter enumParameter;
+    enumParameter.mappingType = "EnumControl";
+    enumParameter.parameterName = BenchmarkPlatform::toParameterName(gEnumControl);
+    enumParameter.declaration = "<StringParameter Name=\"" + enumParameter.parameterName +
+                                "\" MaxLength=\"16\" Mapping=\"EnumControl:'" + gEnumControl +
+                                "'\"/>";
+    enumParameter.values[0] = gEnumItems[0];
+    enumParameter.values[1] = gEnumItems[1];
+    parameters.push_back(enumParameter);
+
+    std::ostringstream bytesDeclaration;
+    CheckedParameter bytesParameter;
+    bytesParameter.mappingType = "ByteControl";
+    bytesParameter.parameterName = BenchmarkPlatform::toParameterName(gBytesControl);
+    bytesDeclaration << "<IntegerParameter Name=\"" << bytesParameter.parameterName
+                     << "\" Size=\"8\" ArrayLength=\"" << gBytesCount
+                     << "\" Mapping=\"ByteControl:'" << gBytesControl << "'\"/>";
+    bytesParameter.declaration = bytesDeclaration.str();
+    bytesParameter.values[0] = repeatValue(0, gBytesCount);
+    bytesParameter.values[1] = repeatValue(255, gBytesCount);
+    parameters.push_back(bytesParameter);
+
+    return parameters;
+}
+
+/**
+ * Add the enumerated and bytes controls to the card, as user controls
+ * Controls left over by a previous run are replaced.
+ *
+ * @param[in] card name of the card
+ * @param[out] error string containing error description
+ *
+ * @return true if no error
+ */
+static bool addUserControls(const std::string &card, std::string &error)
+{
+    snd_ctl_t *handle;
+    snd_ctl_elem_id_t *enumId;
+    snd_ctl_elem_id_t *bytesId;
+    int ret;
+
+    if ((ret = snd_ctl_open(&handle, ("hw:" + card).c_str(), 0)) < 0) {
+
+        error = "Unable to open card " + card + ": " + snd_strerror(ret);
+        return false;
+    }
+    snd_ctl_elem_id_alloca(&enumId);
+    snd_ctl_elem_id_set_interface(enumId, SND_CTL_ELEM_IFACE_MIXER);
+    snd_ctl_elem_id_set_name(enumId, gEnumControl);
+
+    snd_ctl_elem_id_alloca(&bytesId);
+    snd_ctl_elem_id_set_interface(bytesId, SND_CTL_ELEM_IFACE_MIXER);
+    snd_ctl_elem_id_set_name(bytesId, gBytesControl);
+
+    snd_ctl_elem_remove(handle, enumId);
+    snd_ctl_elem_remove(handle, bytesId);
+
+    if (((ret = snd_ctl_elem_add_enumerated(handle, enumId, 1,
+                                            sizeof(gEnumItems) / sizeof(gEnumItems[0]),
+                                            gEnumItems)) < 0) ||
+        ((ret = snd_ctl_elem_add_bytes(handle, bytesId, gBytesCount)) < 0)) {
+
+        error = "Unable to add the user controls to card " + card + ": " + snd_strerror(ret);
+    }
+    snd_ctl_close(handle);
+
+    return ret >= 0;
+}
+
+/**
+ * Remove the controls added to the card
+ *
+ * @param[in] card name of the card
+ */
+static void removeUserControls(const std::string &card)
+{
+    snd_ctl_t *handle;
+    snd_ctl_elem_id_t *id;
+
+    if (snd_ctl_open(&handle, ("hw:" + card).c_str(), 0) < 0) {
+
+        return;
+    }
+    snd_ctl_elem_id_alloca(&id);
+    snd_ctl_elem_id_set_interface(id, SND_CTL_ELEM_IFACE_MIXER);
+
+    snd_ctl_elem_id_set_name(id, gEnumControl);
+    snd_ctl_elem_remove(handle, id);
+
+    snd_ctl_elem_id_set_name(id, gBytesControl);
+    snd_ctl_elem_remove(handle, id);
+
+    snd_ctl_close(handle);
+}
+
+/** Hardware accesses of a mapping type, and their allocations */
+struct AccessCounts
+{
+    unsigned long writes;
+    unsigned long accesses;
+    unsigned long allocations;
+};
+
+typedef std::map<std::string, AccessCounts> AccessCountMap;
+
+/**
+ * Write each parameter in turn, counting the allocations within the hardware accesses
+ *
+ * @param[in] platform the started platform
+ * @param[in] parameters the parameters
+ * @param[in] writeCount the number of writes
+ * @param[out] counts the counts of each mapping type, if not NULL
+ * @param[out] error string containing error description
+ *
+ * @return true if no error
+ */
+static bool runWrites(BenchmarkPlatform &platform, const std::vector<CheckedParameter> &parameters,
+                      unsigned long writeCount, AccessCountMap *counts, std::string &error)
+{
+    for (unsigned long write = 0; write < writeCount; write++) {
+
+        // Alternate between the values of each parameter, so that every write changes the control
+        const CheckedParameter &parameter = parameters[write % parameters.size()];
+        const std::string &value = parameter.values[(write / parameters.size()) % 2];
+        unsigned long accessCount = CallCounters::getAccessCount();
+        unsigned long allocationCount = CallCounters::getAccessAllocationCount();
+
+        if (!platform.setParameter(parameter.parameterName, value, error)) {
+
+            error = parameter.parameterName + ": " + error;
+            return false;
+        }
+        if (counts != NULL) {
+
+            AccessCounts &typeCounts = (*counts)[parameter.mappingType];
+
+            typeCounts.writes++;
+            typeCounts.accesses += CallCounters::getAccessCount() - accessCount;
+            typeCounts.allocations += CallCounters::getAccessAllocationCount() - allocationCount;
+        }
+    }
+    return true;
+}
+
+/**
+ * Run the writes through one backend
+ *
+ * @param[in] backend the backend to check
+ * @param[in] card name of the card
+ * @param[in] parameters the parameters
+ * @param[in] writeCount the number of writes
+ * @param[out] counts the counts of each mapping type
+ *
+ * @return true if no error
+ */
+static bool runBackend(const CheckedBackend &backend, const std::string &card,
+                       const std::vector<CheckedParameter> &parameters, unsigned long writeCount,
+                       AccessCountMap &counts)
+{
+    BenchmarkPlatform platform(backend.pluginPath, card);
+    std::string error;
+
+    for (size_t index = 0; index < parameters.size(); index++) {
+
+        platform.addParameter(parameters[index].declaration);
+    }
+
+    // Warm up with both values of each parameter: first accesses resolve the controls, build
+    // the translation tables and size the buffers, the check covers the steady state only
+    if (!platform.start(error) ||
+        !runWrites(platform, parameters, 2 * parameters.size(), NULL, error) ||
+        !runWrites(platform, parameters, writeCount, &counts, error)) {
+
+        std::cerr << backend.name << ": " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string card = "Dummy";
+    unsigned long iterations = 1000;
+    bool isSkipAllowed = false;
+    int option;
+
+    while ((option = getopt(argc, argv, "c:n:sh")) != -1) {
+
+        switch (option) {
+        case 'c':
+            card = optarg;
+            break;
+        case 'n':
+            iterations = strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            isSkipAllowed = true;
+            break;
+        default:
+            usage(argv[0]);
+            return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    // A missing card fails the check, unless skipping is explicitly allowed
+    if (access(("/proc/asound/" + card).c_str(), F_OK) != 0) {
+
+        if (isSkipAllowed) {
+
+            std::cout << "Card " << card << " not found, skipping the check" << std::endl;
+            return gSkippedStatus;
+        }
+        std::cerr << "Card " << card << " not found: load it (modprobe snd-dummy for the "
+                  << "default card), or pass -s to skip the check" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<CheckedControl> controls;
+    for (int index = optind; index < argc; index++) {
+
+        CheckedControl control;
+        if (!parseControl(argv[index], control)) {
+
+            std::cerr << "Invalid control description: " << argv[index] << std::endl;
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        controls.push_back(control);
+    }
+    if (controls.empty()) {
+
+        controls.assign(gDefaultControls,
+                        gDefaultControls + sizeof(gDefaultControls) / sizeof(gDefaultControls[0]));
+    }
+    std::string error;
+
+    if (!addUserControls(card, error)) {
+
+        std::cerr << error << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::vector<CheckedParameter> parameters = createParameters(controls);
+
+    std::cout << std::left << std::setw(10) << "backend" << std::setw(14) << "mapping"
+              << std::right << std::setw(10) << "writes" << std::setw(12) << "accesses"
+              << std::setw(14) << "allocations" << std::endl;
+
+    int status = EXIT_SUCCESS;
+    for (size_t index = 0; index < sizeof(gBackends) / sizeof(gBackends[0]); index++) {
+
+        AccessCountMap counts;
+
+        if (!runBackend(gBackends[index], card, parameters, iterations, counts)) {
+
+            status = EXIT_FAILURE;
+            continue;
+        }
+        AccessCountMap::const_iterator it;
+
+        for (it = counts.begin(); it != counts.end(); ++it) {
+
+            const AccessCounts &typeCounts = it->second;
+
+            std::cout << std::left << std::setw(10) << gBackends[index].name << std::setw(14)
+                      << it->first << std::right << std::setw(10) << typeCounts.writes
+                      << std::setw(12) << typeCounts.accesses << std::setw(14)
+                      << typeCounts.allocations << std::endl;
+
+            // Each write is one access: fewer means the plugin did not bind to the hooks
+            if ((typeCounts.accesses < typeCounts.writes) || (typeCounts.allocations > 0)) {
+
+                status = EXIT_FAILURE;
+            }
+        }
+    }
+    removeUserControls(card);
+
+    return status;
+}
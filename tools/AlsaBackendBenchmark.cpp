@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "BenchmarkPlatform.hpp"
+#include "LatencyStatistics.hpp"
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** Integer control exercised by the benchmark */
+struct BenchControl
+{
+    std::string name;
+    int count;
+    int min;
+    int max;
+};
+
+/** Backend under benchmark */
+struct BenchBackend
+{
+    const char *name;
+    const char *pluginPath;
+};
+
+static const BenchBackend gBackends[] = {
+    {"alsa", LEGACY_PLUGIN_PATH},
+#ifdef TINYALSA_PLUGIN_PATH
+    {"tinyalsa", TINYALSA_PLUGIN_PATH},
+#endif
+};
+
+/** Volumes of the snd-dummy card */
+static const BenchControl gDefaultControls[] = {
+    {"Master Volume", 2, -50, 100}, {"Synth Volume", 2, -50, 100}, {"Line Volume", 2, -50, 100},
+    {"Mic Volume", 2, -50, 100},    {"CD Volume", 2, -50, 100},
+};
+
+static void usage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [-c card] [-n iterations] [-s seed] [control...]\n"
+              << "  control: name:count:min:max, defaults to the snd-dummy volumes\n";
+}
+
+static bool parseControl(const std::string &description, BenchControl &control)
+{
+    std::istringstream stream(description);
+    std::string field;
+    std::vector<std::string> fields;
+
+    while (std::getline(stream, field, ':')) {
+
+        fields.push_back(field);
+    }
+    if (fields.size() != 4) {
+
+        return false;
+    }
+    control.name = fields[0];
+    control.count = atoi(fields[1].c_str());
+    control.min = atoi(fields[2].c_str());
+    control.max = atoi(fields[3].c_str());
+
+    return control.count > 0 && control.min <= control.max;
+}
+
+/**
+ * Run the workload through one backend
+ *
+ * @param[in] backend the backend to benchmark
+ * @param[in] card name of the card
+ * @param[in] controls the controls to write
+ * @param[in] workload the control index and values of each write
+ * @param[out] statistics write latencies, in microseconds
+ *
+ * @return true if no error
+ */
+static bool runBackend(const BenchBackend &backend, const std::string &card,
+                       const std::vector<BenchControl> &controls,
+                       const std::vector<std::pair<size_t, std::string> > &workload,
+                       LatencyStatistics &statistics)
+{
+    BenchmarkPlatform platform(backend.pluginPath, card);
+    std::string error;
+
+    for (size_t index = 0; index < controls.size(); index++) {
+
+        const BenchControl &control = controls[index];
+        std::ostringstream declaration;
+
+        declaration << "<IntegerParameter Name=\""
+                    << BenchmarkPlatform::toParameterName(control.name)
+                    << "\" Size=\"32\" Signed=\"true\" Min=\"" << control.min << "\" Max=\""
+                    << control.max << "\" ArrayLength=\"" << control.count
+                    << "\" Mapping=\"Control:'" << control.name << "'\"/>";
+        platform.addParameter(declaration.str());
+    }
+    if (!platform.start(error)) {
+
+        std::cerr << backend.name << ": " << error << std::endl;
+        return false;
+    }
+
+    // Warm up: first accesses resolve the controls
+    for (size_t index = 0; index < controls.size(); index++) {
+
+        std::string value;
+        if (!platform.getParameter(BenchmarkPlatform::toParameterName(controls[index].name),
+                                   value, error)) {
+
+            std::cerr << backend.name << ": " << error << std::endl;
+            return false;
+        }
+    }
+
+    for (size_t index = 0; index < workload.size(); index++) {
+
+        const std::string name =
+            BenchmarkPlatform::toParameterName(controls[workload[index].first].name);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        bool success = platform.setParameter(name, workload[index].second, error);
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        if (!success) {
+
+            std::cerr << backend.name << ": " << error << std::endl;
+            return false;
+        }
+        statistics.add(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string card = "Dummy";
+    unsigned long iterations = 10000;
+    unsigned long seed = 0;
+    int option;
+
+    while ((option = getopt(argc, argv, "c:n:s:h")) != -1) {
+
+        switch (option) {
+        case 'c':
+            card = optarg;
+            break;
+        case 'n':
+            iterations = strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            seed = strtoul(optarg, NULL, 0);
+            break;
+        default:
+            usage(argv[0]);
+            return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    std::vector<BenchControl> controls;
+    for (int index = optind; index < argc; index++) {
+
+        BenchControl control;
+        if (!parseControl(argv[index], control)) {
+
+            std::cerr << "Invalid control description: " << argv[index] << std::endl;
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        controls.push_back(control);
+    }
+    if (controls.empty()) {
+
+        controls.assign(gDefaultControls,
+                        gDefaultControls + sizeof(gDefaultControls) / sizeof(gDefaultControls[0]));
+    }
+
+    // Same seeded workload for every backend
+    std::mt19937 generator(seed);
+    std::vector<std::pair<size_t, std::string> > workload;
+    for (unsigned long iteration = 0; iteration < iterations; iteration++) {
+
+        size_t controlIndex = generator() % controls.size();
+        const BenchControl &control = controls[controlIndex];
+        std::uniform_int_distribution<int> distribution(control.min, control.max);
+        std::ostringstream value;
+
+        for (int element = 0; element < control.count; element++) {
+
+            value << (element ? " " : "") << distribution(generator);
+        }
+        workload.push_back(std::make_pair(controlIndex, value.str()));
+    }
+
+    std::cout << std::left << std::setw(10) << "backend" << std::right << std::setw(10)
+              << "writes" << std::setw(12) << "mean(us)" << std::setw(12) << "p50(us)"
+              << std::setw(12) << "p99(us)" << std::setw(12) << "max(us)" << std::endl;
+
+    int status = EXIT_SUCCESS;
+    for (size_t index = 0; index < sizeof(gBackends) / sizeof(gBackends[0]); index++) {
+
+        LatencyStatistics statistics;
+
+        if (!runBackend(gBackends[index], card, controls, workload, statistics)) {
+
+            status = EXIT_FAILURE;
+            continue;
+        }
+        std::cout << std::fixed << std::setprecision(2) << std::left << std::setw(10)
+                  << gBackends[index].name << std::right << std::setw(10)
+                  << statistics.getCount() << std::setw(12) << statistics.getMean()
+                  << std::setw(12) << statistics.getPercentile(50) << std::setw(12)
+                  << statistics.getPercentile(99) << std::setw(12)
+                  << statistics.getPercentile(100) << std::endl;
+    }
+    return status;
+}
@@ -0,0 +1,521 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ */
+#include "BenchmarkPlatform.hpp"
+#include "CallCounters.hpp"
+#include "LatencyStatistics.hpp"
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** Backend under load */
+struct LoadBackend
+{
+    const char *name;
+    const char *pluginPath;
+};
+
+static const LoadBackend gBackends[] = {
+    {"alsa", LEGACY_PLUGIN_PATH},
+#ifdef TINYALSA_PLUGIN_PATH
+    {"tinyalsa", TINYALSA_PLUGIN_PATH},
+#endif
+};
+
+/** Mixers of the snd-dummy card, each having a stereo volume and a stereo capture switch */
+static const char *const gDefaultMixers[] = {"Master", "Synth", "Line", "Mic", "CD"};
+static const size_t gDefaultMixerCount = sizeof(gDefaultMixers) / sizeof(gDefaultMixers[0]);
+
+/** Bounds of the snd-dummy volumes */
+static const int gVolumeMin = -50;
+static const int gVolumeMax = 100;
+
+/** Load description */
+struct LoadOptions
+{
+    std::string card;
+    unsigned long switches;
+    unsigned long seed;
+    /** Switches per second, 0 to switch as fast as possible */
+    unsigned long rate;
+    /** Number of Control and Volume parameters, and ByteControl if a bytes control is given */
+    unsigned long elements;
+    unsigned long portConfigs;
+    unsigned long domains;
+    unsigned long criteria;
+    /** Configurations of each domain, which is also the number of states of each criterion */
+    unsigned long configurations;
+    /** Bytes control mapped by the ByteControl parameters, none by default */
+    std::string bytesControl;
+    unsigned long bytesSize;
+};
+
+/** Parameter of the synthetic structure */
+struct LoadParameter
+{
+    enum Kind
+    {
+        Control,
+        Bytes,
+        Volume,
+        Port
+    };
+
+    Kind kind;
+    std::string name;
+    std::string declaration;
+};
+
+static void usage(const char *program)
+{
+    std::cerr << "Usage: " << program
+              << " [-c card] [-n switches] [-s seed] [-r rate] [-e elements] [-p port configs]\n"
+              << "       [-d domains] [-m criteria] [-k configurations] [-b name:size]\n"
+              << "  -r: switches per second, 0 (default) to switch as fast as possible\n"
+              << "  -e: Control and Volume parameters, mapped on the snd-dummy mixers\n"
+              << "  -p: PortConfig parameters, mapped on device 0 of the card\n"
+              << "  -b: bytes control of the card mapped by -e ByteControl parameters\n";
+}
+
+static bool parseBytesControl(const std::string &description, LoadOptions &options)
+{
+    size_t separator = description.rfind(':');
+
+    if (separator == std::string::npos || separator == 0) {
+
+        return false;
+    }
+    options.bytesControl = description.substr(0, separator);
+    options.bytesSize = strtoul(description.c_str() + separator + 1, NULL, 0);
+
+    return options.bytesSize > 0;
+}
+
+/**
+ * Build the synthetic structure
+ *
+ * @param[in] options the load description
+ *
+ * @return the parameters, in declaration order
+ */
+static std::vector<LoadParameter> createParameters(const LoadOptions &options)
+{
+    std::vector<LoadParameter> parameters;
+
+    for (unsigned long index = 0; index < options.elements; index++) {
+
+        const std::string mixer = gDefaultMixers[index % gDefaultMixerCount];
+        std::ostringstream suffix;
+        suffix << index;
+
+        LoadParameter control = {LoadParameter::Control, "control" + suffix.str(), ""};
+        control.declaration = "<IntegerParameter Name=\"" + control.name +
+                              "\" Size=\"32\" Min=\"0\" Max=\"1\" ArrayLength=\"2\" "
+                              "Mapping=\"Control:'" + mixer + " Capture Switch'\"/>";
+        parameters.push_back(control);
+
+        std::ostringstream volumeDeclaration;
+        LoadParameter volume = {LoadParameter::Volume, "volume" + suffix.str(), ""};
+        volumeDeclaration << "<ParameterBlock Name=\"" << volume.name << "\" Mapping=\"Volume:'"
+                          << mixer << " Volume'\">"
+                          << "<BooleanParameter Name=\"muted\"/>"
+                          << "<IntegerParameter Name=\"level\" Size=\"32\" Signed=\"true\" Min=\""
+                          << gVolumeMin << "\" Max=\"" << gVolumeMax << "\"/>"
+                          << "</ParameterBlock>";
+        volume.declaration = volumeDeclaration.str();
+        parameters.push_back(volume);
+
+        if (!options.bytesControl.empty()) {
+
+            std::ostringstream bytesDeclaration;
+            LoadParameter bytes = {LoadParameter::Bytes, "bytes" + suffix.str(), ""};
+            bytesDeclaration << "<IntegerParameter Name=\"" << bytes.name
+                             << "\" Size=\"8\" ArrayLength=\"" << options.bytesSize
+                             << "\" Mapping=\"ByteControl:'" << options.bytesControl << "'\"/>";
+            bytes.declaration = bytesDeclaration.str();
+            parameters.push_back(bytes);
+        }
+    }
+    for (unsigned long index = 0; index < options.portConfigs; index++) {
+
+        std::ostringstream suffix;
+        suffix << index;
+
+        LoadParameter port = {LoadParameter::Port, "port" + suffix.str(), ""};
+        port.declaration = "<ParameterBlock Name=\"" + port.name +
+                           "\" Mapping=\"Device:0,PortConfig\">"
+                           "<BooleanParameter Name=\"playback\"/>"
+                           "<BooleanParameter Name=\"capture\"/>"
+                           "<IntegerParameter Name=\"format\" Size=\"8\"/>"
+                           "<IntegerParameter Name=\"channels\" Size=\"8\"/>"
+                           "<IntegerParameter Name=\"rate\" Size=\"16\"/>"
+                           "</ParameterBlock>";
+        parameters.push_back(port);
+    }
+    return parameters;
+}
+
+/**
+ * Draw a random setting of a parameter
+ *
+ * @param[in] parameter the parameter
+ * @param[in] options the load description
+ * @param[in,out] generator the random generator
+ *
+ * @return the XML setting of the parameter, within its configurable element
+ */
+static std::string createSetting(const LoadParameter &parameter, const LoadOptions &options,
+                                 std::mt19937 &generator)
+{
+    std::uniform_int_distribution<int> flag(0, 1);
+    std::ostringstream setting;
+
+    switch (parameter.kind) {
+    case LoadParameter::Control:
+        setting << "<IntegerParameter Name=\"" << parameter.name << "\">" << flag(generator)
+                << " " << flag(generator) << "</IntegerParameter>";
+        break;
+    case LoadParameter::Bytes: {
+        std::uniform_int_distribution<int> byte(0, 255);
+        setting << "<IntegerParameter Name=\"" << parameter.name << "\">";
+        for (unsigned long index = 0; index < options.bytesSize; index++) {
+
+            setting << (index ? " " : "") << byte(generator);
+        }
+        setting << "</IntegerParameter>";
+        break;
+    }
+    case LoadParameter::Volume: {
+        std::uniform_int_distribution<int> level(gVolumeMin, gVolumeMax);
+        setting << "<ParameterBlock Name=\"" << parameter.name << "\">"
+                << "<BooleanParameter Name=\"muted\">" << flag(generator)
+                << "</BooleanParameter>"
+                << "<IntegerParameter Name=\"level\">" << level(generator)
+                << "</IntegerParameter></ParameterBlock>";
+        break;
+    }
+    case LoadParameter::Port:
+        // Streams are toggled, the format being kept to stereo S16_LE at 48kHz
+        setting << "<ParameterBlock Name=\"" << parameter.name << "\">"
+                << "<BooleanParameter Name=\"playback\">" << flag(generator)
+                << "</BooleanParameter>"
+                << "<BooleanParameter Name=\"capture\">" << flag(generator)
+                << "</BooleanParameter>"
+                << "<IntegerParameter Name=\"format\">2</IntegerParameter>"
+                << "<IntegerParameter Name=\"channels\">2</IntegerParameter>"
+                << "<IntegerParameter Name=\"rate\">48000</IntegerParameter>"
+                << "</ParameterBlock>";
+        break;
+    }
+    return setting.str();
+}
+
+/** @return the name of a criterion */
+static std::string getCriterionName(unsigned long criterion)
+{
+    std::ostringstream name;
+    name << "criterion" << criterion;
+    return name.str();
+}
+
+/** @return the name of a criterion state, also naming the configuration it selects */
+static std::string getStateName(unsigned long state)
+{
+    std::ostringstream name;
+    name << "state" << state;
+    return name.str();
+}
+
+/**
+ * Declare the domains: parameter i belongs to domain i % domains, whose configurations are
+ * selected by the states of criterion domain % criteria
+ *
+ * @param[in,out] platform the platform, not started yet
+ * @param[in] parameters the parameters of the structure
+ * @param[in] options the load description
+ * @param[in,out] generator the random generator drawing the settings
+ */
+static void createDomains(BenchmarkPlatform &platform,
+                          const std::vector<LoadParameter> &parameters,
+                          const LoadOptions &options, std::mt19937 &generator)
+{
+    std::vector<std::string> states;
+    for (unsigned long state = 0; state < options.configurations; state++) {
+
+        states.push_back(getStateName(state));
+    }
+    for (unsigned long criterion = 0; criterion < options.criteria; criterion++) {
+
+        platform.addCriterion(getCriterionName(criterion), states);
+    }
+
+    for (unsigned long domain = 0; domain < options.domains; domain++) {
+
+        std::ostringstream xml;
+        std::vector<size_t> members;
+
+        for (size_t index = domain; index < parameters.size(); index += options.domains) {
+
+            members.push_back(index);
+        }
+        xml << "<ConfigurableDomain Name=\"domain" << domain
+            << "\" SequenceAware=\"false\">\n<Configurations>\n";
+        for (unsigned long state = 0; state < options.configurations; state++) {
+
+            xml << "<Configuration Name=\"" << getStateName(state) << "\">"
+                << "<CompoundRule Type=\"All\"><SelectionCriterionRule SelectionCriterion=\""
+                << getCriterionName(domain % options.criteria) << "\" MatchesWhen=\"Is\" Value=\""
+                << getStateName(state) << "\"/></CompoundRule></Configuration>\n";
+        }
+        xml << "</Configurations>\n<ConfigurableElements>\n";
+        for (size_t member = 0; member < members.size(); member++) {
+
+            xml << "<ConfigurableElement Path=\""
+                << BenchmarkPlatform::getParameterPath(parameters[members[member]].name)
+                << "\"/>\n";
+        }
+        xml << "</ConfigurableElements>\n<Settings>\n";
+        for (unsigned long state = 0; state < options.configurations; state++) {
+
+            xml << "<Configuration Name=\"" << getStateName(state) << "\">\n";
+            for (size_t member = 0; member < members.size(); member++) {
+
+                const LoadParameter &parameter = parameters[members[member]];
+
+                xml << "<ConfigurableElement Path=\""
+                    << BenchmarkPlatform::getParameterPath(parameter.name) << "\">"
+                    << createSetting(parameter, options, generator) << "</ConfigurableElement>\n";
+            }
+            xml << "</Configuration>\n";
+        }
+        xml << "</Settings>\n</ConfigurableDomain>";
+        platform.addDomain(xml.str());
+    }
+}
+
+/** Measures of a load run */
+struct LoadResult
+{
+    LoadResult() : latencies(), duration(0), ioctlCount(0), allocationCount(0) {}
+
+    /** Apply latencies, in microseconds */
+    LatencyStatistics latencies;
+    /** Duration of the whole run, in seconds */
+    double duration;
+    unsigned long ioctlCount;
+    unsigned long allocationCount;
+};
+
+/**
+ * Run the switches through one backend
+ *
+ * @param[in] backend the backend to load
+ * @param[in] options the load description
+ * @param[in] parameters the parameters of the structure
+ * @param[in] workload the criterion and state of each switch
+ * @param[out] result the measures of the run
+ *
+ * @return true if no error
+ */
+static bool runBackend(const LoadBackend &backend, const LoadOptions &options,
+                       const std::vector<LoadParameter> &parameters,
+                       const std::vector<std::pair<unsigned long, int> > &workload,
+                       LoadResult &result)
+{
+    BenchmarkPlatform platform(backend.pluginPath, options.card);
+    // Same settings for every backend
+    std::mt19937 generator(options.seed);
+    std::string error;
+
+    for (size_t index = 0; index < parameters.size(); index++) {
+
+        platform.addParameter(parameters[index].declaration);
+    }
+    createDomains(platform, parameters, options, generator);
+
+    // Leaving tuning mode applies the initial configurations
+    if (!platform.start(error) || !platform.setTuningMode(false, error)) {
+
+        std::cerr << backend.name << ": " << error << std::endl;
+        return false;
+    }
+
+    // Warm up: select every configuration once, so that all controls are resolved
+    for (unsigned long state = 0; state < options.configurations; state++) {
+
+        for (unsigned long criterion = 0; criterion < options.criteria; criterion++) {
+
+            platform.setCriterionState(getCriterionName(criterion), static_cast<int>(state));
+        }
+        platform.applyConfigurations();
+    }
+
+    const std::chrono::nanoseconds period(options.rate ? 1000000000 / options.rate : 0);
+    unsigned long ioctlStart = CallCounters::getIoctlCount();
+    unsigned long allocationStart = CallCounters::getAllocationCount();
+    std::chrono::steady_clock::time_point runStart = std::chrono::steady_clock::now();
+
+    for (size_t index = 0; index < workload.size(); index++) {
+
+        if (options.rate) {
+
+            std::this_thread::sleep_until(runStart + period * static_cast<long>(index));
+        }
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        platform.setCriterionState(getCriterionName(workload[index].first),
+                                   workload[index].second);
+        platform.applyConfigurations();
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        result.latencies.add(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    result.duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart)
+                          .count();
+    result.ioctlCount = CallCounters::getIoctlCount() - ioctlStart;
+    result.allocationCount = CallCounters::getAllocationCount() - allocationStart;
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    LoadOptions options;
+    options.card = "Dummy";
+    options.switches = 10000;
+    options.seed = 0;
+    options.rate = 0;
+    options.elements = 100;
+    options.portConfigs = 1;
+    options.domains = 16;
+    options.criteria = 4;
+    options.configurations = 4;
+    options.bytesSize = 0;
+    int option;
+
+    while ((option = getopt(argc, argv, "c:n:s:r:e:p:d:m:k:b:h")) != -1) {
+
+        switch (option) {
+        case 'c':
+            options.card = optarg;
+            break;
+        case 'n':
+            options.switches = strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            options.seed = strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            options.rate = strtoul(optarg, NULL, 0);
+            break;
+        case 'e':
+            options.elements = strtoul(optarg, NULL, 0);
+            break;
+        case 'p':
+            options.portConfigs = strtoul(optarg, NULL, 0);
+            break;
+        case 'd':
+            options.domains = strtoul(optarg, NULL, 0);
+            break;
+        case 'm':
+            options.criteria = strtoul(optarg, NULL, 0);
+            break;
+        case 'k':
+            options.configurations = strtoul(optarg, NULL, 0);
+            break;
+        case 'b':
+            if (!parseBytesControl(optarg, options)) {
+
+                std::cerr << "Invalid bytes control description: " << optarg << std::endl;
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            break;
+        default:
+            usage(argv[0]);
+            return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (options.domains == 0 || options.criteria == 0 || options.configurations == 0) {
+
+        std::cerr << "At least one domain, criterion and configuration are needed" << std::endl;
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<LoadParameter> parameters = createParameters(options);
+
+    // Same seeded switches for every backend
+    std::mt19937 generator(options.seed);
+    std::uniform_int_distribution<unsigned long> criterion(0, options.criteria - 1);
+    std::uniform_int_distribution<int> state(0, static_cast<int>(options.configurations) - 1);
+    std::vector<std::pair<unsigned long, int> > workload;
+    for (unsigned long index = 0; index < options.switches; index++) {
+
+        unsigned long switched = criterion(generator);
+        workload.push_back(std::make_pair(switched, state(generator)));
+    }
+
+    std::cout << parameters.size() << " parameters in " << options.domains << " domains of "
+              << options.configurations << " configurations, " << options.criteria
+              << " criteria" << std::endl;
+    std::cout << std::left << std::setw(10) << "backend" << std::right << std::setw(10)
+              << "switches" << std::setw(12) << "p50(us)" << std::setw(12) << "p99(us)"
+              << std::setw(12) << "p99.9(us)" << std::setw(12) << "switch/s" << std::setw(14)
+              << "ioctl/switch" << std::setw(14) << "alloc/switch" << std::endl;
+
+    int status = EXIT_SUCCESS;
+    for (size_t index = 0; index < sizeof(gBackends) / sizeof(gBackends[0]); index++) {
+
+        LoadResult result;
+
+        if (!runBackend(gBackends[index], options, parameters, workload, result)) {
+
+            status = EXIT_FAILURE;
+            continue;
+        }
+        double switchCount = workload.empty() ? 1 : workload.size();
+
+        std::cout << std::fixed << std::setprecision(2) << std::left << std::setw(10)
+                  << gBackends[index].name << std::right << std::setw(10)
+                  << result.latencies.getCount() << std::setw(12)
+                  << result.latencies.getPercentile(50) << std::setw(12)
+                  << result.latencies.getPercentile(99) << std::setw(12)
+                  << result.latencies.getPercentile(99.9) << std::setw(12)
+                  << (result.duration > 0 ? workload.size() / result.duration : 0)
+                  << std::setw(14) << result.ioctlCount / switchCount << std::setw(14)
+                  << result.allocationCount / switchCount << std::endl;
+    }
+    return status;
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "BenchmarkPlatform.hpp"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/**
+ * Get the resident set size of the process
+ *
+ * @return the resident set size in kB, 0 if unknown
+ */
+static long getResidentSetSize()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+
+    while (std::getline(status, line)) {
+
+        if (line.compare(0, 6, "VmRSS:") == 0) {
+
+            return atol(line.c_str() + 6);
+        }
+    }
+    return 0;
+}
+
+/**
+ * Start a platform with mapped elements, in a child process so that runs do not share a heap
+ *
+ * @param[in] pluginPath path of the alsa plugin library
+ * @param[in] card name of the card
+ * @param[in] controlName control all the elements are mapped on
+ * @param[in] count number of channels of the control
+ * @param[in] elementCount number of mapped elements
+ * @param[out] rss resident set size of the child once started, in kB
+ *
+ * @return true if no error
+ */
+static bool measure(const std::string &pluginPath, const std::string &card,
+                    const std::string &controlName, unsigned count, unsigned elementCount,
+                    long &rss)
+{
+    int fds[2];
+
+    if (pipe(fds) < 0) {
+
+        return false;
+    }
+    pid_t pid = fork();
+
+    if (pid < 0) {
+
+        return false;
+    }
+    if (pid == 0) {
+
+        close(fds[0]);
+
+        long childRss = 0;
+        {
+            // Scoped, so that the platform removes its files before the child exits
+            BenchmarkPlatform platform(pluginPath, card);
+            std::string error;
+
+            for (unsigned element = 0; element < elementCount; element++) {
+
+                std::ostringstream declaration;
+
+                declaration << "<IntegerParameter Name=\"element" << element
+                            << "\" Size=\"32\" Signed=\"true\" ArrayLength=\"" << count
+                            << "\" Mapping=\"Control:'" << controlName << "'\"/>";
+                platform.addParameter(declaration.str());
+            }
+            if (platform.start(error)) {
+
+                childRss = getResidentSetSize();
+            } else {
+
+                std::cerr << error << std::endl;
+            }
+        }
+        ssize_t written = write(fds[1], &childRss, sizeof(childRss));
+
+        _exit(written == sizeof(childRss) && childRss != 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    close(fds[1]);
+
+    ssize_t readSize = read(fds[0], &rss, sizeof(rss));
+    int status;
+
+    close(fds[0]);
+    waitpid(pid, &status, 0);
+
+    return (readSize == sizeof(rss)) && WIFEXITED(status) && (WEXITSTATUS(status) == 0);
+}
+
+int main(int argc, char *argv[])
+{
+    std::string card = "Dummy";
+    std::string controlName = "Master Volume";
+    unsigned count = 2;
+    unsigned elementCount = 10000;
+    int option;
+
+    while ((option = getopt(argc, argv, "c:e:k:n:h")) != -1) {
+
+        switch (option) {
+        case 'c':
+            card = optarg;
+            break;
+        case 'e':
+            controlName = optarg;
+            break;
+        case 'k':
+            count = strtoul(optarg, NULL, 0);
+            break;
+        case 'n':
+            elementCount = strtoul(optarg, NULL, 0);
+            break;
+        default:
+            std::cerr << "Usage: " << argv[0]
+                      << " [-c card] [-e control] [-k channels] [-n elements]\n"
+                      << "  Maps n elements on the same control and reports the memory"
+                         " footprint of each\n";
+            return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (elementCount < 2 || count == 0) {
+
+        std::cerr << "At least two elements of one channel are needed" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    static const struct
+    {
+        const char *name;
+        const char *pluginPath;
+    } backends[] = {
+        {"alsa", LEGACY_PLUGIN_PATH},
+#ifdef TINYALSA_PLUGIN_PATH
+        {"tinyalsa", TINYALSA_PLUGIN_PATH},
+#endif
+    };
+
+    int status = EXIT_SUCCESS;
+    for (size_t index = 0; index < sizeof(backends) / sizeof(backends[0]); index++) {
+
+        long baseRss;
+        long rss;
+
+        // The single element run accounts for the libraries and the framework itself
+        if (!measure(backends[index].pluginPath, card, controlName, count, 1, baseRss) ||
+            !measure(backends[index].pluginPath, card, controlName, count, elementCount, rss)) {
+
+            std::cerr << backends[index].name << ": measure failed" << std::endl;
+            status = EXIT_FAILURE;
+            continue;
+        }
+        std::cout << backends[index].name << ": " << elementCount << " elements, "
+                  << rss << " kB resident, "
+                  << (rss - baseRss) * 1024 / (elementCount - 1) << " bytes per element"
+                  << std::endl;
+    }
+    return status;
+}
@@ -0,0 +1,417 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ */
+#include "AlsaTrafficLog.hpp"
+#include "LatencyStatistics.hpp"
+#include <alsa/asoundlib.h>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/** Port configuration, as laid out in the blackboard and recorded */
+struct RecordedPortConfig
+{
+    uint8_t isStreamEnabled[2];
+    uint8_t format;
+    uint8_t channelNumber;
+    uint16_t sampleRate;
+} __attribute__((packed));
+
+/** Latency of the stream configurations, as set by the legacy plugin */
+static const unsigned int gPortLatencyMicroSeconds = 500000;
+
+/** Replays the records on the cards through alsa-lib, the handles being opened once */
+class TrafficReplayer
+{
+public:
+    /**
+     * @param[in] card name of the card to replay every record on, empty to use the recorded one
+     */
+    TrafficReplayer(const std::string &card) : _card(card), _controls(), _ports() {}
+
+    ~TrafficReplayer()
+    {
+        std::map<std::pair<std::string, uint32_t>, Port>::iterator port;
+        for (port = _ports.begin(); port != _ports.end(); ++port) {
+
+            closeStreams(port->second);
+        }
+        std::map<std::string, snd_ctl_t *>::iterator control;
+        for (control = _controls.begin(); control != _controls.end(); ++control) {
+
+            snd_ctl_close(control->second);
+        }
+    }
+
+    /**
+     * Replay a record
+     *
+     * @param[in] record the record
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool replay(const AlsaTrafficReader::Record &record, std::string &error)
+    {
+        const std::string &card = _card.empty() ? record.card : _card;
+
+        if (record.operation == AlsaTrafficPortConfigWrite) {
+
+            return replayPortConfig(card, record, error);
+        }
+        return replayControl(card, record, error);
+    }
+
+private:
+    /** Streams of a device */
+    struct Port
+    {
+        snd_pcm_t *streams[2];
+        RecordedPortConfig config;
+    };
+
+    /** @return the index of a card, a negative alsa error code if not found */
+    static int getCardIndex(const std::string &card)
+    {
+        return snd_card_get_index(card.c_str());
+    }
+
+    bool getControl(const std::string &card, snd_ctl_t *&control, std::string &error)
+    {
+        std::map<std::string, snd_ctl_t *>::const_iterator it = _controls.find(card);
+
+        if (it != _controls.end()) {
+
+            control = it->second;
+            return true;
+        }
+        int cardIndex = getCardIndex(card);
+        char deviceName[16];
+        int ret;
+
+        snprintf(deviceName, sizeof(deviceName), "hw:%d", cardIndex);
+
+        if ((cardIndex < 0) || ((ret = snd_ctl_open(&control, deviceName, 0)) < 0)) {
+
+            error = "Unable to open card " + card + ": " +
+                    snd_strerror(cardIndex < 0 ? cardIndex : ret);
+            return false;
+        }
+        _controls[card] = control;
+
+        return true;
+    }
+
+    bool replayControl(const std::string &card, const AlsaTrafficReader::Record &record,
+                       std::string &error)
+    {
+        snd_ctl_t *control;
+        snd_ctl_elem_id_t *id;
+        snd_ctl_elem_value_t *value;
+        int ret;
+
+        if (!getControl(card, control, error)) {
+
+            return false;
+        }
+        snd_ctl_elem_id_alloca(&id);
+        snd_ctl_elem_value_alloca(&value);
+        snd_ctl_elem_id_set_interface(id, SND_CTL_ELEM_IFACE_MIXER);
+
+        // Controls are mapped by name or numid
+        if (isdigit(static_cast<unsigned char>(record.controlName[0]))) {
+
+            snd_ctl_elem_id_set_numid(id, strtoul(record.controlName.c_str(), NULL, 0));
+        } else {
+
+            snd_ctl_elem_id_set_name(id, record.controlName.c_str());
+        }
+        snd_ctl_elem_value_set_id(value, id);
+
+        if (record.operation == AlsaTrafficControlRead) {
+
+            ret = snd_ctl_elem_read(control, value);
+
+        } else {
+
+            for (size_t index = 0; index < record.values.size(); index++) {
+
+                switch (record.type) {
+                case AmixerElementBoolean:
+                    snd_ctl_elem_value_set_boolean(value, index, record.values[index]);
+                    break;
+                case AmixerElementInteger64:
+                    snd_ctl_elem_value_set_integer64(value, index, record.values[index]);
+                    break;
+                case AmixerElementEnumerated:
+                    snd_ctl_elem_value_set_enumerated(value, index, record.values[index]);
+                    break;
+                default:
+                    snd_ctl_elem_value_set_integer(value, index, record.values[index]);
+                    break;
+                }
+            }
+            if (!record.bytes.empty()) {
+
+                snd_ctl_elem_set_bytes(value, const_cast<uint8_t *>(record.bytes.data()),
+                                       record.bytes.size());
+            }
+            ret = snd_ctl_elem_write(control, value);
+        }
+        if (ret < 0) {
+
+            error = "Unable to access " + record.controlName + ": " + snd_strerror(ret);
+            return false;
+        }
+        return true;
+    }
+
+    void closeStreams(Port &port)
+    {
+        for (size_t direction = 0; direction < 2; direction++) {
+
+            if (port.streams[direction] != NULL) {
+
+                snd_pcm_close(port.streams[direction]);
+                port.streams[direction] = NULL;
+            }
+        }
+    }
+
+    bool replayPortConfig(const std::string &card, const AlsaTrafficReader::Record &record,
+                          std::string &error)
+    {
+        RecordedPortConfig config;
+
+        if (record.bytes.size() != sizeof(config)) {
+
+            error = "Invalid port configuration record";
+            return false;
+        }
+        memcpy(&config, record.bytes.data(), sizeof(config));
+
+        // Ports start closed, with a zeroed configuration
+        std::pair<std::string, uint32_t> key(card, record.device);
+        Port &port = _ports.insert(std::make_pair(key, Port())).first->second;
+
+        // As the plugin: a format change reopens both streams
+        if ((port.config.format != config.format) ||
+            (port.config.channelNumber != config.channelNumber) ||
+            (port.config.sampleRate != config.sampleRate)) {
+
+            closeStreams(port);
+        }
+        port.config = config;
+
+        for (int direction = SND_PCM_STREAM_PLAYBACK; direction <= SND_PCM_STREAM_CAPTURE;
+             direction++) {
+
+            snd_pcm_t *&stream = port.streams[direction];
+
+            if (!config.isStreamEnabled[direction]) {
+
+                if (stream != NULL) {
+
+                    snd_pcm_close(stream);
+                    stream = NULL;
+                }
+                continue;
+            }
+            if (stream != NULL) {
+
+                continue;
+            }
+            char streamName[32];
+            int ret;
+
+            snprintf(streamName, sizeof(streamName), "hw:%d,%u", getCardIndex(card),
+                     record.device);
+
+            if ((ret = snd_pcm_open(&stream, streamName, static_cast<snd_pcm_stream_t>(direction),
+                                    0)) < 0) {
+
+                stream = NULL;
+                error = std::string("Unable to open ") + streamName + ": " + snd_strerror(ret);
+                return false;
+            }
+            if ((ret = snd_pcm_set_params(stream, static_cast<snd_pcm_format_t>(config.format),
+                                          SND_PCM_ACCESS_RW_INTERLEAVED, config.channelNumber,
+                                          config.sampleRate, 0, gPortLatencyMicroSeconds)) < 0) {
+
+                snd_pcm_close(stream);
+                stream = NULL;
+                error = std::string("Unable to configure ") + streamName + ": " +
+                        snd_strerror(ret);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string _card;
+    /** Sound controls, by card name */
+    std::map<std::string, snd_ctl_t *> _controls;
+    /** Streams, by card name and device */
+    std::map<std::pair<std::string, uint32_t>, Port> _ports;
+};
+
+/** Latencies of an operation, recorded and replayed */
+struct OperationStatistics
+{
+    OperationStatistics() : recorded(), replayed(), failureCount(0) {}
+
+    LatencyStatistics recorded;
+    LatencyStatistics replayed;
+    unsigned long failureCount;
+};
+
+static void usage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [-c card] [-m] [-v] log\n"
+              << "  -c: card to replay every record on, defaults to the recorded cards\n"
+              << "  -m: replay at maximum speed instead of the recorded timing\n"
+              << "  -v: report each failed record\n";
+}
+
+int main(int argc, char *argv[])
+{
+    std::string card;
+    bool isMaximumSpeed = false;
+    bool isVerbose = false;
+    int option;
+
+    while ((option = getopt(argc, argv, "c:mvh")) != -1) {
+
+        switch (option) {
+        case 'c':
+            card = optarg;
+            break;
+        case 'm':
+            isMaximumSpeed = true;
+            break;
+        case 'v':
+            isVerbose = true;
+            break;
+        default:
+            usage(argv[0]);
+            return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (optind != argc - 1) {
+
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    AlsaTrafficReader reader;
+    std::string error;
+
+    if (!reader.open(argv[optind], error)) {
+
+        std::cerr << error << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    static const char *const operationNames[] = {"read", "write", "portconfig"};
+    OperationStatistics statistics[AlsaTrafficPortConfigWrite + 1];
+    TrafficReplayer replayer(card);
+    AlsaTrafficReader::Record record;
+    std::chrono::steady_clock::time_point replayStart = std::chrono::steady_clock::now();
+
+    while (reader.next(record, error)) {
+
+        // Failed accesses are replayed as well, but only successful ones are timed
+        if (!isMaximumSpeed) {
+
+            std::this_thread::sleep_until(replayStart +
+                                          std::chrono::nanoseconds(record.timestamp));
+        }
+        std::string replayError;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        bool success = replayer.replay(record, replayError);
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        OperationStatistics &operation = statistics[record.operation];
+
+        if (!success) {
+
+            operation.failureCount++;
+            if (isVerbose) {
+
+                std::cerr << operationNames[record.operation] << " at " << record.timestamp
+                          << "ns: " << replayError << std::endl;
+            }
+            continue;
+        }
+        if (record.isSuccessful) {
+
+            operation.recorded.add(record.duration / 1000.);
+        }
+        operation.replayed.add(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    if (!error.empty()) {
+
+        std::cerr << argv[optind] << ": " << error << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << std::left << std::setw(12) << "operation" << std::right << std::setw(10)
+              << "count" << std::setw(10) << "failed" << std::setw(14) << "rec p50(us)"
+              << std::setw(14) << "p50(us)" << std::setw(12) << "p99(us)" << std::setw(12)
+              << "p99.9(us)" << std::setw(12) << "max(us)" << std::endl;
+
+    int status = EXIT_SUCCESS;
+    for (size_t index = 0; index <= AlsaTrafficPortConfigWrite; index++) {
+
+        OperationStatistics &operation = statistics[index];
+
+        if (operation.failureCount != 0) {
+
+            status = EXIT_FAILURE;
+        }
+        std::cout << std::fixed << std::setprecision(2) << std::left << std::setw(12)
+                  << operationNames[index] << std::right << std::setw(10)
+                  << operation.replayed.getCount() + operation.failureCount << std::setw(10)
+                  << operation.failureCount << std::setw(14)
+                  << operation.recorded.getPercentile(50) << std::setw(14)
+                  << operation.replayed.getPercentile(50) << std::setw(12)
+                  << operation.replayed.getPercentile(99) << std::setw(12)
+                  << operation.replayed.getPercentile(99.9) << std::setw(12)
+                  << operation.replayed.getPercentile(100) << std::endl;
+    }
+    return status;
+}
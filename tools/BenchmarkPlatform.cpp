@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "BenchmarkPlatform.hpp"
+#include <fstream>
+#include <iostream>
+#include <ctype.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static const char gSystemClassName[] = "Bench";
+static const char gSubsystemName[] = "alsa";
+static const char gComponentName[] = "bench";
+
+BenchmarkPlatform::BenchmarkPlatform(const std::string &pluginPath, const std::string &cardName)
+    : _pluginPath(pluginPath), _cardName(cardName), _parameters(), _criterionStates(),
+      _domains(), _criteria(), _directory(), _files(), _logger(), _connector()
+{
+}
+
+BenchmarkPlatform::~BenchmarkPlatform()
+{
+    // Stop the parameter framework before removing its files
+    _connector.reset();
+
+    for (size_t index = 0; index < _files.size(); index++) {
+
+        unlink(_files[index].c_str());
+    }
+    if (!_directory.empty()) {
+
+        rmdir(_directory.c_str());
+    }
+}
+
+void BenchmarkPlatform::Logger::warning(const std::string &log)
+{
+    std::cerr << "parameter-framework: " << log << std::endl;
+}
+
+void BenchmarkPlatform::addParameter(const std::string &xmlDeclaration)
+{
+    _parameters.push_back(xmlDeclaration);
+}
+
+void BenchmarkPlatform::addCriterion(const std::string &name,
+                                     const std::vector<std::string> &states)
+{
+    _criterionStates[name] = states;
+}
+
+void BenchmarkPlatform::addDomain(const std::string &xmlDeclaration)
+{
+    _domains.push_back(xmlDeclaration);
+}
+
+bool BenchmarkPlatform::setCriterionState(const std::string &name, int state)
+{
+    std::map<std::string, ISelectionCriterionInterface *>::const_iterator it =
+        _criteria.find(name);
+
+    if (it == _criteria.end()) {
+
+        return false;
+    }
+    it->second->setCriterionState(state);
+
+    return true;
+}
+
+std::string BenchmarkPlatform::toParameterName(const std::string &controlName)
+{
+    std::string name = controlName;
+
+    for (size_t index = 0; index < name.size(); index++) {
+
+        if (!isalnum(static_cast<unsigned char>(name[index]))) {
+
+            name[index] = '_';
+        }
+    }
+    return name;
+}
+
+bool BenchmarkPlatform::writeFile(const std::string &fileName, const std::string &content)
+{
+    std::string path = _directory + "/" + fileName;
+    std::ofstream file(path.c_str());
+
+    _files.push_back(path);
+    file << content;
+
+    return file.good();
+}
+
+std::string BenchmarkPlatform::getParameterPath(const std::string &name)
+{
+    return std::string("/") + gSystemClassName + "/" + gSubsystemName + "/" + gComponentName +
+           "/" + name;
+}
+
+bool BenchmarkPlatform::start(std::string &error)
+{
+    char directoryTemplate[] = "/tmp/pfw-alsa-bench-XXXXXX";
+
+    if (mkdtemp(directoryTemplate) == NULL) {
+
+        error = "Unable to create the configuration directory";
+        return false;
+    }
+    _directory = directoryTemplate;
+
+    std::string parameters;
+    for (size_t index = 0; index < _parameters.size(); index++) {
+
+        parameters += "            " + _parameters[index] + "\n";
+    }
+    std::string domains;
+    for (size_t index = 0; index < _domains.size(); index++) {
+
+        domains += _domains[index] + "\n";
+    }
+    std::string settingsLocation;
+    if (!_domains.empty()) {
+
+        settingsLocation = "    <SettingsConfiguration>\n"
+                           "        <ConfigurableDomainsFileLocation Path=\"Settings.xml\"/>\n"
+                           "    </SettingsConfiguration>\n";
+    }
+
+    bool success =
+        writeFile("ParameterFrameworkConfiguration.xml",
+                  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                  "<ParameterFrameworkConfiguration SystemClassName=\"" +
+                  std::string(gSystemClassName) + "\" TuningAllowed=\"true\" ServerPort=\"0\">\n"
+                  "    <SubsystemPlugins>\n"
+                  "        <Location Folder=\"\">\n"
+                  "            <Plugin Name=\"" + _pluginPath + "\"/>\n"
+                  "        </Location>\n"
+                  "    </SubsystemPlugins>\n"
+                  "    <StructureDescriptionFileLocation Path=\"Structure.xml\"/>\n" +
+                  settingsLocation +
+                  "</ParameterFrameworkConfiguration>\n") &&
+        writeFile("Structure.xml",
+                  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                  "<SystemClass Name=\"" + std::string(gSystemClassName) + "\">\n"
+                  "    <SubsystemInclude Path=\"Subsystem.xml\"/>\n"
+                  "</SystemClass>\n") &&
+        writeFile("Subsystem.xml",
+                  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                  "<Subsystem Name=\"" + std::string(gSubsystemName) +
+                  "\" Type=\"ALSA\" Endianness=\"Little\">\n"
+                  "    <ComponentLibrary>\n"
+                  "        <ComponentType Name=\"BenchComponent\">\n" +
+                  parameters +
+                  "        </ComponentType>\n"
+                  "    </ComponentLibrary>\n"
+                  "    <InstanceDefinition>\n"
+                  "        <Component Name=\"" + std::string(gComponentName) +
+                  "\" Type=\"BenchComponent\" Mapping=\"Card:" + _cardName + "\"/>\n"
+                  "    </InstanceDefinition>\n"
+                  "</Subsystem>\n") &&
+        (_domains.empty() ||
+         writeFile("Settings.xml",
+                   "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                   "<ConfigurableDomains SystemClassName=\"" + std::string(gSystemClassName) +
+                   "\">\n" + domains +
+                   "</ConfigurableDomains>\n"));
+
+    if (!success) {
+
+        error = "Unable to write the configuration files in " + _directory;
+        return false;
+    }
+
+    _connector.reset(
+        new CParameterMgrFullConnector(_directory + "/ParameterFrameworkConfiguration.xml"));
+    _connector->setLogger(&_logger);
+    _connector->setForceNoRemoteInterface(true);
+
+    return createCriteria(error) && _connector->start(error) &&
+           _connector->setTuningMode(true, error);
+}
+
+bool BenchmarkPlatform::createCriteria(std::string &error)
+{
+    std::map<std::string, std::vector<std::string> >::const_iterator it;
+
+    for (it = _criterionStates.begin(); it != _criterionStates.end(); ++it) {
+
+        ISelectionCriterionTypeInterface *type = _connector->createSelectionCriterionType(false);
+
+        for (size_t state = 0; state < it->second.size(); state++) {
+
+            if (!type->addValuePair(static_cast<int>(state), it->second[state], error)) {
+
+                return false;
+            }
+        }
+        _criteria[it->first] = _connector->createSelectionCriterion(it->first, type);
+    }
+    return true;
+}
+
+bool BenchmarkPlatform::setParameter(const std::string &name, const std::string &value,
+                                     std::string &error)
+{
+    std::string parameterValue = value;
+
+    return _connector->accessParameterValue(getParameterPath(name), parameterValue, true, error);
+}
+
+bool BenchmarkPlatform::getParameter(const std::string &name, std::string &value,
+                                     std::string &error)
+{
+    return _connector->accessParameterValue(getParameterPath(name), value, false, error);
+}
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <ParameterMgrFullConnector.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+
+/**
+ * Parameter framework instance running a generated structure against an alsa plugin.
+ *
+ * All the parameters are declared in a single component mapped on one card. The configuration
+ * and structure files are written in a temporary directory, removed on destruction. Tuning mode
+ * is enabled on start, so that every parameter write goes through the plugin at once.
+ *
+ * Selection criteria and configurable domains can be declared as well, to drive the plugin
+ * through configuration switches once tuning mode is disabled.
+ */
+class BenchmarkPlatform
+{
+public:
+    /**
+     * BenchmarkPlatform Class constructor
+     *
+     * @param[in] pluginPath path of the alsa plugin library
+     * @param[in] cardName name of the card the component is mapped on
+     */
+    BenchmarkPlatform(const std::string &pluginPath, const std::string &cardName);
+    ~BenchmarkPlatform();
+
+    /**
+     * Declare a parameter of the benchmark component, before start
+     *
+     * @param[in] xmlDeclaration XML element of the parameter, with its mapping
+     */
+    void addParameter(const std::string &xmlDeclaration);
+
+    /**
+     * Declare an exclusive selection criterion, before start
+     *
+     * @param[in] name name of the criterion
+     * @param[in] states names of the criterion states, their values being their indexes
+     */
+    void addCriterion(const std::string &name, const std::vector<std::string> &states);
+
+    /**
+     * Declare a configurable domain, before start
+     *
+     * @param[in] xmlDeclaration XML element of the domain, with its configurations and settings
+     */
+    void addDomain(const std::string &xmlDeclaration);
+
+    /**
+     * Write the structure and start the parameter framework
+     *
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool start(std::string &error);
+
+    /**
+     * Set a parameter of the benchmark component
+     *
+     * @param[in] name name of the parameter
+     * @param[in] value value of the parameter, array elements being separated by spaces
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool setParameter(const std::string &name, const std::string &value, std::string &error);
+
+    /**
+     * Get a parameter of the benchmark component
+     *
+     * @param[in] name name of the parameter
+     * @param[out] value value of the parameter
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool getParameter(const std::string &name, std::string &value, std::string &error);
+
+    /**
+     * Enable or disable the synchronization of parameter writes, enabled on start
+     * When disabled, writes only update the blackboard and do not reach the plugin.
+     *
+     * @param[in] isEnabled true to synchronize each write
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool setAutoSync(bool isEnabled, std::string &error)
+    {
+        return _connector->setAutoSync(isEnabled, error);
+    }
+
+    /**
+     * Enable or disable tuning mode, enabled on start
+     * Configurations are only applied when tuning mode is disabled.
+     *
+     * @param[in] isEnabled true to enable tuning mode
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool setTuningMode(bool isEnabled, std::string &error)
+    {
+        return _connector->setTuningMode(isEnabled, error);
+    }
+
+    /**
+     * Change the state of a criterion, applied by the next configuration application
+     *
+     * @param[in] name name of the criterion
+     * @param[in] state the new state
+     *
+     * @return true if the criterion exists
+     */
+    bool setCriterionState(const std::string &name, int state);
+
+    /** Apply the configurations matching the criterion states */
+    void applyConfigurations() { _connector->applyConfigurations(); }
+
+    /** @return the path of a parameter of the benchmark component */
+    static std::string getParameterPath(const std::string &name);
+
+    /**
+     * Turn a control name into a valid parameter name
+     *
+     * @param[in] controlName name of an alsa control
+     *
+     * @return the parameter name
+     */
+    static std::string toParameterName(const std::string &controlName);
+
+private:
+    BenchmarkPlatform(const BenchmarkPlatform &);
+    BenchmarkPlatform &operator=(const BenchmarkPlatform &);
+
+    /** Logger forwarding parameter framework warnings to stderr */
+    class Logger : public CParameterMgrPlatformConnector::ILogger
+    {
+    public:
+        virtual void info(const std::string &) {}
+        virtual void warning(const std::string &log);
+    };
+
+    /**
+     * Write a file of the temporary directory
+     *
+     * @param[in] fileName name of the file
+     * @param[in] content content of the file
+     *
+     * @return true if no error
+     */
+    bool writeFile(const std::string &fileName, const std::string &content);
+
+    /**
+     * Create the declared criteria, before the parameter framework starts
+     *
+     * @param[out] error string containing error description
+     *
+     * @return true if no error
+     */
+    bool createCriteria(std::string &error);
+
+    std::string _pluginPath;
+    std::string _cardName;
+    std::vector<std::string> _parameters;
+    /** Criterion state names, by criterion name */
+    std::map<std::string, std::vector<std::string> > _criterionStates;
+    std::vector<std::string> _domains;
+    std::map<std::string, ISelectionCriterionInterface *> _criteria;
+    /** Temporary directory holding the configuration files */
+    std::string _directory;
+    std::vector<std::string> _files;
+    Logger _logger;
+    std::unique_ptr<CParameterMgrFullConnector> _connector;
+};
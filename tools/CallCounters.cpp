@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "CallCounters.hpp"
+#include "AlsaAccessHook.hpp"
+#include <atomic>
+#include <stdarg.h>
+#include <stddef.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+}
+
+static std::atomic<unsigned long> gAllocationCount(0);
+static std::atomic<unsigned long> gIoctlCount(0);
+static std::atomic<unsigned long> gAccessCount(0);
+static std::atomic<unsigned long> gAccessAllocationCount(0);
+/** Allocation count at the start of the ongoing access, accesses being serialized */
+static std::atomic<unsigned long> gAccessStartCount(0);
+
+extern "C" void *malloc(size_t size)
+{
+    gAllocationCount++;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    gAllocationCount++;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *pointer, size_t size)
+{
+    gAllocationCount++;
+    return __libc_realloc(pointer, size);
+}
+
+extern "C" int posix_memalign(void **pointer, size_t alignment, size_t size)
+{
+    gAllocationCount++;
+    *pointer = __libc_memalign(alignment, size);
+    return *pointer != NULL ? 0 : ENOMEM;
+}
+
+extern "C" int ioctl(int fd, unsigned long request, ...)
+{
+    va_list arguments;
+
+    va_start(arguments, request);
+    void *argument = va_arg(arguments, void *);
+    va_end(arguments);
+
+    gIoctlCount++;
+
+    // The raw system call sets errno
+    return syscall(SYS_ioctl, fd, request, argument);
+}
+
+extern "C" void alsaAccessStarted()
+{
+    gAccessStartCount = gAllocationCount.load();
+}
+
+extern "C" void alsaAccessEnded()
+{
+    // Allocations of the threads working for the access, as fan-out workers, are included
+    gAccessAllocationCount += gAllocationCount - gAccessStartCount;
+    gAccessCount++;
+}
+
+unsigned long CallCounters::getAllocationCount()
+{
+    return gAllocationCount;
+}
+
+unsigned long CallCounters::getIoctlCount()
+{
+    return gIoctlCount;
+}
+
+unsigned long CallCounters::getAccessCount()
+{
+    return gAccessCount;
+}
+
+unsigned long CallCounters::getAccessAllocationCount()
+{
+    return gAccessAllocationCount;
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+/**
+ * Counters of some calls of the whole process, the plugins loaded by the parameter framework
+ * included.
+ *
+ * The C allocator and ioctl are interposed by the tool executable: the C++ allocator and the
+ * alsa libraries all go through them. The access hooks of the plugins (see AlsaAccessHook.hpp)
+ * are defined as well, to tell the hardware accesses apart. The tools are to be linked with
+ * exported symbols, so that the plugins bind to the interposed functions and to the hooks.
+ */
+class CallCounters
+{
+public:
+    /** @return the number of heap allocations since the process started */
+    static unsigned long getAllocationCount();
+
+    /** @return the number of ioctl calls since the process started */
+    static unsigned long getIoctlCount();
+
+    /** @return the number of hardware accesses of the mixer controls since the process started */
+    static unsigned long getAccessCount();
+
+    /** @return the number of heap allocations made during these hardware accesses */
+    static unsigned long getAccessAllocationCount();
+};
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2011-2015, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <algorithm>
+#include <vector>
+
+/** Collects latency samples and computes their statistics */
+class LatencyStatistics
+{
+public:
+    LatencyStatistics() : _samples(), _isSorted(true) {}
+
+    /**
+     * Add a sample
+     *
+     * @param[in] latency the sample, in any unit
+     */
+    void add(double latency)
+    {
+        _samples.push_back(latency);
+        _isSorted = false;
+    }
+
+    /** @return the number of samples */
+    size_t getCount() const { return _samples.size(); }
+
+    /** @return the mean of the samples, 0 if there are none */
+    double getMean() const
+    {
+        double sum = 0;
+        for (size_t index = 0; index < _samples.size(); index++) {
+
+            sum += _samples[index];
+        }
+        return _samples.empty() ? 0 : sum / _samples.size();
+    }
+
+    /**
+     * Compute a percentile, using the nearest rank method
+     *
+     * @param[in] percent the percentile to compute, between 0 and 100
+     *
+     * @return the percentile, 0 if there are no samples
+     */
+    double getPercentile(double percent)
+    {
+        if (_samples.empty()) {
+
+            return 0;
+        }
+        if (!_isSorted) {
+
+            std::sort(_samples.begin(), _samples.end());
+            _isSorted = true;
+        }
+        size_t rank = static_cast<size_t>(percent / 100 * _samples.size());
+
+        return _samples[std::min(rank, _samples.size() - 1)];
+    }
+
+private:
+    std::vector<double> _samples;
+    bool _isSorted;
+};